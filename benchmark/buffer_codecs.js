@@ -0,0 +1,26 @@
+// Encode and decode a 1 MB buffer through the hex and base64 codecs.
+var size = 1024 * 1024;
+var iterations = 100;
+
+var b = new Buffer(size);
+for (var i = 0; i < size; i++) b[i] = i & 0xff;
+
+['hex', 'base64'].forEach(function(encoding) {
+  var start = Date.now();
+  var s;
+  for (var i = 0; i < iterations; i++) {
+    s = b.toString(encoding);
+  }
+  var encodeTime = Date.now() - start;
+
+  start = Date.now();
+  for (var i = 0; i < iterations; i++) {
+    new Buffer(s, encoding);
+  }
+  var decodeTime = Date.now() - start;
+
+  var mb = size * iterations / (1024 * 1024);
+  console.log('%s encode: %d MB/s, decode: %d MB/s', encoding,
+              Math.round(mb / encodeTime * 1000),
+              Math.round(mb / decodeTime * 1000));
+});
@@ -1,6 +1,16 @@
-SlowBuffer = require('buffer').SlowBuffer;
+// SlowBuffer creation across the pooled size classes and past them.
+var SlowBuffer = require('buffer').SlowBuffer;
+var iterations = 1e6;
 
-for (var i = 0; i < 1e6; i++) {
-  b = new SlowBuffer(10);
-  b[1] = 2
-}
+[10, 100, 1024, 8192, 65536].forEach(function(size) {
+  var start = Date.now();
+  var b;
+  for (var i = 0; i < iterations; i++) {
+    b = new SlowBuffer(size);
+    b[1] = 2;
+  }
+  var elapsed = Date.now() - start;
+
+  console.log('%d bytes: %d ns/buffer', size,
+              Math.round(elapsed * 1e6 / iterations));
+});
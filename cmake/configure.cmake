@@ -2,6 +2,7 @@
 # configure node for building
 #
 include(CheckFunctionExists)
+include(CheckIncludeFiles)
 include(CheckLibraryExists)
 include(CheckSymbolExists)
 
@@ -92,9 +93,17 @@ else()
   add_definitions(-DHAVE_MONOTONIC_CLOCK=0)
 endif()
 
-if(DTRACE)
+if(DTRACE AND ${node_platform} MATCHES linux)
+  # The same probes, as systemtap USDT probes. Only the header is needed.
+  check_include_files(sys/sdt.h HAVE_SYS_SDT_H)
+  if(NOT HAVE_SYS_SDT_H)
+    message(FATAL_ERROR "sys/sdt.h not found")
+  endif()
+  set(HAVE_SYSTEMTAP TRUE)
+  add_definitions(-DHAVE_SYSTEMTAP=1)
+elseif(DTRACE)
   if(NOT ${node_platform} MATCHES sunos)
-    message(FATAL_ERROR "DTrace support only currently available on Solaris")
+    message(FATAL_ERROR "DTrace support only currently available on Solaris and Linux")
   endif()
   find_program(dtrace_bin dtrace)
   if(NOT dtrace_bin)
@@ -103,6 +112,10 @@ if(DTRACE)
   add_definitions(-DHAVE_DTRACE=1)
 endif()
 
+if(TEST_BINDINGS)
+  add_definitions(-DNODE_TEST_BINDINGS=1)
+endif()
+
 add_definitions(
   -DPLATFORM="${node_platform}"
   -DARCH="${node_arch}"
@@ -48,6 +48,7 @@ endif()
 set(node_sources
   src/node_main.cc
   src/node.cc
+  src/node_async_queue.cc
   src/node_buffer.cc
   src/node_javascript.cc
   src/node_extensions.cc
@@ -57,6 +58,7 @@ set(node_sources
   src/node_script.cc
   src/node_os.cc
   src/node_dtrace.cc
+  src/node_profiler.cc
   src/node_string.cc
   src/timer_wrap.cc
   src/handle_wrap.cc
@@ -103,7 +105,9 @@ include_directories(
   ${PROJECT_BINARY_DIR}/src
 )
 
-if(DTRACE)
+# systemtap probes come straight from <sys/sdt.h>; only dtrace(1) needs a
+# generated header and a provider object.
+if(DTRACE AND NOT HAVE_SYSTEMTAP)
   add_custom_command(OUTPUT ${PROJECT_BINARY_DIR}/src/node_provider.h
     COMMAND ${dtrace_bin} -x nolibs -h -o ${PROJECT_BINARY_DIR}/src/node_provider.h -s ${PROJECT_SOURCE_DIR}/src/node_provider.d
     DEPENDS ${PROJECT_SOURCE_DIR}/src/node_provider.d)
@@ -121,7 +125,7 @@ target_link_libraries(node
   ${CMAKE_THREAD_LIBS_INIT}
   ${extra_libs})
 
-if(DTRACE)
+if(DTRACE AND NOT HAVE_SYSTEMTAP)
   # manually gather up the object files for dtrace
   get_property(sourcefiles TARGET node PROPERTY SOURCES)
   foreach(src_file ${sourcefiles})
@@ -142,6 +146,7 @@ install(FILES
   src/node.h
   src/node_object_wrap.h
   src/node_buffer.h
+  src/node_async_queue.h
   src/node_version.h
   ${PROJECT_BINARY_DIR}/src/node_config.h
 
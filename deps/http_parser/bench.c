@@ -0,0 +1,170 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+/* Parser throughput benchmark.
+ *
+ *   make bench && ./bench [iterations]
+ *
+ * Feeds a few realistic messages through http_parser_execute() in one piece
+ * and reports bytes and messages per second for each of them.
+ */
+#include "http_parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#define DEFAULT_ITERATIONS 200000
+
+struct corpus {
+  const char *name;
+  enum http_parser_type type;
+  const char *raw;
+};
+
+static const struct corpus corpora[] =
+{ { "browser GET"
+  , HTTP_REQUEST
+  , "GET /wp-content/uploads/2010/03/hello-kitty-darth-vader-pink.jpg HTTP/1.1\r\n"
+    "Host: www.kittyhell.com\r\n"
+    "User-Agent: Mozilla/5.0 (Macintosh; U; Intel Mac OS X 10.6; ja-JP-mac; "
+      "rv:1.9.2.3) Gecko/20100401 Firefox/3.6.3 Pathtraq/0.9\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "Accept-Language: ja,en-us;q=0.7,en;q=0.3\r\n"
+    "Accept-Encoding: gzip,deflate\r\n"
+    "Accept-Charset: Shift_JIS,utf-8;q=0.7,*;q=0.7\r\n"
+    "Keep-Alive: 115\r\n"
+    "Connection: keep-alive\r\n"
+    "Cookie: wp_ozh_wsa_visits=2; wp_ozh_wsa_visit_lasttime=xxxxxxxxxx; "
+      "__utma=xxxxxxxxx.xxxxxxxxxx.xxxxxxxxxx.xxxxxxxxxx.xxxxxxxxxx.x; "
+      "__utmz=xxxxxxxxx.xxxxxxxxxx.x.x.utmccn=(referral)|utmcsr=reader.livedoor.com"
+      "|utmcct=/reader/|utmcmd=referral\r\n"
+    "\r\n"
+  }
+
+, { "curl GET"
+  , HTTP_REQUEST
+  , "GET /test HTTP/1.1\r\n"
+    "User-Agent: curl/7.18.0 (i486-pc-linux-gnu) libcurl/7.18.0 OpenSSL/0.9.8g "
+      "zlib/1.2.3.3 libidn/1.1\r\n"
+    "Host: 0.0.0.0=5000\r\n"
+    "Accept: */*\r\n"
+    "\r\n"
+  }
+
+, { "long query string"
+  , HTTP_REQUEST
+  , "GET /search?q=node.js+http+parser+throughput&sourceid=chrome&ie=UTF-8"
+      "&oq=node.js+http+parser&aqs=chrome.0.57j0l3.4114&client=ubuntu"
+      "&channel=fs&biw=1366&bih=643&tbm=isch&tbs=isz:l,ic:color&start=40"
+      "#fragment-with-some-length HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "Accept: */*\r\n"
+    "\r\n"
+  }
+
+, { "chunked response"
+  , HTTP_RESPONSE
+  , "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/plain\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "\r\n"
+    "25  \r\n"
+    "This is the data in the first chunk\r\n"
+    "\r\n"
+    "1C\r\n"
+    "and this is the second one\r\n"
+    "\r\n"
+    "0  \r\n"
+    "\r\n"
+  }
+
+, { NULL, HTTP_REQUEST, NULL }
+};
+
+
+static int messages;
+
+static int on_message_complete(http_parser *parser) {
+  (void) parser;
+  messages++;
+  return 0;
+}
+
+static http_parser_settings settings;
+
+
+static double now(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+static void bench(const struct corpus *c, int iterations) {
+  http_parser parser;
+  size_t len = strlen(c->raw);
+  double start, elapsed;
+  int i;
+
+  messages = 0;
+  start = now();
+
+  for (i = 0; i < iterations; i++) {
+    http_parser_init(&parser, c->type);
+    if (http_parser_execute(&parser, &settings, c->raw, len) != len) {
+      fprintf(stderr, "%s: parse error %s\n", c->name,
+              http_errno_name(HTTP_PARSER_ERRNO(&parser)));
+      exit(1);
+    }
+  }
+
+  elapsed = now() - start;
+
+  if (messages != iterations) {
+    fprintf(stderr, "%s: %d messages, expected %d\n", c->name, messages,
+            iterations);
+    exit(1);
+  }
+
+  printf("%-20s %8.2f MB/s %12.0f msg/s\n",
+         c->name,
+         (double) len * iterations / elapsed / (1024 * 1024),
+         iterations / elapsed);
+}
+
+
+int main(int argc, char *argv[]) {
+  int iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+  const struct corpus *c;
+
+  if (iterations <= 0) {
+    fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  settings.on_message_complete = on_message_complete;
+
+  for (c = corpora; c->name; c++) {
+    bench(c, iterations);
+  }
+
+  return 0;
+}
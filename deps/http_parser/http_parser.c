@@ -25,6 +25,11 @@
 #include <assert.h>
 #include <stddef.h>
 
+#if defined(__SSE2__) && defined(__GNUC__)
+# include <emmintrin.h>
+# define HTTP_PARSER_SSE2 1
+#endif
+
 
 #ifndef MIN
 # define MIN(a,b) ((a) < (b) ? (a) : (b))
@@ -56,6 +61,22 @@ do {                                                                 \
 } while (0)
 
 
+/* Fast-forward to `q`, the first byte the current state has to look at,
+ * accounting for the skipped bytes in nread. Leaves p on the byte before
+ * `q` so the p++ of the main loop lands on it.
+ */
+#define SKIP_TO(q)                                                   \
+do {                                                                 \
+  const char *q_ = (q);                                              \
+  nread += q_ - (p + 1);                                             \
+  if (nread > HTTP_MAX_HEADER_SIZE) {                                \
+    SET_ERRNO(HPE_HEADER_OVERFLOW);                                  \
+    goto error;                                                      \
+  }                                                                  \
+  p = q_ - 1;                                                        \
+} while (0)
+
+
 #define MARK(FOR)                                                    \
 do {                                                                 \
   FOR##_mark = p;                                                    \
@@ -327,6 +348,70 @@ enum header_states
 #endif
 
 
+/* Scanners for the states that just consume a run of bytes: header values
+ * (up to CR or LF) and the path, query string and fragment of a URL (up to
+ * the first non-URL character). They return the position of the first byte
+ * that ends the run, or `pe`. The SSE2 versions look at 16 bytes at a time;
+ * SSE2 is part of x86-64 so there is nothing to dispatch on at run time.
+ */
+static const char *
+find_eol (const char *p, const char *pe)
+{
+#if HTTP_PARSER_SSE2
+  const __m128i cr = _mm_set1_epi8(CR);
+  const __m128i lf = _mm_set1_epi8(LF);
+
+  while (pe - p >= 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *) p);
+    int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, cr),
+                                              _mm_cmpeq_epi8(v, lf)));
+    if (mask) return p + __builtin_ctz(mask);
+    p += 16;
+  }
+#endif
+
+  while (p != pe && *p != CR && *p != LF) p++;
+  return p;
+}
+
+
+static const char *
+skip_url_chars (const char *p, const char *pe)
+{
+#if HTTP_PARSER_SSE2
+  /* URL characters are '!' through '~' except '#' and '?'; outside of
+   * strict mode bytes with the high bit set are allowed as well. Compares
+   * are signed, so those bytes show up as negative.
+   */
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i bang = _mm_set1_epi8('!');
+  const __m128i del = _mm_set1_epi8(127);
+  const __m128i hash = _mm_set1_epi8('#');
+  const __m128i question = _mm_set1_epi8('?');
+
+  while (pe - p >= 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *) p);
+    __m128i bad = _mm_cmplt_epi8(v, bang);
+#if !HTTP_PARSER_STRICT
+    bad = _mm_andnot_si128(_mm_cmplt_epi8(v, zero), bad);
+#endif
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(v, del));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(v, hash));
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(v, question));
+
+    int mask = _mm_movemask_epi8(bad);
+    if (mask) return p + __builtin_ctz(mask);
+    p += 16;
+  }
+
+  (void) zero;
+#endif
+
+  while (p != pe && IS_URL_CHAR(*p)) p++;
+  return p;
+}
+
+
 #define start_state (parser->type == HTTP_REQUEST ? s_start_req : s_start_res)
 
 
@@ -844,7 +929,10 @@ size_t http_parser_execute (http_parser *parser,
 
       case s_req_path:
       {
-        if (IS_URL_CHAR(ch)) break;
+        if (IS_URL_CHAR(ch)) {
+          SKIP_TO(skip_url_chars(p + 1, pe));
+          break;
+        }
 
         switch (ch) {
           case ' ':
@@ -914,7 +1002,10 @@ size_t http_parser_execute (http_parser *parser,
 
       case s_req_query_string:
       {
-        if (IS_URL_CHAR(ch)) break;
+        if (IS_URL_CHAR(ch)) {
+          SKIP_TO(skip_url_chars(p + 1, pe));
+          break;
+        }
 
         switch (ch) {
           case '?':
@@ -984,7 +1075,10 @@ size_t http_parser_execute (http_parser *parser,
 
       case s_req_fragment:
       {
-        if (IS_URL_CHAR(ch)) break;
+        if (IS_URL_CHAR(ch)) {
+          SKIP_TO(skip_url_chars(p + 1, pe));
+          break;
+        }
 
         switch (ch) {
           case ' ':
@@ -1401,6 +1495,7 @@ size_t http_parser_execute (http_parser *parser,
 
         switch (header_state) {
           case h_general:
+            SKIP_TO(find_eol(p + 1, pe));
             break;
 
           case h_connection:
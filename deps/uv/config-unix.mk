@@ -38,6 +38,8 @@ OBJS += src/unix/process.o
 OBJS += src/unix/tcp.o
 OBJS += src/unix/pipe.o
 OBJS += src/unix/stream.o
+OBJS += src/unix/uring.o
+OBJS += src/unix/threadpool.o
 
 ifeq (SunOS,$(uname_S))
 EV_CONFIG=config_sunos.h
@@ -250,7 +250,8 @@ struct eio_req
 enum {
   EIO_FLAG_PTR1_FREE = 0x01, /* need to free(ptr1) */
   EIO_FLAG_PTR2_FREE = 0x02, /* need to free(ptr2) */
-  EIO_FLAG_GROUPADD  = 0x04  /* some request was added to the group */
+  EIO_FLAG_GROUPADD  = 0x04, /* some request was added to the group */
+  EIO_FLAG_STARTED   = 0x08  /* libuv: a thread has taken up the request */
 };
 
 /* undocumented/unsupported/private helper */
@@ -360,6 +361,8 @@ void eio_grp_cancel    (eio_req *grp); /* cancels all sub requests but not the g
 void eio_submit (eio_req *req);
 /* cancel a request as soon fast as possible, if possible */
 void eio_cancel (eio_req *req);
+/* libuv: cancel a request that no thread has taken up yet, 0 on success */
+int eio_cancel_queued (eio_req *req);
 
 /*****************************************************************************/
 /* convenience functions */
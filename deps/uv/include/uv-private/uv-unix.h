@@ -50,7 +50,12 @@ typedef int uv_file;
    * definition of ares_timeout(). \
    */ \
   ev_timer timer; \
-  struct ev_loop* ev;
+  struct ev_loop* ev; \
+  /* io_uring for fs requests, see src/unix/uring.c */ \
+  struct uv__uring* uring; \
+  int uring_disabled; \
+  /* uv_queue_work completions, see src/unix/threadpool.c */ \
+  struct uv_mpsc_s* work_done;
 
 #define UV_REQ_BUFSML_SIZE (4)
 
@@ -68,6 +73,15 @@ typedef int uv_file;
 #define UV_CONNECT_PRIVATE_FIELDS \
   ngx_queue_t queue;
 
+#define UV_SPLICE_PRIVATE_FIELDS \
+  ev_io read_watcher; \
+  ev_io write_watcher; \
+  int pipefd[2]; /* splice(2) buffer on linux */ \
+  char* buf; /* read/write buffer elsewhere */ \
+  size_t buf_offset; \
+  size_t pending; \
+  int flags;
+
 #define UV_UDP_SEND_PRIVATE_FIELDS  \
   ngx_queue_t queue;                \
   struct sockaddr_storage addr;     \
@@ -99,7 +113,8 @@ typedef int uv_file;
   ngx_queue_t write_completed_queue; \
   int delayed_error; \
   uv_connection_cb connection_cb; \
-  int accepted_fd;
+  int accepted_fd; \
+  uv_splice_t* splice;
 
 
 /* UV_TCP */
@@ -170,9 +185,13 @@ typedef int uv_file;
 
 #define UV_FS_PRIVATE_FIELDS \
   struct stat statbuf; \
+  uv_fs_cb work_cb; \
   eio_req* eio;
 
 #define UV_WORK_PRIVATE_FIELDS \
-  eio_req* eio;
+  int work_queue; /* index while queued, see src/unix/threadpool.c */ \
+  uv_work_t* work_prev; \
+  uv_work_t* work_next; \
+  struct uv_mpsc_node_s work_done;
 
 #endif /* UV_UNIX_H */
@@ -107,6 +107,9 @@ RB_HEAD(uv_timer_tree_s, uv_timer_s);
 #define UV_SHUTDOWN_PRIVATE_FIELDS        \
   /* empty */
 
+#define UV_SPLICE_PRIVATE_FIELDS          \
+  /* empty */
+
 #define UV_UDP_SEND_PRIVATE_FIELDS        \
   /* empty */
 
@@ -245,6 +248,7 @@ RB_HEAD(uv_timer_tree_s, uv_timer_s);
 #define UV_FS_PRIVATE_FIELDS              \
   int flags;                              \
   int last_error;                         \
+  uv_fs_cb work_cb;                       \
   struct _stati64 stat;                   \
   void* arg0;                             \
   union {                                 \
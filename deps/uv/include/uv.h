@@ -54,6 +54,8 @@ typedef struct uv_prepare_s uv_prepare_t;
 typedef struct uv_check_s uv_check_t;
 typedef struct uv_idle_s uv_idle_t;
 typedef struct uv_async_s uv_async_t;
+typedef struct uv_mpsc_s uv_mpsc_t;
+typedef struct uv_mpsc_node_s uv_mpsc_node_t;
 typedef struct uv_getaddrinfo_s uv_getaddrinfo_t;
 typedef struct uv_process_s uv_process_t;
 typedef struct uv_counters_s uv_counters_t;
@@ -62,6 +64,7 @@ typedef struct uv_req_s uv_req_t;
 typedef struct uv_shutdown_s uv_shutdown_t;
 typedef struct uv_write_s uv_write_t;
 typedef struct uv_connect_s uv_connect_t;
+typedef struct uv_splice_s uv_splice_t;
 typedef struct uv_udp_send_s uv_udp_send_t;
 typedef struct uv_fs_s uv_fs_t;
 typedef struct uv_work_s uv_work_t;
@@ -122,11 +125,14 @@ typedef void (*uv_read_cb)(uv_stream_t* stream, ssize_t nread, uv_buf_t buf);
 typedef void (*uv_write_cb)(uv_write_t* req, int status);
 typedef void (*uv_connect_cb)(uv_connect_t* req, int status);
 typedef void (*uv_shutdown_cb)(uv_shutdown_t* req, int status);
+typedef void (*uv_splice_cb)(uv_splice_t* req, int status);
 typedef void (*uv_connection_cb)(uv_stream_t* server, int status);
 typedef void (*uv_close_cb)(uv_handle_t* handle);
 typedef void (*uv_timer_cb)(uv_timer_t* handle, int status);
 /* TODO: do these really need a status argument? */
 typedef void (*uv_async_cb)(uv_async_t* handle, int status);
+typedef void (*uv_mpsc_cb)(uv_mpsc_t* handle, uv_mpsc_node_t* nodes,
+    int status);
 typedef void (*uv_prepare_cb)(uv_prepare_t* handle, int status);
 typedef void (*uv_check_cb)(uv_check_t* handle, int status);
 typedef void (*uv_idle_cb)(uv_idle_t* handle, int status);
@@ -135,7 +141,7 @@ typedef void (*uv_getaddrinfo_cb)(uv_getaddrinfo_t* handle, int status,
 typedef void (*uv_exit_cb)(uv_process_t*, int exit_status, int term_signal);
 typedef void (*uv_fs_cb)(uv_fs_t* req);
 typedef void (*uv_work_cb)(uv_work_t* req);
-typedef void (*uv_after_work_cb)(uv_work_t* req);
+typedef void (*uv_after_work_cb)(uv_work_t* req, int status);
 
 
 /* Expand this list if necessary. */
@@ -183,7 +189,8 @@ typedef enum {
   UV_EAINONAME,
   UV_EAISERVICE,
   UV_EAISOCKTYPE,
-  UV_ESHUTDOWN
+  UV_ESHUTDOWN,
+  UV_ECANCELED
 } uv_err_code;
 
 typedef enum {
@@ -215,6 +222,7 @@ typedef enum {
   UV_UDP_SEND,
   UV_FS,
   UV_WORK,
+  UV_SPLICE,
   UV_REQ_TYPE_PRIVATE
 } uv_req_type;
 
@@ -391,6 +399,55 @@ uv_stream_t* uv_std_handle(uv_loop_t*, uv_std_type type);
 int uv_write(uv_write_t* req, uv_stream_t* handle, uv_buf_t bufs[], int bufcnt,
     uv_write_cb cb);
 
+/*
+ * Same as uv_write but won't queue a write request if it can't be completed
+ * immediately. Writes as much as the socket takes without blocking and
+ * returns the number of bytes written, which is 0 when the socket is full or
+ * when earlier writes are still queued (or the stream is corked). The caller
+ * queues the rest with uv_write. Returns -1 on error.
+ */
+int uv_try_write(uv_stream_t* handle, uv_buf_t bufs[], int bufcnt);
+
+/*
+ * uv_cork holds back writes on the stream; they are queued but not sent
+ * until uv_uncork, which flushes everything queued in as few writev calls
+ * as possible. On TCP streams the socket is corked as well (TCP_CORK) so
+ * that partial frames are not sent out in between.
+ */
+int uv_cork(uv_stream_t* handle);
+int uv_uncork(uv_stream_t* handle);
+
+/*
+ * uv_splice moves everything read from src to dst inside libuv; the data
+ * never reaches the user. On linux it goes through an intermediate pipe with
+ * splice(2) and is not copied into user space at all. Reading from src stops
+ * while dst can't keep up.
+ *
+ * The callback is made once: with status 0 when src has reached EOF and all
+ * of it was written to dst, with -1 on error or when either stream is closed
+ * while the splice is active. dst is left open, call uv_shutdown on it to
+ * pass the EOF along.
+ *
+ * Don't read from src or write to dst until the callback has been made.
+ * Fails with UV_EBUSY when dst still has writes queued or either stream is
+ * already part of a splice, and with UV_ENOTSUP where splicing isn't
+ * available (windows).
+ */
+int uv_splice(uv_splice_t* req, uv_stream_t* src, uv_stream_t* dst,
+    uv_splice_cb cb);
+
+/* uv_splice_t is a subclass of uv_req_t */
+struct uv_splice_s {
+  UV_REQ_FIELDS
+  uv_loop_t* loop;
+  uv_splice_cb cb;
+  uv_stream_t* src;
+  uv_stream_t* dst;
+  /* read-only: bytes written to dst so far */
+  size_t bytes;
+  UV_SPLICE_PRIVATE_FIELDS
+};
+
 /* uv_write_t is a subclass of uv_req_t */
 struct uv_write_s {
   UV_REQ_FIELDS
@@ -419,6 +476,9 @@ int uv_tcp_bind6(uv_tcp_t* handle, struct sockaddr_in6);
 int uv_tcp_getsockname(uv_tcp_t* handle, struct sockaddr* name, int* namelen);
 int uv_tcp_getpeername(uv_tcp_t* handle, struct sockaddr* name, int* namelen);
 
+/* Enable or disable Nagle's algorithm (TCP_NODELAY). */
+int uv_tcp_nodelay(uv_tcp_t* handle, int enable);
+
 /*
  * uv_tcp_connect, uv_tcp_connect6
  * These functions establish IPv4 and IPv6 TCP connections. Provide an
@@ -690,6 +750,42 @@ int uv_async_init(uv_loop_t*, uv_async_t* async, uv_async_cb async_cb);
 int uv_async_send(uv_async_t* async);
 
 
+/*
+ * uv_mpsc_t is a subclass of uv_async_t.
+ *
+ * A multi-producer, single-consumer queue. Any thread can push nodes with
+ * uv_mpsc_push; the loop thread receives every node pushed since the last
+ * callback in one call to the mpsc's callback, oldest first, as a list linked
+ * through `next`. Pushing is lock-free: a compare-and-swap on the head of an
+ * intrusive stack, plus a uv_async_send when the stack was empty.
+ *
+ * Embed uv_mpsc_node_t in your own structures and recover them in the
+ * callback with container_of or an offsetof cast. Close the mpsc with
+ * uv_close((uv_handle_t*) mpsc, close_cb); nodes still queued at that point
+ * are not delivered, the owner must drain them with uv_mpsc_take.
+ */
+struct uv_mpsc_node_s {
+  uv_mpsc_node_t* next;
+};
+
+struct uv_mpsc_s {
+  uv_async_t async;
+  uv_mpsc_cb mpsc_cb;
+  uv_mpsc_node_t* volatile head;
+};
+
+int uv_mpsc_init(uv_loop_t*, uv_mpsc_t* mpsc, uv_mpsc_cb mpsc_cb);
+
+/* Can be called from any thread. */
+int uv_mpsc_push(uv_mpsc_t* mpsc, uv_mpsc_node_t* node);
+
+/*
+ * Removes and returns everything queued, oldest first, or NULL. Called on the
+ * loop thread; the callback uses this too.
+ */
+uv_mpsc_node_t* uv_mpsc_take(uv_mpsc_t* mpsc);
+
+
 /*
  * uv_timer_t is a subclass of uv_handle_t.
  *
@@ -832,11 +928,62 @@ struct uv_work_s {
   UV_WORK_PRIVATE_FIELDS
 };
 
-/* Queues a work request to execute asynchronously on the thread pool. */
+/*
+ * Queues a work request to execute asynchronously on the thread pool.
+ * after_work_cb gets status -1 and UV_ECANCELED if the request was
+ * cancelled with uv_cancel before a thread got to it, 0 otherwise.
+ */
 int uv_queue_work(uv_loop_t* loop, uv_work_t* req, uv_work_cb work_cb,
     uv_after_work_cb after_work_cb);
 
 
+/*
+ * Withdraws a uv_work_t or an async uv_fs_t request that no thread has
+ * started on yet. The callback is still made, with UV_ECANCELED as the
+ * error. Returns 0 on success, or -1 with UV_EBUSY when the request is
+ * already running or finished, and for fs requests that were handed to the
+ * kernel (io_uring). Other request types can't be cancelled.
+ *
+ * libeio checks for cancellation when a thread takes up an fs request, so a
+ * request that was taken up just before uv_cancel runs to completion and
+ * its callback gets the real result. On Windows this fails with UV_ENOTSUP.
+ */
+int uv_cancel(uv_req_t* req);
+
+
+/*
+ * uv_queue_work requests and uv_fs_* requests go to separate thread pools,
+ * so that CPU-bound work and disk I/O don't wait on each other.
+ *
+ * The work pool has one thread per CPU unless UV_THREADPOOL_SIZE is set in
+ * the environment. Each thread has its own queue; requests are spread over
+ * them round-robin and a thread whose queue is empty takes requests from the
+ * others. The I/O pool is libeio's.
+ */
+typedef enum {
+  UV_THREADPOOL_WORK,
+  UV_THREADPOOL_IO
+} uv_threadpool_type;
+
+typedef struct {
+  int threads;
+  uint64_t queued;    /* waiting for a thread */
+  uint64_t active;    /* running */
+  uint64_t completed; /* work pool only */
+  uint64_t steals;    /* work pool only */
+} uv_threadpool_stats_t;
+
+/*
+ * Sets the number of threads. The work pool can only grow once its threads
+ * have started. Returns 0 on success, -1 if the size is out of range or the
+ * platform does not support it.
+ */
+int uv_threadpool_set_size(uv_threadpool_type type, int threads);
+
+int uv_threadpool_stats(uv_threadpool_type type,
+    uv_threadpool_stats_t* stats);
+
+
 
 
 /*
@@ -971,6 +1118,15 @@ int uv_fs_chown(uv_loop_t* loop, uv_fs_t* req, const char* path, int uid,
 int uv_fs_fchown(uv_loop_t* loop, uv_fs_t* req, uv_file file, int uid,
     int gid, uv_fs_cb cb);
 
+/*
+ * Runs work_cb on the I/O pool, for disk I/O that none of the functions
+ * above cover, and then cb on the loop thread. work_cb leaves its outcome
+ * in req->result: -1 with errno set (GetLastError() on Windows) for an
+ * error, which cb then finds in req->errorno. It doesn't run at all if the
+ * request is cancelled. There is no synchronous form; cb is required.
+ */
+int uv_fs_work(uv_loop_t* loop, uv_fs_t* req, uv_fs_cb work_cb, uv_fs_cb cb);
+
 
 /* Utility */
 
@@ -1057,6 +1213,7 @@ struct uv_loop_s {
 #undef UV_REQ_TYPE_PRIVATE
 #undef UV_REQ_PRIVATE_FIELDS
 #undef UV_STREAM_PRIVATE_FIELDS
+#undef UV_SPLICE_PRIVATE_FIELDS
 #undef UV_TCP_PRIVATE_FIELDS
 #undef UV_PREPARE_PRIVATE_FIELDS
 #undef UV_CHECK_PRIVATE_FIELDS
@@ -65,6 +65,11 @@ static void uv__finish_close(uv_handle_t* handle);
 #endif
 
 
+/* The loops stay on libev. Its epoll backend adds an fd once and only
+ * narrows the interest mask when an unwanted event comes in, so starting and
+ * stopping io watchers rarely costs an epoll_ctl. The watchers are
+ * level-triggered; uv__read relies on that to stop after a short read.
+ */
 void uv_init() {
   default_loop_ptr = &default_loop_struct;
 #if defined(__MAC_OS_X_VERSION_MIN_REQUIRED) && __MAC_OS_X_VERSION_MIN_REQUIRED >= 1060
@@ -96,6 +101,10 @@ void uv_close(uv_handle_t* handle, uv_close_cb close_cb) {
       uv_read_stop(stream);
       ev_io_stop(stream->loop->ev, &stream->write_watcher);
 
+      if (stream->splice) {
+        uv__splice_abort(stream->splice);
+      }
+
       uv__close(stream->fd);
       stream->fd = -1;
 
@@ -170,6 +179,8 @@ uv_loop_t* uv_loop_new() {
 
 void uv_loop_delete(uv_loop_t* loop) {
   uv_ares_destroy(loop, loop->channel);
+  uv__uring_destroy(loop);
+  uv__work_destroy(loop);
   ev_loop_destroy(loop->ev);
   free(loop);
 }
@@ -296,6 +307,34 @@ int64_t uv_now(uv_loop_t* loop) {
 }
 
 
+int uv_cancel(uv_req_t* req) {
+  uv_loop_t* loop;
+  int r;
+
+  switch (req->type) {
+    case UV_FS:
+      loop = ((uv_fs_t*) req)->loop;
+      r = uv__fs_cancel((uv_fs_t*) req);
+      break;
+
+    case UV_WORK:
+      loop = ((uv_work_t*) req)->loop;
+      r = uv__work_cancel((uv_work_t*) req);
+      break;
+
+    default:
+      assert(0 && "request type can't be cancelled");
+      return -1;
+  }
+
+  if (r) {
+    uv_err_new_artificial(loop, UV_EBUSY);
+  }
+
+  return r;
+}
+
+
 void uv__req_init(uv_req_t* req) {
   /* loop->counters.req_init++; */
   req->type = UV_UNKNOWN_REQ;
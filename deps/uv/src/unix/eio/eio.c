@@ -85,8 +85,12 @@
 
 static void eio_destroy (eio_req *req);
 
+/* libuv: finish cancelled requests too. uv_cancel promises a callback, and a
+ * request that was cancelled after a thread had started on it has a result
+ * (an open fd, say) that must not get lost.
+ */
 #ifndef EIO_FINISH
-# define EIO_FINISH(req)  ((req)->finish) && !EIO_CANCELLED (req) ? (req)->finish (req) : 0
+# define EIO_FINISH(req)  ((req)->finish) ? (req)->finish (req) : 0
 #endif
 
 #ifndef EIO_DESTROY
@@ -900,6 +904,27 @@ eio_cancel (eio_req *req)
   etp_cancel (req);
 }
 
+/* libuv: a thread takes a request off the queue and marks it started under
+ * reqlock, so either it sees the cancellation in eio_execute or this fails.
+ */
+int
+eio_cancel_queued (eio_req *req)
+{
+  int r = -1;
+
+  X_LOCK (reqlock);
+
+  if (!(req->flags & EIO_FLAG_STARTED) && !EIO_CANCELLED (req))
+    {
+      req->cancelled = 1;
+      r = 0;
+    }
+
+  X_UNLOCK (reqlock);
+
+  return r;
+}
+
 void
 eio_submit (eio_req *req)
 {
@@ -2046,7 +2071,10 @@ X_THREAD_PROC (etp_proc)
           self->req = req = reqq_shift (&req_queue);
 
           if (req)
-            break;
+            {
+              req->flags |= EIO_FLAG_STARTED;
+              break;
+            }
 
           if (ts.tv_sec == 1) /* no request, but timeout detected, let's quit */
             {
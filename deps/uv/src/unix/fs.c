@@ -61,6 +61,17 @@
   return 0;
 
 
+/* Async requests that the loop's io_uring can take don't go to libeio. */
+#define TRY_URING(type, call) \
+  if (cb) { \
+    uv_fs_req_init(loop, req, type, path, cb); \
+    if ((call) == 0) { \
+      uv_ref(loop); \
+      return 0; \
+    } \
+  }
+
+
 static void uv_fs_req_init(uv_loop_t* loop, uv_fs_t* req, uv_fs_type fs_type,
     const char* path, uv_fs_cb cb) {
   /* Make sure the thread pool is initialized. */
@@ -116,6 +127,10 @@ static int uv__fs_after(eio_req* eio) {
 
   switch (req->fs_type) {
     case UV_FS_READDIR:
+      if (req->result == -1) {
+        req->ptr = NULL;
+        break;
+      }
       /*
        * XXX This is pretty bad.
        * We alloc and copy the large null terminated string list from libeio.
@@ -175,6 +190,7 @@ static int uv__fs_after(eio_req* eio) {
 
 int uv_fs_close(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
   char* path = NULL;
+  TRY_URING(UV_FS_CLOSE, uv__uring_close(loop, req, file))
   WRAP_EIO(UV_FS_CLOSE, eio_close, close, ARGS1(file));
 }
 
@@ -186,6 +202,11 @@ int uv_fs_open(uv_loop_t* loop, uv_fs_t* req, const char* path, int flags,
   if (cb) {
     /* async */
     uv_ref(loop);
+
+    if (uv__uring_open(loop, req, req->path, flags, mode) == 0) {
+      return 0;
+    }
+
     req->eio = eio_open(path, flags, mode, EIO_PRI_DEFAULT, uv__fs_after, req);
     if (!req->eio) {
       uv_err_new(loop, ENOMEM);
@@ -214,6 +235,11 @@ int uv_fs_read(uv_loop_t* loop, uv_fs_t* req, uv_file fd, void* buf,
   if (cb) {
     /* async */
     uv_ref(loop);
+
+    if (uv__uring_rw(loop, req, fd, buf, length, offset) == 0) {
+      return 0;
+    }
+
     req->eio = eio_read(fd, buf, length, offset, EIO_PRI_DEFAULT,
         uv__fs_after, req);
 
@@ -250,6 +276,11 @@ int uv_fs_write(uv_loop_t* loop, uv_fs_t* req, uv_file file, void* buf,
   if (cb) {
     /* async */
     uv_ref(loop);
+
+    if (uv__uring_rw(loop, req, file, buf, length, offset) == 0) {
+      return 0;
+    }
+
     req->eio = eio_write(file, buf, length, offset, EIO_PRI_DEFAULT,
         uv__fs_after, req);
     if (!req->eio) {
@@ -364,6 +395,14 @@ int uv_fs_stat(uv_loop_t* loop, uv_fs_t* req, const char* path, uv_fs_cb cb) {
   if (cb) {
     /* async */
     uv_ref(loop);
+
+    /* The path has to outlive the request, keep the trimmed copy. */
+    if (uv__uring_stat(loop, req, -1, pathdup) == 0) {
+      free(req->path);
+      req->path = pathdup;
+      return 0;
+    }
+
     req->eio = eio_stat(pathdup, EIO_PRI_DEFAULT, uv__fs_after, req);
 
     free(pathdup);
@@ -397,6 +436,11 @@ int uv_fs_fstat(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
   if (cb) {
     /* async */
     uv_ref(loop);
+
+    if (uv__uring_stat(loop, req, file, NULL) == 0) {
+      return 0;
+    }
+
     req->eio = eio_fstat(file, EIO_PRI_DEFAULT, uv__fs_after, req);
 
     if (!req->eio) {
@@ -428,12 +472,14 @@ int uv_fs_rename(uv_loop_t* loop, uv_fs_t* req, const char* path, const char* ne
 
 int uv_fs_fsync(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
   char* path = NULL;
+  TRY_URING(UV_FS_FSYNC, uv__uring_fsync(loop, req, file, 0))
   WRAP_EIO(UV_FS_FSYNC, eio_fsync, fsync, ARGS1(file))
 }
 
 
 int uv_fs_fdatasync(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
   char* path = NULL;
+  TRY_URING(UV_FS_FDATASYNC, uv__uring_fsync(loop, req, file, 1))
   WRAP_EIO(UV_FS_FDATASYNC, eio_fdatasync, fdatasync, ARGS1(file))
 }
 
@@ -523,6 +569,14 @@ int uv_fs_lstat(uv_loop_t* loop, uv_fs_t* req, const char* path, uv_fs_cb cb) {
   if (cb) {
     /* async */
     uv_ref(loop);
+
+    /* The path has to outlive the request, keep the trimmed copy. */
+    if (uv__uring_stat(loop, req, -1, pathdup) == 0) {
+      free(req->path);
+      req->path = pathdup;
+      return 0;
+    }
+
     req->eio = eio_lstat(pathdup, EIO_PRI_DEFAULT, uv__fs_after, req);
 
     free(pathdup);
@@ -636,43 +690,38 @@ int uv_fs_fchown(uv_loop_t* loop, uv_fs_t* req, uv_file file, int uid, int gid,
 }
 
 
-static void uv__work(eio_req* eio) {
-  uv_work_t* req = eio->data;
-  if (req->work_cb) {
-    req->work_cb(req);
-  }
-}
-
+static void uv__fs_work(eio_req* eio) {
+  uv_fs_t* req = eio->data;
 
-static int uv__after_work(eio_req *eio) {
-  uv_work_t* req = eio->data;
-  uv_unref(req->loop);
-  if (req->after_work_cb) {
-    req->after_work_cb(req);
-  }
-  return 0;
+  errno = 0;
+  req->work_cb(req);
+  eio->result = req->result;
 }
 
 
-int uv_queue_work(uv_loop_t* loop, uv_work_t* req, uv_work_cb work_cb,
-    uv_after_work_cb after_work_cb) {
-  void* data = req->data;
+int uv_fs_work(uv_loop_t* loop, uv_fs_t* req, uv_fs_cb work_cb, uv_fs_cb cb) {
+  assert(cb);
 
-  uv_eio_init(loop);
-
-  uv__req_init((uv_req_t*) req);
-  uv_ref(loop);
-  req->loop = loop;
-  req->data = data;
+  uv_fs_req_init(loop, req, UV_FS_CUSTOM, NULL, cb);
   req->work_cb = work_cb;
-  req->after_work_cb = after_work_cb;
-
-  req->eio = eio_custom(uv__work, EIO_PRI_DEFAULT, uv__after_work, req);
 
+  req->eio = eio_custom(uv__fs_work, EIO_PRI_DEFAULT, uv__fs_after, req);
   if (!req->eio) {
     uv_err_new(loop, ENOMEM);
     return -1;
   }
 
+  uv_ref(loop);
   return 0;
 }
+
+
+int uv__fs_cancel(uv_fs_t* req) {
+  /* Finished, synchronous or on the io_uring. */
+  if (req->eio == NULL) {
+    return -1;
+  }
+
+  /* Fails if a thread is already on it or it was cancelled before. */
+  return eio_cancel_queued(req->eio);
+}
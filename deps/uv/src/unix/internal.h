@@ -59,7 +59,9 @@ enum {
   UV_SHUTTING = 0x00000008, /* uv_shutdown() called but not complete. */
   UV_SHUT     = 0x00000010, /* Write side closed. */
   UV_READABLE = 0x00000020, /* The stream is readable */
-  UV_WRITABLE = 0x00000040  /* The stream is writable */
+  UV_WRITABLE = 0x00000040, /* The stream is writable */
+  UV_CORKED   = 0x00000080, /* uv_cork() called, writes are held back. */
+  UV_TCP_NODELAY = 0x00000100 /* Disable Nagle. */
 };
 
 size_t uv__strlcpy(char* dst, const char* src, size_t size);
@@ -81,11 +83,32 @@ void uv_fatal_error(const int errorno, const char* syscall);
 
 /* stream */
 int uv__stream_open(uv_stream_t*, int fd, int flags);
+int uv__tcp_nodelay(uv_tcp_t* handle, int enable);
 void uv__stream_io(EV_P_ ev_io* watcher, int revents);
 void uv__server_io(EV_P_ ev_io* watcher, int revents);
 int uv__accept(int sockfd, struct sockaddr* saddr, socklen_t len);
 int uv__connect(uv_connect_t* req, uv_stream_t* stream, struct sockaddr* addr,
     socklen_t addrlen, uv_connect_cb cb);
+void uv__splice_abort(uv_splice_t* req);
+
+/* io_uring, see uring.c. These return -1 if the request has to go to the
+ * thread pool instead.
+ */
+int uv__uring_open(uv_loop_t* loop, uv_fs_t* req, const char* path, int flags,
+    int mode);
+int uv__uring_close(uv_loop_t* loop, uv_fs_t* req, int fd);
+int uv__uring_rw(uv_loop_t* loop, uv_fs_t* req, int fd, void* buf,
+    size_t length, off_t offset);
+int uv__uring_fsync(uv_loop_t* loop, uv_fs_t* req, int fd, int datasync);
+int uv__uring_stat(uv_loop_t* loop, uv_fs_t* req, int fd, const char* path);
+void uv__uring_destroy(uv_loop_t* loop);
+
+/* uv_queue_work, see threadpool.c */
+void uv__work_destroy(uv_loop_t* loop);
+int uv__work_cancel(uv_work_t* req);
+
+/* fs */
+int uv__fs_cancel(uv_fs_t* req);
 
 /* tcp */
 int uv_tcp_listen(uv_tcp_t* tcp, int backlog, uv_connection_cb cb);
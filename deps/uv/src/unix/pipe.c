@@ -43,6 +43,7 @@ int uv_pipe_init(uv_loop_t* loop, uv_pipe_t* handle) {
   handle->write_watcher.data = handle;
   handle->read_watcher.data = handle;
   handle->accepted_fd = -1;
+  handle->splice = NULL;
   handle->fd = -1;
 
   ngx_queue_init(&handle->write_completed_queue);
@@ -27,9 +27,13 @@
 #include <errno.h>
 #include <sys/wait.h>
 #include <fcntl.h> /* O_CLOEXEC, O_NONBLOCK */
+#include <limits.h> /* PATH_MAX */
 #include <poll.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
 
 #ifdef __APPLE__
 # include <crt_externs.h>
@@ -63,25 +67,163 @@ static void uv__chld(EV_P_ ev_child* watcher, int revents) {
   }
 }
 
+/* fork() has to copy the page tables of the parent, which takes tens of
+ * milliseconds for a parent with a heap of a few GB. vfork() shares the
+ * address space with the child instead and suspends the parent until the
+ * child has called execve() or exited.
+ */
+#ifndef SPAWN_USE_VFORK
+# if defined(__linux__)
+#  define SPAWN_USE_VFORK 1
+# else
+#  define SPAWN_USE_VFORK 0
+# endif
+#endif
+
+/* vfork() only returns once the child has called execve() so there is no
+ * need to wait for it.
+ */
 #ifndef SPAWN_WAIT_EXEC
-# define SPAWN_WAIT_EXEC 1
+# define SPAWN_WAIT_EXEC (!SPAWN_USE_VFORK)
+#endif
+
+
+/* Like perror() but without stdio, whose buffers the parent may share. */
+static void uv__process_child_fail(const char* syscall) {
+  const char* msg = strerror(errno);
+  ssize_t r;
+
+  r = write(STDERR_FILENO, syscall, strlen(syscall));
+  r = write(STDERR_FILENO, ": ", 2);
+  r = write(STDERR_FILENO, msg, strlen(msg));
+  r = write(STDERR_FILENO, "\n", 1);
+  (void) r;
+
+  _exit(127);
+}
+
+
+/* execvp() that searches the PATH in `env` and passes `env` on, or the
+ * parent's environment if `env` is NULL. The child can't point environ at
+ * `env` and call execvp() instead: after vfork() environ is the parent's.
+ * Unlike execvp() this doesn't retry files that fail with ENOEXEC through
+ * /bin/sh. Only returns on error.
+ */
+static void uv__process_child_exec(const char* file, char** args,
+    char** env) {
+  char buf[PATH_MAX];
+  const char* path;
+  const char* p;
+  const char* end;
+  size_t dirlen;
+  size_t filelen;
+  int eacces;
+  int i;
+
+  if (env == NULL) {
+    env = environ;
+  }
+
+  if (strchr(file, '/')) {
+    execve(file, args, env);
+    return;
+  }
+
+  path = NULL;
+  for (i = 0; env && env[i]; i++) {
+    if (strncmp(env[i], "PATH=", 5) == 0) {
+      path = env[i] + 5;
+      break;
+    }
+  }
+
+  /* What glibc uses when there is no PATH. */
+  if (path == NULL) {
+    path = "/bin:/usr/bin";
+  }
+
+  filelen = strlen(file);
+  eacces = 0;
+  errno = ENOENT;
+
+  for (p = path; ; p = end + 1) {
+    end = strchr(p, ':');
+    if (end == NULL) {
+      end = p + strlen(p);
+    }
+
+    dirlen = end - p;
+    if (dirlen + filelen + 2 <= sizeof buf) {
+      /* An empty entry is the current directory. */
+      if (dirlen > 0) {
+        memcpy(buf, p, dirlen);
+        buf[dirlen++] = '/';
+      }
+      memcpy(buf + dirlen, file, filelen + 1);
+
+      execve(buf, args, env);
+
+      if (errno == EACCES) {
+        eacces = 1;
+      } else if (errno != ENOENT && errno != ENOTDIR) {
+        return;
+      }
+    }
+
+    if (*end == '\0') {
+      break;
+    }
+  }
+
+  if (eacces) {
+    errno = EACCES;
+  }
+}
+
+
+#if SPAWN_USE_VFORK
+/* The child runs on the parent's memory, signal handlers included, until it
+ * has exec'd. Signals are blocked around vfork() and the child puts the
+ * handlers back to default before it unblocks them.
+ */
+static void uv__process_child_signals(sigset_t* saved) {
+  struct sigaction sa;
+  int n;
+
+  for (n = 1; n < NSIG; n++) {
+    if (n == SIGKILL || n == SIGSTOP) {
+      continue;
+    }
+
+    if (sigaction(n, NULL, &sa) ||
+        sa.sa_handler == SIG_IGN ||
+        sa.sa_handler == SIG_DFL) {
+      continue;
+    }
+
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = SIG_DFL;
+    sigaction(n, &sa, NULL);
+  }
+
+  pthread_sigmask(SIG_SETMASK, saved, NULL);
+}
 #endif
 
 int uv_spawn(uv_loop_t* loop, uv_process_t* process,
     uv_process_options_t options) {
-  /*
-   * Save environ in the case that we get it clobbered
-   * by the child process.
-   */
-  char** save_our_env = environ;
   int stdin_pipe[2] = { -1, -1 };
   int stdout_pipe[2] = { -1, -1 };
   int stderr_pipe[2] = { -1, -1 };
 #if SPAWN_WAIT_EXEC
   int signal_pipe[2] = { -1, -1 };
   struct pollfd pfd;
-#endif
   int status;
+#endif
+#if SPAWN_USE_VFORK
+  sigset_t all_signals;
+  sigset_t saved_signals;
+#endif
   pid_t pid;
 
   uv__handle_init(loop, (uv_handle_t*)process, UV_PROCESS);
@@ -164,18 +306,32 @@ int uv_spawn(uv_loop_t* loop, uv_process_t* process,
 # endif
 #endif
 
+#if SPAWN_USE_VFORK
+  sigfillset(&all_signals);
+  pthread_sigmask(SIG_SETMASK, &all_signals, &saved_signals);
+
+  pid = vfork();
+
+  if (pid != 0) {
+    pthread_sigmask(SIG_SETMASK, &saved_signals, NULL);
+  }
+#else
   pid = fork();
+#endif
 
   if (pid == -1) {
 #if SPAWN_WAIT_EXEC
     uv__close(signal_pipe[0]);
     uv__close(signal_pipe[1]);
 #endif
-    environ = save_our_env;
     goto error;
   }
 
   if (pid == 0) {
+#if SPAWN_USE_VFORK
+    uv__process_child_signals(&saved_signals);
+#endif
+
     if (stdin_pipe[0] >= 0) {
       uv__close(stdin_pipe[1]);
       dup2(stdin_pipe[0],  STDIN_FILENO);
@@ -192,23 +348,16 @@ int uv_spawn(uv_loop_t* loop, uv_process_t* process,
     }
 
     if (options.cwd && chdir(options.cwd)) {
-      perror("chdir()");
-      _exit(127);
+      uv__process_child_fail("chdir()");
     }
 
-    environ = options.env;
-
-    execvp(options.file, options.args);
-    perror("execvp()");
-    _exit(127);
+    uv__process_child_exec(options.file, options.args, options.env);
+    uv__process_child_fail("execve()");
     /* Execution never reaches here. */
   }
 
   /* Parent. */
 
-  /* Restore environment. */
-  environ = save_our_env;
-
 #if SPAWN_WAIT_EXEC
   /* POLLHUP signals child has exited or execve()'d. */
   uv__close(signal_pipe[1]);
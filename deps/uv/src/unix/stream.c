@@ -28,6 +28,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/uio.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#if defined(__linux__)
+# include <fcntl.h> /* splice */
+#endif
+
+#ifndef IOV_MAX
+# define IOV_MAX 1024
+#endif
 
 
 static void uv__stream_connect(uv_stream_t*);
@@ -63,6 +74,13 @@ int uv__stream_open(uv_stream_t* stream, int fd, int flags) {
     return -1;
   }
 
+  if (stream->type == UV_TCP
+      && (stream->flags & UV_TCP_NODELAY)
+      && uv__tcp_nodelay((uv_tcp_t*)stream, 1)) {
+    uv_err_new(stream->loop, errno);
+    return -1;
+  }
+
   /* Associate the fd with each ev_io watcher. */
   ev_io_set(&stream->read_watcher, fd, EV_READ);
   ev_io_set(&stream->write_watcher, fd, EV_WRITE);
@@ -226,108 +244,143 @@ static void uv__drain(uv_stream_t* stream) {
 }
 
 
-/* On success returns NULL. On error returns a pointer to the write request
+/* Retires `n` written bytes from the front of the write queue. Requests that
+ * are done move to write_completed_queue, where they will have their callback
+ * called in the near future.
+ */
+static void uv__write_advance(uv_stream_t* stream, size_t n) {
+  uv_write_t* req;
+  uv_buf_t* buf;
+
+  while ((req = uv_write_queue_head(stream)) != NULL) {
+    while (req->write_index < req->bufcnt) {
+      buf = &(req->bufs[req->write_index]);
+
+      if (n < buf->len) {
+        /* There is more to write. */
+        buf->base += n;
+        buf->len -= n;
+        stream->write_queue_size -= n;
+        return;
+      }
+
+      /* Finished writing the buf at index req->write_index. */
+      n -= buf->len;
+      assert(stream->write_queue_size >= buf->len);
+      stream->write_queue_size -= buf->len;
+      req->write_index++;
+    }
+
+    /* Pop the req off tcp->write_queue. */
+    ngx_queue_remove(&req->queue);
+    if (req->bufs != req->bufsml) {
+      free(req->bufs);
+    }
+    req->bufs = NULL;
+
+    ngx_queue_insert_tail(&stream->write_completed_queue, &req->queue);
+    ev_feed_event(stream->loop->ev, &stream->write_watcher, EV_WRITE);
+  }
+
+  assert(n == 0);
+}
+
+
+/* Writes as much of the write queue as the socket takes. The pending buffers
+ * of all queued requests, up to IOV_MAX of them, go out in a single writev.
+ *
+ * On success returns NULL. On error returns a pointer to the write request
  * which had the error.
  */
 static uv_write_t* uv__write(uv_stream_t* stream) {
-  uv_write_t* req;
+  struct iovec iovbuf[IOV_MAX];
   struct iovec* iov;
+  ngx_queue_t* q;
+  uv_write_t* req;
+  uv_write_t* r;
+  size_t size;
   int iovcnt;
+  int i;
   ssize_t n;
 
   assert(stream->fd >= 0);
 
-  /* TODO: should probably while(1) here until EAGAIN */
-
-  /* Get the request at the head of the queue. */
-  req = uv_write_queue_head(stream);
-  if (!req) {
-    assert(stream->write_queue_size == 0);
-    return NULL;
-  }
-
-  assert(req->handle == stream);
-
   /* Cast to iovec. We had to have our own uv_buf_t instead of iovec
    * because Windows's WSABUF is not an iovec.
    */
   assert(sizeof(uv_buf_t) == sizeof(struct iovec));
-  iov = (struct iovec*) &(req->bufs[req->write_index]);
-  iovcnt = req->bufcnt - req->write_index;
 
-  /* Now do the actual writev. Note that we've been updating the pointers
-   * inside the iov each time we write. So there is no need to offset it.
-   */
+  for (;;) {
+    /* Get the request at the head of the queue. */
+    req = uv_write_queue_head(stream);
+    if (!req) {
+      assert(stream->write_queue_size == 0);
+      return NULL;
+    }
 
-  do {
-    if (iovcnt == 1) {
-      n = write(stream->fd, iov[0].iov_base, iov[0].iov_len);
+    assert(req->handle == stream);
+
+    if (ngx_queue_next(&req->queue) ==
+        ngx_queue_sentinel(&stream->write_queue)) {
+      /* Only one request. Note that we've been updating the pointers inside
+       * its bufs each time we write, so there is no need to offset it.
+       */
+      iov = (struct iovec*) &(req->bufs[req->write_index]);
+      iovcnt = req->bufcnt - req->write_index;
+      if (iovcnt > IOV_MAX) {
+        iovcnt = IOV_MAX;
+      }
     } else {
-      n = writev(stream->fd, iov, iovcnt);
+      iov = iovbuf;
+      iovcnt = 0;
+      for (q = ngx_queue_head(&stream->write_queue);
+           q != ngx_queue_sentinel(&stream->write_queue);
+           q = ngx_queue_next(q)) {
+        r = ngx_queue_data(q, struct uv_write_s, queue);
+        for (i = r->write_index; i < r->bufcnt && iovcnt < IOV_MAX; i++) {
+          iov[iovcnt].iov_base = r->bufs[i].base;
+          iov[iovcnt].iov_len = r->bufs[i].len;
+          iovcnt++;
+        }
+        if (iovcnt == IOV_MAX) {
+          break;
+        }
+      }
     }
-  }
-  while (n == -1 && errno == EINTR);
 
-  if (n < 0) {
-    if (errno != EAGAIN) {
-      /* Error */
-      uv_err_new(stream->loop, errno);
-      return req;
+    size = 0;
+    for (i = 0; i < iovcnt; i++) {
+      size += iov[i].iov_len;
     }
-  } else {
-    /* Successful write */
 
-    /* Update the counters. */
-    while (n >= 0) {
-      uv_buf_t* buf = &(req->bufs[req->write_index]);
-      size_t len = buf->len;
+    do {
+      if (iovcnt == 1) {
+        n = write(stream->fd, iov[0].iov_base, iov[0].iov_len);
+      } else {
+        n = writev(stream->fd, iov, iovcnt);
+      }
+    }
+    while (n == -1 && errno == EINTR);
 
-      assert(req->write_index < req->bufcnt);
+    if (n < 0) {
+      if (errno != EAGAIN) {
+        /* Error */
+        uv_err_new(stream->loop, errno);
+        return req;
+      }
+      break;
+    }
 
-      if ((size_t)n < len) {
-        buf->base += n;
-        buf->len -= n;
-        stream->write_queue_size -= n;
-        n = 0;
+    /* Successful write. Update the counters. */
+    uv__write_advance(stream, n);
 
-        /* There is more to write. Break and ensure the watcher is pending. */
-        break;
-
-      } else {
-        /* Finished writing the buf at index req->write_index. */
-        req->write_index++;
-
-        assert((size_t)n >= len);
-        n -= len;
-
-        assert(stream->write_queue_size >= len);
-        stream->write_queue_size -= len;
-
-        if (req->write_index == req->bufcnt) {
-          /* Then we're done! */
-          assert(n == 0);
-
-          /* Pop the req off tcp->write_queue. */
-          ngx_queue_remove(&req->queue);
-          if (req->bufs != req->bufsml) {
-            free(req->bufs);
-          }
-          req->bufs = NULL;
-
-          /* Add it to the write_completed_queue where it will have its
-           * callback called in the near future.
-           * TODO: start trying to write the next request.
-           */
-          ngx_queue_insert_tail(&stream->write_completed_queue, &req->queue);
-          ev_feed_event(stream->loop->ev, &stream->write_watcher, EV_WRITE);
-          return NULL;
-        }
-      }
+    if ((size_t)n < size) {
+      /* Short write, the socket buffer is full. */
+      break;
     }
-  }
 
-  /* Either we've counted n down to zero or we've got EAGAIN. */
-  assert(n == 0 || n == -1);
+    /* Everything we gathered went out. Keep going while there is more. */
+  }
 
   /* We're not done. */
   ev_io_start(stream->loop->ev, &stream->write_watcher);
@@ -412,6 +465,14 @@ static void uv__read(uv_stream_t* stream) {
     } else {
       /* Successful read */
       stream->read_cb(stream, nread, buf);
+
+      /* A short read means the socket buffer has been drained. Don't spend
+       * another read(2) just to see EAGAIN; the watcher is level-triggered
+       * and fires again as soon as more data comes in.
+       */
+      if ((size_t)nread < buf.len) {
+        return;
+      }
     }
   }
 }
@@ -467,7 +528,15 @@ void uv__stream_io(EV_P_ ev_io* watcher, int revents) {
     }
 
     if (revents & EV_WRITE) {
-      uv_write_t* req = uv__write(stream);
+      uv_write_t* req = NULL;
+
+      if (stream->flags & UV_CORKED) {
+        /* Writes are held back until uv_uncork(). */
+        ev_io_stop(stream->loop->ev, &stream->write_watcher);
+      } else {
+        req = uv__write(stream);
+      }
+
       if (req) {
         /* Error. Notify the user. */
         if (req->cb) {
@@ -659,6 +728,11 @@ int uv_write(uv_write_t* req, uv_stream_t* handle, uv_buf_t bufs[], int bufcnt,
    * do the write immediately. Otherwise start the write_watcher and wait
    * for the fd to become writable.
    */
+  if (stream->flags & UV_CORKED) {
+    /* Held back until uv_uncork(). */
+    return 0;
+  }
+
   if (empty_queue) {
     if (uv__write(stream)) {
       /* Error. uv_last_error has been set. */
@@ -683,6 +757,370 @@ int uv_write(uv_write_t* req, uv_stream_t* handle, uv_buf_t bufs[], int bufcnt,
 }
 
 
+
+int uv_try_write(uv_stream_t* stream, uv_buf_t bufs[], int bufcnt) {
+  ssize_t n;
+
+  assert((stream->type == UV_TCP || stream->type == UV_NAMED_PIPE)
+      && "uv_try_write (unix) does not yet support other types of streams");
+
+  /* Writing now would put the data ahead of what is already queued. */
+  if (stream->fd < 0 ||
+      stream->connect_req ||
+      (stream->flags & UV_CORKED) ||
+      !ngx_queue_empty(&stream->write_queue)) {
+    return 0;
+  }
+
+  if (bufcnt > IOV_MAX) {
+    bufcnt = IOV_MAX;
+  }
+
+  assert(sizeof(uv_buf_t) == sizeof(struct iovec));
+
+  do {
+    if (bufcnt == 1) {
+      n = write(stream->fd, bufs[0].base, bufs[0].len);
+    } else {
+      n = writev(stream->fd, (struct iovec*) bufs, bufcnt);
+    }
+  }
+  while (n == -1 && errno == EINTR);
+
+  if (n < 0) {
+    if (errno == EAGAIN) {
+      return 0;
+    }
+    uv_err_new(stream->loop, errno);
+    return -1;
+  }
+
+  return n;
+}
+
+/* Sets TCP_CORK where there is one. Elsewhere Nagle is switched back on for
+ * the duration when the user disabled it; switching it off again pushes out
+ * whatever is still queued.
+ */
+static void uv__stream_set_cork(uv_stream_t* stream, int enable) {
+  if (stream->type != UV_TCP || stream->fd < 0) {
+    return;
+  }
+
+#if defined(TCP_CORK)
+  setsockopt(stream->fd, IPPROTO_TCP, TCP_CORK, &enable, sizeof enable);
+#else
+  if (stream->flags & UV_TCP_NODELAY) {
+    uv__tcp_nodelay((uv_tcp_t*)stream, !enable);
+  }
+#endif
+}
+
+
+int uv_cork(uv_stream_t* stream) {
+  assert(stream->type == UV_TCP || stream->type == UV_NAMED_PIPE);
+
+  if (!(stream->flags & UV_CORKED)) {
+    stream->flags |= UV_CORKED;
+    uv__stream_set_cork(stream, 1);
+  }
+
+  return 0;
+}
+
+
+int uv_uncork(uv_stream_t* stream) {
+  assert(stream->type == UV_TCP || stream->type == UV_NAMED_PIPE);
+
+  if (!(stream->flags & UV_CORKED)) {
+    return 0;
+  }
+
+  stream->flags &= ~UV_CORKED;
+
+  if (stream->fd >= 0 && uv_write_queue_head(stream)) {
+    if (uv__write(stream)) {
+      /* Let uv__stream_io() retry and report the error to the request on a
+       * fresh stack.
+       */
+      ev_feed_event(stream->loop->ev, &stream->write_watcher, EV_WRITE);
+    }
+  }
+
+  uv__stream_set_cork(stream, 0);
+
+  return 0;
+}
+
+
+/* Bytes moved from src per read. */
+#define UV__SPLICE_CHUNK (64 * 1024)
+
+/* Reads per wakeup; a busy splice doesn't get to starve the other watchers. */
+#define UV__SPLICE_BURST 16
+
+enum {
+  UV__SPLICE_EOF     = 0x01,
+  UV__SPLICE_ABORTED = 0x02
+};
+
+
+static void uv__splice_finish(uv_splice_t* req, int status) {
+  ev_io_stop(req->loop->ev, &req->read_watcher);
+  ev_io_stop(req->loop->ev, &req->write_watcher);
+
+  if (!(req->flags & UV__SPLICE_ABORTED)) {
+    req->src->splice = NULL;
+    req->dst->splice = NULL;
+  }
+
+  if (req->pipefd[0] >= 0) {
+    uv__close(req->pipefd[0]);
+    uv__close(req->pipefd[1]);
+    req->pipefd[0] = req->pipefd[1] = -1;
+  }
+
+  free(req->buf);
+  req->buf = NULL;
+
+  if (req->cb) {
+    req->cb(req, status);
+  }
+}
+
+
+/* Only one of the watchers is ever active: we either wait for src to have
+ * data or, while there is some left over, for dst to take it.
+ */
+static void uv__splice_wait(uv_splice_t* req) {
+  if (req->pending) {
+    ev_io_stop(req->loop->ev, &req->read_watcher);
+    ev_io_start(req->loop->ev, &req->write_watcher);
+  } else {
+    ev_io_stop(req->loop->ev, &req->write_watcher);
+    ev_io_start(req->loop->ev, &req->read_watcher);
+  }
+}
+
+
+static ssize_t uv__splice_in(uv_splice_t* req) {
+  ssize_t n;
+
+#if defined(__linux__)
+  if (req->buf == NULL) {
+    n = splice(req->src->fd, NULL, req->pipefd[1], NULL, UV__SPLICE_CHUNK,
+        SPLICE_F_NONBLOCK | SPLICE_F_MOVE);
+
+    if (n != -1 || errno != EINVAL) {
+      return n;
+    }
+
+    /* src doesn't do splice(2), copy through user space from now on. The
+     * pipe is empty when we get here.
+     */
+    uv__close(req->pipefd[0]);
+    uv__close(req->pipefd[1]);
+    req->pipefd[0] = req->pipefd[1] = -1;
+
+    req->buf = malloc(UV__SPLICE_CHUNK);
+    if (req->buf == NULL) {
+      errno = ENOMEM;
+      return -1;
+    }
+  }
+#endif
+
+  n = read(req->src->fd, req->buf, UV__SPLICE_CHUNK);
+  req->buf_offset = 0;
+
+  return n;
+}
+
+
+static ssize_t uv__splice_out(uv_splice_t* req) {
+  ssize_t n;
+
+#if defined(__linux__)
+  if (req->buf == NULL) {
+    return splice(req->pipefd[0], NULL, req->dst->fd, NULL, req->pending,
+        SPLICE_F_NONBLOCK | SPLICE_F_MOVE);
+  }
+#endif
+
+  n = write(req->dst->fd, req->buf + req->buf_offset, req->pending);
+
+  if (n > 0) {
+    req->buf_offset += n;
+  }
+
+  return n;
+}
+
+
+static void uv__splice_pump(uv_splice_t* req) {
+  ssize_t n;
+  int i;
+
+  for (i = 0; i < UV__SPLICE_BURST; i++) {
+    /* Get rid of what we have before reading more. */
+    while (req->pending > 0) {
+      n = uv__splice_out(req);
+
+      if (n == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+
+        if (errno == EAGAIN) {
+          /* dst is full. Stop reading src until it drains. */
+          uv__splice_wait(req);
+          return;
+        }
+
+        uv_err_new(req->loop, errno);
+        uv__splice_finish(req, -1);
+        return;
+      }
+
+      req->pending -= n;
+      req->bytes += n;
+    }
+
+    if (req->flags & UV__SPLICE_EOF) {
+      uv__splice_finish(req, 0);
+      return;
+    }
+
+    do {
+      n = uv__splice_in(req);
+    }
+    while (n == -1 && errno == EINTR);
+
+    if (n == -1) {
+      if (errno == EAGAIN) {
+        uv__splice_wait(req);
+        return;
+      }
+
+      uv_err_new(req->loop, errno);
+      uv__splice_finish(req, -1);
+      return;
+    }
+
+    if (n == 0) {
+      req->flags |= UV__SPLICE_EOF;
+    }
+
+    req->pending = n;
+  }
+
+  uv__splice_wait(req);
+}
+
+
+static void uv__splice_io(EV_P_ ev_io* watcher, int revents) {
+  uv_splice_t* req = watcher->data;
+
+  assert(req->type == UV_SPLICE);
+
+  if (req->flags & UV__SPLICE_ABORTED) {
+    uv_err_new_artificial(req->loop, UV_ECONNABORTED);
+    uv__splice_finish(req, -1);
+    return;
+  }
+
+  uv__splice_pump(req);
+}
+
+
+/* Called by uv_close() on either end. The fds are about to go away so the
+ * watchers are stopped now; the callback is made on the next loop iteration.
+ */
+void uv__splice_abort(uv_splice_t* req) {
+  ev_io_stop(req->loop->ev, &req->read_watcher);
+  ev_io_stop(req->loop->ev, &req->write_watcher);
+
+  req->src->splice = NULL;
+  req->dst->splice = NULL;
+  req->src = NULL;
+  req->dst = NULL;
+
+  req->flags |= UV__SPLICE_ABORTED;
+  ev_feed_event(req->loop->ev, &req->read_watcher, EV_CUSTOM);
+}
+
+
+int uv_splice(uv_splice_t* req, uv_stream_t* src, uv_stream_t* dst,
+    uv_splice_cb cb) {
+  uv_loop_t* loop = src->loop;
+
+  assert(src->type == UV_TCP || src->type == UV_NAMED_PIPE);
+  assert(dst->type == UV_TCP || dst->type == UV_NAMED_PIPE);
+
+  if (src == dst ||
+      src->fd < 0 ||
+      dst->fd < 0 ||
+      (src->flags & UV_CLOSING) ||
+      (dst->flags & (UV_CLOSING | UV_SHUTTING | UV_SHUT))) {
+    uv_err_new(loop, EINVAL);
+    return -1;
+  }
+
+  if (src->splice ||
+      dst->splice ||
+      dst->connect_req ||
+      !ngx_queue_empty(&dst->write_queue)) {
+    uv_err_new_artificial(loop, UV_EBUSY);
+    return -1;
+  }
+
+  uv__req_init((uv_req_t*)req);
+  req->type = UV_SPLICE;
+  req->loop = loop;
+  req->cb = cb;
+  req->src = src;
+  req->dst = dst;
+  req->bytes = 0;
+  req->pending = 0;
+  req->buf_offset = 0;
+  req->flags = 0;
+  req->buf = NULL;
+  req->pipefd[0] = req->pipefd[1] = -1;
+
+#if defined(__linux__)
+  if (pipe(req->pipefd)) {
+    uv_err_new(loop, errno);
+    return -1;
+  }
+
+  uv__nonblock(req->pipefd[0], 1);
+  uv__nonblock(req->pipefd[1], 1);
+  uv__cloexec(req->pipefd[0], 1);
+  uv__cloexec(req->pipefd[1], 1);
+#else
+  req->buf = malloc(UV__SPLICE_CHUNK);
+  if (req->buf == NULL) {
+    uv_err_new(loop, ENOMEM);
+    return -1;
+  }
+#endif
+
+  uv_read_stop(src);
+
+  src->splice = req;
+  dst->splice = req;
+
+  ev_io_init(&req->read_watcher, uv__splice_io, src->fd, EV_READ);
+  req->read_watcher.data = req;
+  ev_io_init(&req->write_watcher, uv__splice_io, dst->fd, EV_WRITE);
+  req->write_watcher.data = req;
+
+  ev_io_start(loop->ev, &req->read_watcher);
+
+  return 0;
+}
+
+
 int uv_read_start(uv_stream_t* stream, uv_alloc_cb alloc_cb, uv_read_cb read_cb) {
   assert(stream->type == UV_TCP || stream->type == UV_NAMED_PIPE);
 
@@ -24,6 +24,8 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 
 
 int uv_tcp_init(uv_loop_t* loop, uv_tcp_t* tcp) {
@@ -33,6 +35,7 @@ int uv_tcp_init(uv_loop_t* loop, uv_tcp_t* tcp) {
   tcp->alloc_cb = NULL;
   tcp->connect_req = NULL;
   tcp->accepted_fd = -1;
+  tcp->splice = NULL;
   tcp->fd = -1;
   tcp->delayed_error = 0;
   ngx_queue_init(&tcp->write_queue);
@@ -298,3 +301,25 @@ out:
   errno = saved_errno;
   return status;
 }
+
+
+int uv__tcp_nodelay(uv_tcp_t* handle, int enable) {
+  return setsockopt(handle->fd, IPPROTO_TCP, TCP_NODELAY, &enable,
+                    sizeof enable);
+}
+
+
+int uv_tcp_nodelay(uv_tcp_t* handle, int enable) {
+  if (handle->fd >= 0 && uv__tcp_nodelay(handle, enable)) {
+    uv_err_new(handle->loop, errno);
+    return -1;
+  }
+
+  if (enable) {
+    handle->flags |= UV_TCP_NODELAY;
+  } else {
+    handle->flags &= ~UV_TCP_NODELAY;
+  }
+
+  return 0;
+}
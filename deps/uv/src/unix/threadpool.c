@@ -0,0 +1,445 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/*
+ * The thread pool behind uv_queue_work. libeio keeps the fs requests.
+ *
+ * Every thread owns a queue with its own lock. uv_queue_work appends to the
+ * queues in turn; a thread runs the oldest request in its own queue and,
+ * when that is empty, takes the newest request from another thread's queue,
+ * so one slow request doesn't hold up the ones queued behind it. Threads with
+ * nothing to do sleep on a single condition variable that is only signalled
+ * when a thread is known to be asleep. Finished requests go back to their
+ * loop through a uv_mpsc_t, which delivers all of them in one callback.
+ *
+ * req->work_queue is the index of the queue a request waits in, or one of
+ * the values below once it has left it. It only changes under that queue's
+ * lock, which is what lets uv_cancel race with the threads.
+ */
+
+#include "uv.h"
+#include "internal.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define UV__POOL_MAX_THREADS 128
+
+#define UV__WORK_TAKEN     -1
+#define UV__WORK_CANCELLED -2
+
+typedef struct {
+  pthread_mutex_t lock;
+  uv_work_t* head; /* the owner takes from here */
+  uv_work_t* tail; /* new requests land here, other threads take from here */
+  char pad[64];    /* keep the queues on separate cache lines */
+} uv__work_queue_t;
+
+static struct {
+  pthread_once_t once;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  volatile int started;
+  volatile int size;     /* number of threads wanted */
+  volatile int nthreads; /* number of threads started */
+  volatile int idle;
+  unsigned int next;
+  volatile uint64_t queued;
+  volatile uint64_t active;
+  volatile uint64_t completed;
+  volatile uint64_t steals;
+  uv__work_queue_t queues[UV__POOL_MAX_THREADS];
+} pool = { PTHREAD_ONCE_INIT };
+
+
+static int uv__pool_default_size(void) {
+  const char* val;
+  long n;
+
+  val = getenv("UV_THREADPOOL_SIZE");
+  n = val ? atol(val) : sysconf(_SC_NPROCESSORS_ONLN);
+
+  if (n < 1) n = 1;
+  if (n > UV__POOL_MAX_THREADS) n = UV__POOL_MAX_THREADS;
+
+  return (int) n;
+}
+
+
+static void uv__pool_init(void) {
+  int i;
+
+  pthread_mutex_init(&pool.lock, NULL);
+  pthread_cond_init(&pool.cond, NULL);
+
+  for (i = 0; i < UV__POOL_MAX_THREADS; i++) {
+    pthread_mutex_init(&pool.queues[i].lock, NULL);
+  }
+
+  pool.size = uv__pool_default_size();
+}
+
+
+static void uv__queue_push(uv__work_queue_t* q, uv_work_t* req) {
+  pthread_mutex_lock(&q->lock);
+
+  req->work_queue = q - pool.queues;
+
+  req->work_next = NULL;
+  req->work_prev = q->tail;
+  if (q->tail) {
+    q->tail->work_next = req;
+  } else {
+    q->head = req;
+  }
+  q->tail = req;
+
+  /* Counted before the lock is dropped, so a thread that takes req can't
+   * decrement pool.queued ahead of this increment.
+   */
+  __sync_fetch_and_add(&pool.queued, 1);
+
+  pthread_mutex_unlock(&q->lock);
+}
+
+
+static uv_work_t* uv__queue_take(uv__work_queue_t* q, int steal) {
+  uv_work_t* req;
+
+  if ((steal ? q->tail : q->head) == NULL) {
+    return NULL; /* Don't bother locking an empty queue. */
+  }
+
+  pthread_mutex_lock(&q->lock);
+
+  if (steal) {
+    req = q->tail;
+    if (req) {
+      q->tail = req->work_prev;
+      if (q->tail) q->tail->work_next = NULL; else q->head = NULL;
+    }
+  } else {
+    req = q->head;
+    if (req) {
+      q->head = req->work_next;
+      if (q->head) q->head->work_prev = NULL; else q->tail = NULL;
+    }
+  }
+
+  if (req) {
+    req->work_queue = UV__WORK_TAKEN;
+    __sync_fetch_and_sub(&pool.queued, 1);
+  }
+
+  pthread_mutex_unlock(&q->lock);
+
+  return req;
+}
+
+
+/* Unlinks req if it is still waiting in q. */
+static int uv__queue_remove(uv__work_queue_t* q, uv_work_t* req) {
+  int r;
+
+  pthread_mutex_lock(&q->lock);
+
+  if (req->work_queue == q - pool.queues) {
+    if (req->work_prev) {
+      req->work_prev->work_next = req->work_next;
+    } else {
+      q->head = req->work_next;
+    }
+
+    if (req->work_next) {
+      req->work_next->work_prev = req->work_prev;
+    } else {
+      q->tail = req->work_prev;
+    }
+
+    req->work_queue = UV__WORK_CANCELLED;
+    __sync_fetch_and_sub(&pool.queued, 1);
+    r = 0;
+  } else {
+    r = -1;
+  }
+
+  pthread_mutex_unlock(&q->lock);
+
+  return r;
+}
+
+
+static uv_work_t* uv__pool_next(int self) {
+  uv_work_t* req;
+  int n;
+  int i;
+
+  req = uv__queue_take(&pool.queues[self], 0);
+  if (req) return req;
+
+  n = pool.nthreads;
+  for (i = 1; i < n; i++) {
+    req = uv__queue_take(&pool.queues[(self + i) % n], 1);
+    if (req) {
+      __sync_fetch_and_add(&pool.steals, 1);
+      return req;
+    }
+  }
+
+  return NULL;
+}
+
+
+static void* uv__pool_thread(void* arg) {
+  int self = (int) (intptr_t) arg;
+  uv_work_t* req;
+
+  for (;;) {
+    req = uv__pool_next(self);
+
+    if (req == NULL) {
+      pthread_mutex_lock(&pool.lock);
+      __sync_fetch_and_add(&pool.idle, 1);
+      while (pool.queued == 0) {
+        pthread_cond_wait(&pool.cond, &pool.lock);
+      }
+      __sync_fetch_and_sub(&pool.idle, 1);
+      pthread_mutex_unlock(&pool.lock);
+      continue;
+    }
+
+    __sync_fetch_and_add(&pool.active, 1);
+
+    if (req->work_cb) {
+      req->work_cb(req);
+    }
+
+    __sync_fetch_and_sub(&pool.active, 1);
+    __sync_fetch_and_add(&pool.completed, 1);
+
+    uv_mpsc_push(req->loop->work_done, &req->work_done);
+  }
+
+  return NULL;
+}
+
+
+/* Starts threads until there are pool.size of them. Called with pool.lock
+ * held.
+ */
+static int uv__pool_grow(void) {
+  pthread_attr_t attr;
+  pthread_t thread;
+  sigset_t set;
+  sigset_t old;
+  int r;
+
+  r = 0;
+
+  /* Signals are for the loop thread. */
+  sigfillset(&set);
+  pthread_sigmask(SIG_SETMASK, &set, &old);
+
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  while (pool.nthreads < pool.size) {
+    r = pthread_create(&thread, &attr, uv__pool_thread,
+        (void*) (intptr_t) pool.nthreads);
+    if (r) break;
+    pool.nthreads++;
+  }
+
+  pthread_attr_destroy(&attr);
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+  /* Running with fewer threads than asked for is fine, with none it isn't. */
+  return pool.nthreads > 0 ? 0 : r;
+}
+
+
+static void uv__work_done(uv_mpsc_t* mpsc, uv_mpsc_node_t* nodes,
+    int status) {
+  uv_work_t* req;
+
+  while (nodes) {
+    req = (uv_work_t*) ((char*) nodes - offsetof(uv_work_t, work_done));
+    nodes = nodes->next;
+
+    uv_unref(req->loop);
+
+    if (req->work_queue == UV__WORK_CANCELLED) {
+      uv_err_new_artificial(req->loop, UV_ECANCELED);
+      status = -1;
+    } else {
+      status = 0;
+    }
+
+    if (req->after_work_cb) {
+      req->after_work_cb(req, status);
+    }
+  }
+}
+
+
+int uv_queue_work(uv_loop_t* loop, uv_work_t* req, uv_work_cb work_cb,
+    uv_after_work_cb after_work_cb) {
+  void* data = req->data;
+  unsigned int n;
+  int r;
+
+  pthread_once(&pool.once, uv__pool_init);
+
+  if (!pool.started) {
+    pthread_mutex_lock(&pool.lock);
+    r = uv__pool_grow();
+    pool.started = 1;
+    pthread_mutex_unlock(&pool.lock);
+
+    if (r) {
+      uv_err_new(loop, r);
+      return -1;
+    }
+  }
+
+  if (loop->work_done == NULL) {
+    loop->work_done = malloc(sizeof *loop->work_done);
+    if (loop->work_done == NULL) {
+      uv_err_new(loop, ENOMEM);
+      return -1;
+    }
+    uv_mpsc_init(loop, loop->work_done, uv__work_done);
+    /* Only queued requests keep the loop alive, not the mpsc itself. */
+    uv_unref(loop);
+  }
+
+  uv__req_init((uv_req_t*) req);
+  uv_ref(loop);
+  req->type = UV_WORK;
+  req->loop = loop;
+  req->data = data;
+  req->work_cb = work_cb;
+  req->after_work_cb = after_work_cb;
+
+  n = pool.nthreads;
+  uv__queue_push(&pool.queues[pool.next++ % n], req);
+
+  if (pool.idle) {
+    pthread_mutex_lock(&pool.lock);
+    pthread_cond_signal(&pool.cond);
+    pthread_mutex_unlock(&pool.lock);
+  }
+
+  return 0;
+}
+
+
+int uv__work_cancel(uv_work_t* req) {
+  int q = req->work_queue;
+
+  if (q < 0 || uv__queue_remove(&pool.queues[q], req)) {
+    return -1;
+  }
+
+  /* The callback comes from the loop like any other completion. */
+  uv_mpsc_push(req->loop->work_done, &req->work_done);
+
+  return 0;
+}
+
+
+void uv__work_destroy(uv_loop_t* loop) {
+  /* The async watcher goes away with the ev loop. */
+  free(loop->work_done);
+  loop->work_done = NULL;
+}
+
+
+int uv_threadpool_set_size(uv_threadpool_type type, int threads) {
+  int r;
+
+  if (threads < 1 || threads > UV__POOL_MAX_THREADS) {
+    return -1;
+  }
+
+  if (type == UV_THREADPOOL_IO) {
+    eio_set_min_parallel(threads);
+    eio_set_max_parallel(threads);
+    return 0;
+  }
+
+  pthread_once(&pool.once, uv__pool_init);
+
+  pthread_mutex_lock(&pool.lock);
+
+  if (pool.started) {
+    if (threads < pool.nthreads) {
+      r = -1;
+    } else {
+      pool.size = threads;
+      r = uv__pool_grow() ? -1 : 0;
+    }
+  } else {
+    pool.size = threads;
+    r = 0;
+  }
+
+  pthread_mutex_unlock(&pool.lock);
+
+  return r;
+}
+
+
+int uv_threadpool_stats(uv_threadpool_type type,
+    uv_threadpool_stats_t* stats) {
+  unsigned int ready;
+  unsigned int reqs;
+  unsigned int pending;
+
+  memset(stats, 0, sizeof *stats);
+
+  if (type == UV_THREADPOOL_IO) {
+    reqs = eio_nreqs();
+    ready = eio_nready();
+    pending = eio_npending();
+    stats->threads = eio_nthreads();
+    stats->queued = ready;
+    /* The three counters aren't read atomically. */
+    stats->active = reqs > ready + pending ? reqs - ready - pending : 0;
+    return 0;
+  }
+
+  pthread_once(&pool.once, uv__pool_init);
+
+  stats->threads = pool.started ? pool.nthreads : pool.size;
+  stats->queued = pool.queued;
+  stats->active = pool.active;
+  stats->completed = pool.completed;
+  stats->steals = pool.steals;
+
+  return 0;
+}
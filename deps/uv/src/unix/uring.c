@@ -0,0 +1,587 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/*
+ * io_uring backend for the uv_fs_* requests that matter most for throughput:
+ * open, close, read, write, fsync, fdatasync, stat, lstat and fstat.
+ *
+ * Requests are put on the submission queue as they come in and are handed to
+ * the kernel in one io_uring_enter() call per loop iteration, from a prepare
+ * watcher. Completions are signalled through an eventfd that is watched by
+ * the libev loop. When the kernel (or the headers we were built against)
+ * lacks io_uring or one of the opcodes, or the rings are full, the uv__uring_*
+ * functions return -1 and fs.c uses libeio as before. Set UV_USE_IO_URING=0
+ * in the environment to always use libeio.
+ */
+
+#include "uv.h"
+#include "internal.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#if defined(__has_include)
+# if __has_include(<linux/io_uring.h>)
+#  include <linux/io_uring.h>
+#  include <sys/eventfd.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <sys/sysmacros.h>
+#  if defined(__NR_io_uring_setup) && defined(IORING_FEAT_RW_CUR_POS)
+#   define UV__HAVE_IO_URING 1
+#  endif
+# endif
+#endif
+
+
+#if UV__HAVE_IO_URING
+
+#define UV__URING_ENTRIES 64
+
+struct uv__uring {
+  uv_loop_t* loop;
+  int ringfd;
+  int eventfd;
+  unsigned features;
+  unsigned char ops[IORING_OP_LAST]; /* Supported opcodes. */
+
+  unsigned sq_entries;
+  unsigned* sq_head;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  struct io_uring_sqe* sqes;
+
+  unsigned cq_entries;
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  struct io_uring_cqe* cqes;
+
+  void* sq_ring;
+  size_t sq_ring_size;
+  void* cq_ring;
+  size_t cq_ring_size;
+  size_t sqes_size;
+
+  unsigned unsubmitted; /* Queued, not yet seen by the kernel. */
+  unsigned inflight;    /* Submitted, not yet completed. */
+
+  ev_prepare prepare_watcher;
+  ev_io eventfd_watcher;
+  ev_timer retry_watcher;
+};
+
+
+static int uv__io_uring_setup(unsigned entries, struct io_uring_params* p) {
+  return syscall(__NR_io_uring_setup, entries, p);
+}
+
+
+static int uv__io_uring_enter(int fd, unsigned to_submit) {
+  return syscall(__NR_io_uring_enter, fd, to_submit, 0, 0, NULL, 0);
+}
+
+
+static int uv__io_uring_register(int fd, unsigned opcode, void* arg,
+    unsigned nargs) {
+  return syscall(__NR_io_uring_register, fd, opcode, arg, nargs);
+}
+
+
+static void uv__uring_free(struct uv__uring* u) {
+  if (u->sqes) munmap(u->sqes, u->sqes_size);
+  if (u->cq_ring && u->cq_ring != u->sq_ring) munmap(u->cq_ring,
+                                                     u->cq_ring_size);
+  if (u->sq_ring) munmap(u->sq_ring, u->sq_ring_size);
+  if (u->eventfd >= 0) close(u->eventfd);
+  if (u->ringfd >= 0) close(u->ringfd);
+  free(u);
+}
+
+
+static void uv__uring_submit(struct uv__uring* u) {
+  int n;
+
+  if (u->unsubmitted == 0) {
+    return;
+  }
+
+  do {
+    n = uv__io_uring_enter(u->ringfd, u->unsubmitted);
+  }
+  while (n == -1 && errno == EINTR);
+
+  if (n > 0) {
+    assert((unsigned)n <= u->unsubmitted);
+    u->unsubmitted -= n;
+    u->inflight += n;
+  }
+
+  /* EAGAIN or EBUSY: the kernel is short on resources. The prepare watcher
+   * only runs when the loop wakes up, which it may never do if nothing else
+   * is pending, so make sure it does. The timer is not unref'd: the requests
+   * that are waiting keep the loop alive anyway.
+   */
+  if (u->unsubmitted > 0) {
+    if (!ev_is_active(&u->retry_watcher)) {
+      ev_timer_start(u->loop->ev, &u->retry_watcher);
+    }
+  } else if (ev_is_active(&u->retry_watcher)) {
+    ev_timer_stop(u->loop->ev, &u->retry_watcher);
+  }
+}
+
+
+static void uv__uring_retry(EV_P_ ev_timer* watcher, int revents) {
+  struct uv__uring* u = watcher->data;
+  uv__uring_submit(u);
+}
+
+
+static void uv__uring_prepare(EV_P_ ev_prepare* watcher, int revents) {
+  struct uv__uring* u = watcher->data;
+  uv__uring_submit(u);
+}
+
+
+static void uv__uring_complete(uv_fs_t* req, int res, struct statx* stx) {
+  if (res < 0) {
+    req->result = -1;
+    req->errorno = uv_translate_sys_error(-res);
+  } else {
+    req->result = res;
+  }
+
+  switch (req->fs_type) {
+    case UV_FS_STAT:
+    case UV_FS_LSTAT:
+    case UV_FS_FSTAT:
+      req->ptr = NULL;
+      if (res == 0) {
+        memset(&req->statbuf, 0, sizeof req->statbuf);
+        req->statbuf.st_dev = makedev(stx->stx_dev_major, stx->stx_dev_minor);
+        req->statbuf.st_ino = stx->stx_ino;
+        req->statbuf.st_mode = stx->stx_mode;
+        req->statbuf.st_nlink = stx->stx_nlink;
+        req->statbuf.st_uid = stx->stx_uid;
+        req->statbuf.st_gid = stx->stx_gid;
+        req->statbuf.st_rdev = makedev(stx->stx_rdev_major,
+                                       stx->stx_rdev_minor);
+        req->statbuf.st_size = stx->stx_size;
+        req->statbuf.st_blksize = stx->stx_blksize;
+        req->statbuf.st_blocks = stx->stx_blocks;
+        req->statbuf.st_atim.tv_sec = stx->stx_atime.tv_sec;
+        req->statbuf.st_atim.tv_nsec = stx->stx_atime.tv_nsec;
+        req->statbuf.st_mtim.tv_sec = stx->stx_mtime.tv_sec;
+        req->statbuf.st_mtim.tv_nsec = stx->stx_mtime.tv_nsec;
+        req->statbuf.st_ctim.tv_sec = stx->stx_ctime.tv_sec;
+        req->statbuf.st_ctim.tv_nsec = stx->stx_ctime.tv_nsec;
+        req->ptr = &req->statbuf;
+      }
+      free(stx);
+      break;
+
+    default:
+      break;
+  }
+
+  uv_unref(req->loop);
+  req->cb(req);
+}
+
+
+static void uv__uring_reap(EV_P_ ev_io* watcher, int revents) {
+  struct uv__uring* u = watcher->data;
+  struct io_uring_cqe* cqe;
+  uv_fs_t* req;
+  uint64_t count;
+  unsigned head;
+  int res;
+
+  /* Reset the eventfd; it only tells us that there is something to reap. */
+  while (read(u->eventfd, &count, sizeof count) == -1 && errno == EINTR);
+
+  for (;;) {
+    head = *u->cq_head;
+    if (head == __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE)) {
+      break;
+    }
+
+    cqe = &u->cqes[head & *u->cq_mask];
+    req = (uv_fs_t*) (uintptr_t) cqe->user_data;
+    res = cqe->res;
+
+    /* Give the slot back before the callback, which may queue more. */
+    __atomic_store_n(u->cq_head, head + 1, __ATOMIC_RELEASE);
+    u->inflight--;
+
+    uv__uring_complete(req, res, req->ptr);
+  }
+}
+
+
+static struct uv__uring* uv__uring_new(uv_loop_t* loop) {
+  struct io_uring_params params;
+  struct io_uring_probe* probe;
+  struct uv__uring* u;
+  const char* env;
+  size_t probe_size;
+  int i;
+
+  env = getenv("UV_USE_IO_URING");
+  if (env && strcmp(env, "0") == 0) {
+    return NULL;
+  }
+
+  u = calloc(1, sizeof *u);
+  if (u == NULL) {
+    return NULL;
+  }
+
+  u->loop = loop;
+  u->eventfd = -1;
+
+  memset(&params, 0, sizeof params);
+  u->ringfd = uv__io_uring_setup(UV__URING_ENTRIES, &params);
+  if (u->ringfd == -1) {
+    goto fail;
+  }
+
+  uv__cloexec(u->ringfd, 1);
+  u->features = params.features;
+
+  /* Which of our opcodes does this kernel know? */
+  probe_size = sizeof *probe + IORING_OP_LAST * sizeof probe->ops[0];
+  probe = calloc(1, probe_size);
+  if (probe == NULL) {
+    goto fail;
+  }
+  if (uv__io_uring_register(u->ringfd, IORING_REGISTER_PROBE, probe,
+                            IORING_OP_LAST) == 0) {
+    for (i = 0; i <= probe->last_op && i < IORING_OP_LAST; i++) {
+      u->ops[i] = (probe->ops[i].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+  }
+  free(probe);
+
+  u->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  u->cq_ring_size = params.cq_off.cqes +
+                    params.cq_entries * sizeof(struct io_uring_cqe);
+  u->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    if (u->cq_ring_size > u->sq_ring_size) {
+      u->sq_ring_size = u->cq_ring_size;
+    }
+    u->cq_ring_size = u->sq_ring_size;
+  }
+
+  u->sq_ring = mmap(NULL, u->sq_ring_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, u->ringfd, IORING_OFF_SQ_RING);
+  if (u->sq_ring == MAP_FAILED) {
+    u->sq_ring = NULL;
+    goto fail;
+  }
+
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    u->cq_ring = u->sq_ring;
+  } else {
+    u->cq_ring = mmap(NULL, u->cq_ring_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, u->ringfd, IORING_OFF_CQ_RING);
+    if (u->cq_ring == MAP_FAILED) {
+      u->cq_ring = NULL;
+      goto fail;
+    }
+  }
+
+  u->sqes = mmap(NULL, u->sqes_size, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, u->ringfd, IORING_OFF_SQES);
+  if (u->sqes == MAP_FAILED) {
+    u->sqes = NULL;
+    goto fail;
+  }
+
+  u->sq_entries = params.sq_entries;
+  u->sq_head = (unsigned*) ((char*) u->sq_ring + params.sq_off.head);
+  u->sq_tail = (unsigned*) ((char*) u->sq_ring + params.sq_off.tail);
+  u->sq_mask = (unsigned*) ((char*) u->sq_ring + params.sq_off.ring_mask);
+  u->sq_array = (unsigned*) ((char*) u->sq_ring + params.sq_off.array);
+
+  u->cq_entries = params.cq_entries;
+  u->cq_head = (unsigned*) ((char*) u->cq_ring + params.cq_off.head);
+  u->cq_tail = (unsigned*) ((char*) u->cq_ring + params.cq_off.tail);
+  u->cq_mask = (unsigned*) ((char*) u->cq_ring + params.cq_off.ring_mask);
+  u->cqes = (struct io_uring_cqe*) ((char*) u->cq_ring + params.cq_off.cqes);
+
+  u->eventfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (u->eventfd == -1) {
+    goto fail;
+  }
+
+  if (uv__io_uring_register(u->ringfd, IORING_REGISTER_EVENTFD, &u->eventfd,
+                            1)) {
+    goto fail;
+  }
+
+  /* Submit after everything else that runs before the poll. Neither watcher
+   * keeps the loop alive, the requests themselves do.
+   */
+  ev_prepare_init(&u->prepare_watcher, uv__uring_prepare);
+  ev_set_priority(&u->prepare_watcher, EV_MINPRI);
+  u->prepare_watcher.data = u;
+  ev_prepare_start(loop->ev, &u->prepare_watcher);
+  ev_unref(loop->ev);
+
+  ev_io_init(&u->eventfd_watcher, uv__uring_reap, u->eventfd, EV_READ);
+  u->eventfd_watcher.data = u;
+  ev_io_start(loop->ev, &u->eventfd_watcher);
+  ev_unref(loop->ev);
+
+  ev_timer_init(&u->retry_watcher, uv__uring_retry, 0.001, 0.);
+  u->retry_watcher.data = u;
+
+  return u;
+
+fail:
+  uv__uring_free(u);
+  return NULL;
+}
+
+
+/* Returns a zeroed sqe for `opcode`, or NULL when the request has to go to
+ * the thread pool.
+ */
+static struct io_uring_sqe* uv__uring_get_sqe(uv_loop_t* loop, int opcode) {
+  struct uv__uring* u;
+  struct io_uring_sqe* sqe;
+  unsigned tail;
+  unsigned slot;
+
+  if (loop->uring == NULL) {
+    if (loop->uring_disabled) {
+      return NULL;
+    }
+    loop->uring = uv__uring_new(loop);
+    if (loop->uring == NULL) {
+      loop->uring_disabled = 1;
+      return NULL;
+    }
+  }
+
+  u = loop->uring;
+
+  if (!u->ops[opcode]) {
+    return NULL;
+  }
+
+  /* Never have more requests out than the completion queue holds. */
+  if (u->unsubmitted + u->inflight >= u->cq_entries) {
+    return NULL;
+  }
+
+  tail = *u->sq_tail;
+  if (tail - __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE) >= u->sq_entries) {
+    /* Submission queue full, flush it early. */
+    uv__uring_submit(u);
+    if (tail - __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE) >= u->sq_entries) {
+      return NULL;
+    }
+  }
+
+  slot = tail & *u->sq_mask;
+  sqe = &u->sqes[slot];
+  memset(sqe, 0, sizeof *sqe);
+  sqe->opcode = opcode;
+  u->sq_array[slot] = slot;
+
+  return sqe;
+}
+
+
+static void uv__uring_queue(uv_loop_t* loop, uv_fs_t* req,
+    struct io_uring_sqe* sqe) {
+  struct uv__uring* u = loop->uring;
+
+  sqe->user_data = (uintptr_t) req;
+  __atomic_store_n(u->sq_tail, *u->sq_tail + 1, __ATOMIC_RELEASE);
+  u->unsubmitted++;
+}
+
+
+int uv__uring_open(uv_loop_t* loop, uv_fs_t* req, const char* path, int flags,
+    int mode) {
+  struct io_uring_sqe* sqe = uv__uring_get_sqe(loop, IORING_OP_OPENAT);
+  if (sqe == NULL) return -1;
+
+  sqe->fd = AT_FDCWD;
+  sqe->addr = (uintptr_t) path;
+  sqe->len = mode;
+  sqe->open_flags = flags;
+
+  uv__uring_queue(loop, req, sqe);
+  return 0;
+}
+
+
+int uv__uring_close(uv_loop_t* loop, uv_fs_t* req, int fd) {
+  struct io_uring_sqe* sqe = uv__uring_get_sqe(loop, IORING_OP_CLOSE);
+  if (sqe == NULL) return -1;
+
+  sqe->fd = fd;
+
+  uv__uring_queue(loop, req, sqe);
+  return 0;
+}
+
+
+int uv__uring_rw(uv_loop_t* loop, uv_fs_t* req, int fd, void* buf,
+    size_t length, off_t offset) {
+  struct io_uring_sqe* sqe;
+  int opcode;
+
+  opcode = req->fs_type == UV_FS_READ ? IORING_OP_READ : IORING_OP_WRITE;
+
+  sqe = uv__uring_get_sqe(loop, opcode);
+  if (sqe == NULL) return -1;
+
+  /* Only newer kernels take offset -1 to mean the file position. The sqe
+   * isn't queued until uv__uring_queue so we can still back out.
+   */
+  if (offset < 0 && !(loop->uring->features & IORING_FEAT_RW_CUR_POS)) {
+    return -1;
+  }
+
+  sqe->fd = fd;
+  sqe->addr = (uintptr_t) buf;
+  sqe->len = length;
+  sqe->off = offset < 0 ? (uint64_t) -1 : (uint64_t) offset;
+
+  uv__uring_queue(loop, req, sqe);
+  return 0;
+}
+
+
+int uv__uring_fsync(uv_loop_t* loop, uv_fs_t* req, int fd, int datasync) {
+  struct io_uring_sqe* sqe = uv__uring_get_sqe(loop, IORING_OP_FSYNC);
+  if (sqe == NULL) return -1;
+
+  sqe->fd = fd;
+  sqe->fsync_flags = datasync ? IORING_FSYNC_DATASYNC : 0;
+
+  uv__uring_queue(loop, req, sqe);
+  return 0;
+}
+
+
+/* stat, lstat and fstat. `path` must stay valid until the request completes;
+ * pass NULL and the file descriptor for fstat.
+ */
+int uv__uring_stat(uv_loop_t* loop, uv_fs_t* req, int fd, const char* path) {
+  struct io_uring_sqe* sqe;
+  struct statx* stx;
+
+  stx = malloc(sizeof *stx);
+  if (stx == NULL) return -1;
+
+  sqe = uv__uring_get_sqe(loop, IORING_OP_STATX);
+  if (sqe == NULL) {
+    free(stx);
+    return -1;
+  }
+
+  if (path) {
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uintptr_t) path;
+    sqe->statx_flags = req->fs_type == UV_FS_LSTAT ? AT_SYMLINK_NOFOLLOW : 0;
+  } else {
+    sqe->fd = fd;
+    sqe->addr = (uintptr_t) "";
+    sqe->statx_flags = AT_EMPTY_PATH;
+  }
+  sqe->len = STATX_BASIC_STATS;
+  sqe->off = (uintptr_t) stx;
+
+  /* Picked up again in uv__uring_reap. */
+  req->ptr = stx;
+
+  uv__uring_queue(loop, req, sqe);
+  return 0;
+}
+
+
+void uv__uring_destroy(uv_loop_t* loop) {
+  struct uv__uring* u = loop->uring;
+
+  if (u == NULL) {
+    return;
+  }
+
+  ev_ref(loop->ev);
+  ev_prepare_stop(loop->ev, &u->prepare_watcher);
+  ev_ref(loop->ev);
+  ev_io_stop(loop->ev, &u->eventfd_watcher);
+  ev_timer_stop(loop->ev, &u->retry_watcher);
+
+  uv__uring_free(u);
+  loop->uring = NULL;
+}
+
+
+#else /* !UV__HAVE_IO_URING */
+
+int uv__uring_open(uv_loop_t* loop, uv_fs_t* req, const char* path, int flags,
+    int mode) {
+  return -1;
+}
+
+
+int uv__uring_close(uv_loop_t* loop, uv_fs_t* req, int fd) {
+  return -1;
+}
+
+
+int uv__uring_rw(uv_loop_t* loop, uv_fs_t* req, int fd, void* buf,
+    size_t length, off_t offset) {
+  return -1;
+}
+
+
+int uv__uring_fsync(uv_loop_t* loop, uv_fs_t* req, int fd, int datasync) {
+  return -1;
+}
+
+
+int uv__uring_stat(uv_loop_t* loop, uv_fs_t* req, int fd, const char* path) {
+  return -1;
+}
+
+
+void uv__uring_destroy(uv_loop_t* loop) {
+}
+
+#endif /* UV__HAVE_IO_URING */
@@ -40,6 +40,83 @@ uv_counters_t* uv_counters() {
 }
 
 
+#ifdef _WIN32
+# define uv__cas_ptr(p, old, new)                                            \
+  InterlockedCompareExchangePointer((PVOID volatile*) (p), (new), (old))
+#else
+# define uv__cas_ptr(p, old, new)                                            \
+  __sync_val_compare_and_swap((p), (old), (new))
+#endif
+
+
+static void uv__mpsc_async(uv_async_t* async, int status) {
+  uv_mpsc_t* mpsc = (uv_mpsc_t*) async;
+  uv_mpsc_node_t* nodes;
+
+  nodes = uv_mpsc_take(mpsc);
+
+  if (nodes && mpsc->mpsc_cb) {
+    mpsc->mpsc_cb(mpsc, nodes, status);
+  }
+}
+
+
+int uv_mpsc_init(uv_loop_t* loop, uv_mpsc_t* mpsc, uv_mpsc_cb mpsc_cb) {
+  mpsc->mpsc_cb = mpsc_cb;
+  mpsc->head = NULL;
+  return uv_async_init(loop, &mpsc->async, uv__mpsc_async);
+}
+
+
+int uv_mpsc_push(uv_mpsc_t* mpsc, uv_mpsc_node_t* node) {
+  uv_mpsc_node_t* head;
+  uv_mpsc_node_t* seen;
+
+  head = mpsc->head;
+  for (;;) {
+    node->next = head;
+    seen = uv__cas_ptr(&mpsc->head, head, node);
+    if (seen == head) break;
+    head = seen;
+  }
+
+  /* Only the push that makes the stack non-empty has to wake the loop; the
+   * callback takes everything pushed until it runs.
+   */
+  if (head == NULL) {
+    return uv_async_send(&mpsc->async);
+  }
+
+  return 0;
+}
+
+
+uv_mpsc_node_t* uv_mpsc_take(uv_mpsc_t* mpsc) {
+  uv_mpsc_node_t* head;
+  uv_mpsc_node_t* seen;
+  uv_mpsc_node_t* prev;
+  uv_mpsc_node_t* next;
+
+  head = mpsc->head;
+  while (head) {
+    seen = uv__cas_ptr(&mpsc->head, head, NULL);
+    if (seen == head) break;
+    head = seen;
+  }
+
+  /* The stack is newest first. */
+  prev = NULL;
+  while (head) {
+    next = head->next;
+    head->next = prev;
+    prev = head;
+    head = next;
+  }
+
+  return prev;
+}
+
+
 uv_buf_t uv_buf_init(char* base, size_t len) {
   uv_buf_t buf;
   buf.base = base;
@@ -87,6 +164,7 @@ const char* uv_err_name(uv_err_t err) {
     case UV_EPROTONOSUPPORT: return "EPROTONOSUPPORT";
     case UV_EPROTOTYPE: return "EPROTOTYPE";
     case UV_ETIMEDOUT: return "ETIMEDOUT";
+    case UV_ECANCELED: return "ECANCELED";
     default:
       assert(0);
       return NULL;
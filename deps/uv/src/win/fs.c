@@ -785,6 +785,12 @@ static DWORD WINAPI uv_fs_thread_proc(void* parameter) {
     case UV_FS_FCHOWN:
       fs__nop(req);
       break;
+    case UV_FS_CUSTOM:
+      req->work_cb(req);
+      if (req->result == -1) {
+        SET_REQ_RESULT_WIN32_ERROR(req, GetLastError());
+      }
+      break;
     default:
       assert(!"bad uv_fs_type");
   }
@@ -1000,6 +1006,17 @@ int uv_fs_fchown(uv_loop_t* loop, uv_fs_t* req, uv_file file, int uid,
 }
 
 
+int uv_fs_work(uv_loop_t* loop, uv_fs_t* req, uv_fs_cb work_cb, uv_fs_cb cb) {
+  assert(cb);
+
+  uv_fs_req_init_async(loop, req, UV_FS_CUSTOM, NULL, cb);
+  req->work_cb = work_cb;
+  QUEUE_FS_TP_JOB(loop, req);
+
+  return 0;
+}
+
+
 int uv_fs_stat(uv_loop_t* loop, uv_fs_t* req, const char* path, uv_fs_cb cb) {
   int len = strlen(path);
   char* path2 = NULL;
@@ -114,6 +114,33 @@ int uv_write(uv_write_t* req, uv_stream_t* handle, uv_buf_t bufs[], int bufcnt,
 }
 
 
+/* Writes are overlapped; always let the caller fall back to uv_write. */
+int uv_try_write(uv_stream_t* handle, uv_buf_t bufs[], int bufcnt) {
+  return 0;
+}
+
+
+/* Writes are overlapped and already batched by the system; corking is a
+ * no-op here.
+ */
+int uv_cork(uv_stream_t* handle) {
+  return 0;
+}
+
+
+int uv_uncork(uv_stream_t* handle) {
+  return 0;
+}
+
+
+/* There is no splice(2) equivalent for overlapped handles yet. */
+int uv_splice(uv_splice_t* req, uv_stream_t* src, uv_stream_t* dst,
+    uv_splice_cb cb) {
+  uv_set_error(src->loop, UV_ENOTSUP, 0);
+  return -1;
+}
+
+
 int uv_shutdown(uv_shutdown_t* req, uv_stream_t* handle, uv_shutdown_cb cb) {
   uv_loop_t* loop = handle->loop;
 
@@ -85,6 +85,14 @@ static int uv_tcp_set_socket(uv_loop_t* loop, uv_tcp_t* handle,
     }
   }
 
+  if (handle->flags & UV_HANDLE_TCP_NODELAY) {
+    if (setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (const char*) &yes,
+        sizeof yes) == SOCKET_ERROR) {
+      uv_set_sys_error(loop, WSAGetLastError());
+      return -1;
+    }
+  }
+
   handle->socket = socket;
 
   return 0;
@@ -191,6 +199,26 @@ static int uv__bind(uv_loop_t* loop, uv_tcp_t* handle, int domain,
 }
 
 
+int uv_tcp_nodelay(uv_tcp_t* handle, int enable) {
+  BOOL value = enable ? TRUE : FALSE;
+
+  if (handle->socket != INVALID_SOCKET &&
+      setsockopt(handle->socket, IPPROTO_TCP, TCP_NODELAY,
+                 (const char*) &value, sizeof value) == SOCKET_ERROR) {
+    uv_set_sys_error(handle->loop, WSAGetLastError());
+    return -1;
+  }
+
+  if (enable) {
+    handle->flags |= UV_HANDLE_TCP_NODELAY;
+  } else {
+    handle->flags &= ~UV_HANDLE_TCP_NODELAY;
+  }
+
+  return 0;
+}
+
+
 int uv_tcp_bind(uv_tcp_t* handle, struct sockaddr_in addr) {
   uv_loop_t* loop = handle->loop;
 
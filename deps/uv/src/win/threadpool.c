@@ -20,6 +20,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 
 #include "uv.h"
 #include "internal.h"
@@ -68,6 +69,37 @@ int uv_queue_work(uv_loop_t* loop, uv_work_t* req, uv_work_cb work_cb,
 
 void uv_process_work_req(uv_loop_t* loop, uv_work_t* req) {
   assert(req->after_work_cb);
-  req->after_work_cb(req);
+  req->after_work_cb(req, 0);
   uv_unref(loop);
 }
+
+
+/* Work requests go to the system thread pool, which sizes itself. */
+int uv_threadpool_set_size(uv_threadpool_type type, int threads) {
+  return -1;
+}
+
+
+int uv_threadpool_stats(uv_threadpool_type type,
+    uv_threadpool_stats_t* stats) {
+  memset(stats, 0, sizeof *stats);
+  return -1;
+}
+
+
+/* Neither the system thread pool nor the fs requests can be withdrawn. */
+int uv_cancel(uv_req_t* req) {
+  switch (req->type) {
+    case UV_FS:
+      uv_set_error(((uv_fs_t*) req)->loop, UV_ENOTSUP, 0);
+      return -1;
+
+    case UV_WORK:
+      uv_set_error(((uv_work_t*) req)->loop, UV_ENOTSUP, 0);
+      return -1;
+
+    default:
+      assert(0 && "request type can't be cancelled");
+      return -1;
+  }
+}
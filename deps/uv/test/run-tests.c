@@ -76,5 +76,11 @@ static int maybe_run_test(int argc, char **argv) {
     while (1) uv_sleep(10000);
   }
 
+  if (strcmp(argv[1], "spawn_helper5") == 0) {
+    const char* value = getenv("UV_SPAWN_ENV");
+    printf("%s\n", value ? value : "(unset)");
+    return 1;
+  }
+
   return run_test(argv[1], TEST_TIMEOUT, 0);
 }
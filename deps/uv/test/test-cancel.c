@@ -0,0 +1,215 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <stdlib.h>
+
+#ifndef _WIN32
+# include <unistd.h>
+#endif
+
+#define REQS 10
+
+static volatile int blocker_started;
+static volatile int blocker_release;
+
+static uv_work_t blocker_req;
+static uv_work_t work_reqs[REQS];
+static int work_cb_count;
+static int after_work_cb_count;
+static int cancelled_cb_count;
+
+static int pipefd[2];
+static uv_fs_t read_req;
+static uv_fs_t fs_reqs[REQS];
+static char read_buf[1];
+static int read_cb_count;
+static int fs_cb_count;
+static int fs_cancelled_count;
+
+
+static void blocker_cb(uv_work_t* req) {
+  blocker_started = 1;
+  while (!blocker_release) uv_sleep(1);
+}
+
+
+static void work_cb(uv_work_t* req) {
+  work_cb_count++;
+}
+
+
+static void after_work_cb(uv_work_t* req, int status) {
+  after_work_cb_count++;
+
+  if (status == -1) {
+    ASSERT(uv_last_error(uv_default_loop()).code == UV_ECANCELED);
+    cancelled_cb_count++;
+  } else {
+    ASSERT(status == 0);
+  }
+}
+
+
+TEST_IMPL(threadpool_cancel_work) {
+  int r;
+  int i;
+
+#ifdef _WIN32
+  /* uv_cancel is not supported on windows. */
+  return 0;
+#endif
+
+  uv_init();
+
+  r = uv_threadpool_set_size(UV_THREADPOOL_WORK, 1);
+  ASSERT(r == 0);
+
+  r = uv_queue_work(uv_default_loop(), &blocker_req, blocker_cb,
+      after_work_cb);
+  ASSERT(r == 0);
+
+  for (i = 0; i < REQS; i++) {
+    r = uv_queue_work(uv_default_loop(), &work_reqs[i], work_cb,
+        after_work_cb);
+    ASSERT(r == 0);
+  }
+
+  while (!blocker_started) uv_sleep(1);
+
+  /* Already running. */
+  r = uv_cancel((uv_req_t*) &blocker_req);
+  ASSERT(r == -1);
+  ASSERT(uv_last_error(uv_default_loop()).code == UV_EBUSY);
+
+  /* Every other one, from both ends and the middle of the queue. */
+  for (i = 0; i < REQS; i += 2) {
+    r = uv_cancel((uv_req_t*) &work_reqs[i]);
+    ASSERT(r == 0);
+  }
+
+  /* Twice doesn't work. */
+  r = uv_cancel((uv_req_t*) &work_reqs[0]);
+  ASSERT(r == -1);
+
+  blocker_release = 1;
+
+  r = uv_run(uv_default_loop());
+  ASSERT(r == 0);
+
+  ASSERT(work_cb_count == REQS / 2);
+  ASSERT(after_work_cb_count == REQS + 1);
+  ASSERT(cancelled_cb_count == REQS / 2);
+
+  return 0;
+}
+
+
+static void read_cb(uv_fs_t* req) {
+  ASSERT(req == &read_req);
+  ASSERT(req->result == 1);
+  read_cb_count++;
+  uv_fs_req_cleanup(req);
+}
+
+
+static void fs_cb(uv_fs_t* req) {
+  fs_cb_count++;
+
+  if (req->result == -1) {
+    ASSERT(req->errorno == UV_ECANCELED);
+    fs_cancelled_count++;
+  }
+
+  uv_fs_req_cleanup(req);
+}
+
+
+TEST_IMPL(fs_cancel) {
+  int r;
+  int i;
+
+#ifdef _WIN32
+  /* uv_cancel is not supported on windows. */
+  return 0;
+#else
+
+  /* The reads below have to go to libeio. */
+  setenv("UV_USE_IO_URING", "0", 1);
+
+  uv_init();
+
+  r = uv_threadpool_set_size(UV_THREADPOOL_IO, 1);
+  ASSERT(r == 0);
+
+  /* Keep libeio's only thread busy until the pipe is written to. */
+  r = pipe(pipefd);
+  ASSERT(r == 0);
+
+  r = uv_fs_read(uv_default_loop(), &read_req, pipefd[0], read_buf, 1, -1,
+      read_cb);
+  ASSERT(r == 0);
+
+  for (i = 0; i < REQS; i++) {
+    r = uv_fs_stat(uv_default_loop(), &fs_reqs[i], ".", fs_cb);
+    ASSERT(r == 0);
+  }
+
+  uv_sleep(100);
+
+  for (i = 0; i < REQS; i += 2) {
+    r = uv_cancel((uv_req_t*) &fs_reqs[i]);
+    ASSERT(r == 0);
+  }
+
+  /* Cancelling twice doesn't work. */
+  r = uv_cancel((uv_req_t*) &fs_reqs[0]);
+  ASSERT(r == -1);
+  ASSERT(uv_last_error(uv_default_loop()).code == UV_EBUSY);
+
+  /* Neither does cancelling the read the thread is blocked in. */
+  r = uv_cancel((uv_req_t*) &read_req);
+  ASSERT(r == -1);
+  ASSERT(uv_last_error(uv_default_loop()).code == UV_EBUSY);
+
+  r = write(pipefd[1], "x", 1);
+  ASSERT(r == 1);
+
+  r = uv_run(uv_default_loop());
+  ASSERT(r == 0);
+
+  /* Completed requests can't be cancelled. */
+  r = uv_cancel((uv_req_t*) &fs_reqs[1]);
+  ASSERT(r == -1);
+  ASSERT(uv_last_error(uv_default_loop()).code == UV_EBUSY);
+
+  ASSERT(read_cb_count == 1);
+  ASSERT(fs_cb_count == REQS);
+  ASSERT(fs_cancelled_count == REQS / 2);
+
+  close(pipefd[0]);
+  close(pipefd[1]);
+
+  return 0;
+#endif
+}
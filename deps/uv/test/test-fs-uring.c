@@ -0,0 +1,178 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* Runs the fs requests that src/unix/uring.c takes through the loop. Where
+ * io_uring isn't available they go to libeio and this is just another fs
+ * test.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/* More than the ring holds, so some of them have to fall back to libeio. */
+#define STAT_REQS 200
+
+static uv_loop_t* loop;
+static uv_file file;
+static uv_fs_t open_req;
+static uv_fs_t write_req;
+static uv_fs_t fsync_req;
+static uv_fs_t fstat_req;
+static uv_fs_t read_req;
+static uv_fs_t close_req;
+static uv_fs_t stat_reqs[STAT_REQS];
+
+static char data[] = "io_uring";
+static char buf[32];
+
+static int close_cb_count;
+static int stat_cb_count;
+
+
+static void stat_cb(uv_fs_t* req) {
+  struct stat* s;
+
+  ASSERT(req->fs_type == UV_FS_STAT);
+  ASSERT(req->result == 0);
+  s = req->ptr;
+  ASSERT(s->st_size == sizeof data);
+  uv_fs_req_cleanup(req);
+  stat_cb_count++;
+}
+
+
+static void close_cb(uv_fs_t* req) {
+  int r;
+  int i;
+
+  ASSERT(req == &close_req);
+  ASSERT(req->result == 0);
+  uv_fs_req_cleanup(req);
+  close_cb_count++;
+
+  for (i = 0; i < STAT_REQS; i++) {
+    r = uv_fs_stat(loop, &stat_reqs[i], "test_file", stat_cb);
+    ASSERT(r == 0);
+  }
+}
+
+
+static void read_cb(uv_fs_t* req) {
+  int r;
+
+  ASSERT(req == &read_req);
+  ASSERT(req->result == sizeof data);
+  ASSERT(memcmp(buf, data, sizeof data) == 0);
+  uv_fs_req_cleanup(req);
+
+  r = uv_fs_close(loop, &close_req, file, close_cb);
+  ASSERT(r == 0);
+}
+
+
+static void fstat_cb(uv_fs_t* req) {
+  struct stat* s;
+  int r;
+
+  ASSERT(req == &fstat_req);
+  ASSERT(req->result == 0);
+  s = req->ptr;
+  ASSERT(s->st_size == sizeof data);
+  ASSERT(S_ISREG(s->st_mode));
+  uv_fs_req_cleanup(req);
+
+  r = uv_fs_read(loop, &read_req, file, buf, sizeof buf, 0, read_cb);
+  ASSERT(r == 0);
+}
+
+
+static void fsync_cb(uv_fs_t* req) {
+  int r;
+
+  ASSERT(req == &fsync_req);
+  ASSERT(req->result == 0);
+  uv_fs_req_cleanup(req);
+
+  r = uv_fs_fstat(loop, &fstat_req, file, fstat_cb);
+  ASSERT(r == 0);
+}
+
+
+static void write_cb(uv_fs_t* req) {
+  int r;
+
+  ASSERT(req == &write_req);
+  ASSERT(req->result == sizeof data);
+  uv_fs_req_cleanup(req);
+
+  r = uv_fs_fdatasync(loop, &fsync_req, file, fsync_cb);
+  ASSERT(r == 0);
+}
+
+
+static void open_cb(uv_fs_t* req) {
+  int r;
+
+  ASSERT(req == &open_req);
+  ASSERT(req->result != -1);
+  file = req->result;
+  uv_fs_req_cleanup(req);
+
+  /* The flags go to the kernel as given; nobody asked for O_CLOEXEC. */
+  r = fcntl(file, F_GETFD);
+  ASSERT(r != -1);
+  ASSERT(!(r & FD_CLOEXEC));
+
+  r = uv_fs_write(loop, &write_req, file, data, sizeof data, 0, write_cb);
+  ASSERT(r == 0);
+}
+
+
+TEST_IMPL(fs_uring) {
+  int r;
+
+  unlink("test_file");
+
+  uv_init();
+  loop = uv_default_loop();
+
+  r = uv_fs_open(loop, &open_req, "test_file", O_RDWR | O_CREAT | O_TRUNC,
+      S_IWRITE | S_IREAD, open_cb);
+  ASSERT(r == 0);
+
+  uv_run(loop);
+
+  ASSERT(close_cb_count == 1);
+  ASSERT(stat_cb_count == STAT_REQS);
+
+  if (loop->uring_disabled) {
+    LOG("io_uring not available, used libeio\n");
+  }
+
+  unlink("test_file");
+
+  return 0;
+}
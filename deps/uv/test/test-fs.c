@@ -78,6 +78,8 @@ static int symlink_cb_count;
 static int readlink_cb_count;
 static int utime_cb_count;
 static int futime_cb_count;
+static int work_cb_count;
+static int after_work_cb_count;
 
 static uv_loop_t* loop;
 
@@ -1265,3 +1267,59 @@ TEST_IMPL(fs_futime) {
 
   return 0;
 }
+
+
+static void work_cb(uv_fs_t* req) {
+  work_cb_count++;
+
+  if (req->data == NULL) {
+    req->result = 42;
+    return;
+  }
+
+  req->result = -1;
+#ifdef _WIN32
+  SetLastError(ERROR_FILE_NOT_FOUND);
+#else
+  errno = ENOENT;
+#endif
+}
+
+
+static void after_work_cb(uv_fs_t* req) {
+  ASSERT(req->fs_type == UV_FS_CUSTOM);
+
+  if (req->data == NULL) {
+    ASSERT(req->result == 42);
+  } else {
+    ASSERT(req->result == -1);
+    ASSERT(req->errorno == UV_ENOENT);
+  }
+
+  after_work_cb_count++;
+  uv_fs_req_cleanup(req);
+}
+
+
+TEST_IMPL(fs_work) {
+  uv_fs_t ok_req;
+  uv_fs_t fail_req;
+  int r;
+
+  uv_init();
+  loop = uv_default_loop();
+
+  ok_req.data = NULL;
+  r = uv_fs_work(loop, &ok_req, work_cb, after_work_cb);
+  ASSERT(r == 0);
+
+  fail_req.data = &fail_req;
+  r = uv_fs_work(loop, &fail_req, work_cb, after_work_cb);
+  ASSERT(r == 0);
+
+  uv_run(loop);
+  ASSERT(work_cb_count == 2);
+  ASSERT(after_work_cb_count == 2);
+
+  return 0;
+}
@@ -24,6 +24,9 @@ TEST_DECLARE   (tcp_ping_pong_v6)
 TEST_DECLARE   (pipe_ping_pong)
 TEST_DECLARE   (delayed_accept)
 TEST_DECLARE   (tcp_writealot)
+TEST_DECLARE   (tcp_write_cork)
+TEST_DECLARE   (tcp_try_write)
+TEST_DECLARE   (tcp_splice)
 TEST_DECLARE   (tcp_bind_error_addrinuse)
 TEST_DECLARE   (tcp_bind_error_addrnotavail_1)
 TEST_DECLARE   (tcp_bind_error_addrnotavail_2)
@@ -59,6 +62,7 @@ TEST_DECLARE   (prepare_ref)
 TEST_DECLARE   (check_ref)
 TEST_DECLARE   (unref_in_prepare_cb)
 TEST_DECLARE   (async)
+TEST_DECLARE   (mpsc)
 TEST_DECLARE   (get_currentexe)
 TEST_DECLARE   (hrtime)
 TEST_DECLARE   (getaddrinfo_basic)
@@ -84,11 +88,19 @@ TEST_DECLARE   (fs_link)
 TEST_DECLARE   (fs_symlink)
 TEST_DECLARE   (fs_utime)
 TEST_DECLARE   (fs_futime)
+TEST_DECLARE   (fs_work)
 TEST_DECLARE   (threadpool_queue_work_simple)
+TEST_DECLARE   (threadpool_queue_work_many)
+TEST_DECLARE   (threadpool_cancel_work)
+TEST_DECLARE   (threadpool_cancel_many)
+TEST_DECLARE   (fs_cancel)
+TEST_DECLARE   (fs_uring)
 #ifdef _WIN32
 TEST_DECLARE   (spawn_detect_pipe_name_collisions_on_windows)
 TEST_DECLARE   (argument_escaping)
 TEST_DECLARE   (environment_creation)
+#else
+TEST_DECLARE   (spawn_path_from_env)
 #endif
 HELPER_DECLARE (tcp4_echo_server)
 HELPER_DECLARE (tcp6_echo_server)
@@ -110,6 +122,15 @@ TASK_LIST_START
   TEST_ENTRY  (tcp_writealot)
   TEST_HELPER (tcp_writealot, tcp4_echo_server)
 
+  TEST_ENTRY  (tcp_write_cork)
+  TEST_HELPER (tcp_write_cork, tcp4_echo_server)
+
+  TEST_ENTRY  (tcp_try_write)
+  TEST_HELPER (tcp_try_write, tcp4_echo_server)
+
+  TEST_ENTRY  (tcp_splice)
+  TEST_HELPER (tcp_splice, tcp4_echo_server)
+
   TEST_ENTRY  (tcp_bind_error_addrinuse)
   TEST_ENTRY  (tcp_bind_error_addrnotavail_1)
   TEST_ENTRY  (tcp_bind_error_addrnotavail_2)
@@ -159,6 +180,7 @@ TASK_LIST_START
   TEST_ENTRY  (loop_handles)
 
   TEST_ENTRY  (async)
+  TEST_ENTRY  (mpsc)
 
   TEST_ENTRY  (get_currentexe)
 
@@ -181,6 +203,8 @@ TASK_LIST_START
   TEST_ENTRY  (spawn_detect_pipe_name_collisions_on_windows)
   TEST_ENTRY  (argument_escaping)
   TEST_ENTRY  (environment_creation)
+#else
+  TEST_ENTRY  (spawn_path_from_env)
 #endif
 
   TEST_ENTRY  (fs_file_noent)
@@ -193,10 +217,16 @@ TASK_LIST_START
   TEST_ENTRY  (fs_chown)
   TEST_ENTRY  (fs_utime)
   TEST_ENTRY  (fs_futime)
+  TEST_ENTRY  (fs_work)
   TEST_ENTRY  (fs_symlink)
   TEST_ENTRY  (fs_symlink)
 
   TEST_ENTRY  (threadpool_queue_work_simple)
+  TEST_ENTRY  (threadpool_queue_work_many)
+  TEST_ENTRY  (threadpool_cancel_work)
+  TEST_ENTRY  (threadpool_cancel_many)
+  TEST_ENTRY  (fs_cancel)
+  TEST_ENTRY  (fs_uring)
 
 #if 0
   /* These are for testing the test runner. */
@@ -0,0 +1,119 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define THREADS 4
+#define ITEMS_PER_THREAD 10000
+
+typedef struct {
+  uv_mpsc_node_t node;
+  int thread;
+  int seq;
+} item_t;
+
+static uv_mpsc_t mpsc_handle;
+
+static item_t items[THREADS][ITEMS_PER_THREAD];
+static int next_seq[THREADS];
+static int received = 0;
+static int mpsc_cb_called = 0;
+static int close_cb_called = 0;
+
+
+static void producer_entry(void* arg) {
+  int thread = (int) (intptr_t) arg;
+  int i;
+
+  for (i = 0; i < ITEMS_PER_THREAD; i++) {
+    items[thread][i].thread = thread;
+    items[thread][i].seq = i;
+    ASSERT(0 == uv_mpsc_push(&mpsc_handle, &items[thread][i].node));
+  }
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void mpsc_cb(uv_mpsc_t* handle, uv_mpsc_node_t* nodes, int status) {
+  item_t* item;
+
+  ASSERT(handle == &mpsc_handle);
+  ASSERT(status == 0);
+  ASSERT(nodes != NULL);
+
+  mpsc_cb_called++;
+
+  while (nodes) {
+    item = (item_t*) ((char*) nodes - offsetof(item_t, node));
+    nodes = nodes->next;
+
+    /* Each producer's items arrive in the order they were pushed. */
+    ASSERT(item->seq == next_seq[item->thread]);
+    next_seq[item->thread]++;
+    received++;
+  }
+
+  if (received == THREADS * ITEMS_PER_THREAD) {
+    uv_close((uv_handle_t*) &mpsc_handle, close_cb);
+  }
+}
+
+
+TEST_IMPL(mpsc) {
+  uintptr_t threads[THREADS];
+  int i;
+  int r;
+
+  uv_init();
+
+  r = uv_mpsc_init(uv_default_loop(), &mpsc_handle, mpsc_cb);
+  ASSERT(r == 0);
+
+  for (i = 0; i < THREADS; i++) {
+    threads[i] = uv_create_thread(producer_entry, (void*) (intptr_t) i);
+    ASSERT(threads[i] != 0);
+  }
+
+  r = uv_run(uv_default_loop());
+  ASSERT(r == 0);
+
+  for (i = 0; i < THREADS; i++) {
+    r = uv_wait_thread(threads[i]);
+    ASSERT(r == 0);
+  }
+
+  printf("%d items in %d callbacks\n", received, mpsc_cb_called);
+
+  ASSERT(received == THREADS * ITEMS_PER_THREAD);
+  ASSERT(mpsc_cb_called <= received);
+  ASSERT(uv_mpsc_take(&mpsc_handle) == NULL);
+  ASSERT(close_cb_called == 1);
+
+  return 0;
+}
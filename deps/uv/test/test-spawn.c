@@ -228,6 +228,56 @@ TEST_IMPL(spawn_and_kill) {
 }
 
 
+#ifndef _WIN32
+/* The executable is looked up in the PATH of the environment passed in,
+ * and the parent's environment is left as it was.
+ */
+TEST_IMPL(spawn_path_from_env) {
+  int r;
+  uv_pipe_t out;
+  char path[1100];
+  char* env[3];
+  char* slash;
+
+  uv_init();
+
+  init_process_options("spawn_helper5", exit_cb);
+
+  slash = strrchr(exepath, '/');
+  ASSERT(slash != NULL);
+  *slash = '\0';
+  snprintf(path, sizeof path, "PATH=/nonexistent:%s", exepath);
+  *slash = '/';
+
+  options.file = slash + 1;
+  env[0] = path;
+  env[1] = "UV_SPAWN_ENV=from-spawn";
+  env[2] = NULL;
+  options.env = env;
+
+  uv_pipe_init(uv_default_loop(), &out);
+  options.stdout_stream = &out;
+
+  r = uv_spawn(uv_default_loop(), &process, options);
+  ASSERT(r == 0);
+  ASSERT(getenv("UV_SPAWN_ENV") == NULL);
+
+  r = uv_read_start((uv_stream_t*) &out, on_alloc, on_read);
+  ASSERT(r == 0);
+
+  r = uv_run(uv_default_loop());
+  ASSERT(r == 0);
+
+  ASSERT(exit_cb_called == 1);
+  ASSERT(close_cb_called == 2); /* Once for process once for the pipe. */
+  printf("output is: %s", output);
+  ASSERT(strcmp("from-spawn\n", output) == 0);
+
+  return 0;
+}
+#endif
+
+
 #ifdef _WIN32
 TEST_IMPL(spawn_detect_pipe_name_collisions_on_windows) {
   int r;
@@ -0,0 +1,207 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Data written by `client` arrives on `incoming`, which is spliced to `echo`.
+ * The echo server sends it back and it is read from `echo`.
+ */
+
+#define TOTAL_BYTES (1024 * 1024)
+#define WRITE_SIZE (64 * 1024)
+
+static uv_tcp_t server;
+static uv_tcp_t incoming;
+static uv_tcp_t client;
+static uv_tcp_t echo;
+static uv_connect_t client_connect_req;
+static uv_connect_t echo_connect_req;
+static uv_shutdown_t client_shutdown_req;
+static uv_shutdown_t echo_shutdown_req;
+static uv_write_t write_reqs[TOTAL_BYTES / WRITE_SIZE];
+static uv_splice_t splice_req;
+static char send_buffer[WRITE_SIZE];
+
+static int connected = 0;
+static int splice_cb_called = 0;
+static int close_cb_called = 0;
+static int bytes_echoed = 0;
+
+
+static uv_buf_t alloc_cb(uv_handle_t* handle, size_t size) {
+  uv_buf_t buf;
+  buf.base = (char*)malloc(size);
+  buf.len = size;
+  return buf;
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  close_cb_called++;
+}
+
+
+static void echo_read_cb(uv_stream_t* stream, ssize_t nread, uv_buf_t buf) {
+  ssize_t i;
+
+  if (nread == -1) {
+    ASSERT(uv_last_error(uv_default_loop()).code == UV_EOF);
+    uv_close((uv_handle_t*)stream, close_cb);
+  }
+
+  for (i = 0; i < nread; i++) {
+    ASSERT(buf.base[i] == (char)((bytes_echoed + i) % WRITE_SIZE));
+  }
+
+  if (nread > 0) {
+    bytes_echoed += nread;
+  }
+
+  free(buf.base);
+}
+
+
+static void splice_cb(uv_splice_t* req, int status) {
+  int r;
+
+  ASSERT(req == &splice_req);
+  ASSERT(status == 0);
+  ASSERT(req->bytes == TOTAL_BYTES);
+  splice_cb_called++;
+
+  uv_close((uv_handle_t*)&incoming, close_cb);
+  uv_close((uv_handle_t*)&server, close_cb);
+
+  r = uv_shutdown(&echo_shutdown_req, (uv_stream_t*)&echo, NULL);
+  ASSERT(r == 0);
+}
+
+
+static void start_splice() {
+  uv_buf_t buf;
+  int i, r;
+
+  r = uv_splice(&splice_req, (uv_stream_t*)&incoming, (uv_stream_t*)&echo,
+      splice_cb);
+  ASSERT(r == 0);
+
+  /* Either end can only be in one splice at a time. */
+  r = uv_splice(&splice_req, (uv_stream_t*)&incoming, (uv_stream_t*)&echo,
+      splice_cb);
+  ASSERT(r == -1);
+  ASSERT(uv_last_error(uv_default_loop()).code == UV_EBUSY);
+
+  r = uv_read_start((uv_stream_t*)&echo, alloc_cb, echo_read_cb);
+  ASSERT(r == 0);
+
+  buf = uv_buf_init(send_buffer, sizeof send_buffer);
+  for (i = 0; i < TOTAL_BYTES / WRITE_SIZE; i++) {
+    r = uv_write(&write_reqs[i], (uv_stream_t*)&client, &buf, 1, NULL);
+    ASSERT(r == 0);
+  }
+
+  r = uv_shutdown(&client_shutdown_req, (uv_stream_t*)&client, NULL);
+  ASSERT(r == 0);
+}
+
+
+static void client_close_when_done(uv_stream_t* stream, ssize_t nread,
+    uv_buf_t buf) {
+  /* The server side never writes; this only sees the EOF. */
+  ASSERT(nread <= 0);
+  free(buf.base);
+
+  if (nread == -1) {
+    uv_close((uv_handle_t*)stream, close_cb);
+  }
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  ASSERT(status == 0);
+
+  if (req == &client_connect_req) {
+    uv_read_start((uv_stream_t*)&client, alloc_cb, client_close_when_done);
+  }
+
+  if (++connected == 3) {
+    start_splice();
+  }
+}
+
+
+static void connection_cb(uv_stream_t* stream, int status) {
+  int r;
+
+  ASSERT(status == 0);
+
+  r = uv_tcp_init(uv_default_loop(), &incoming);
+  ASSERT(r == 0);
+
+  r = uv_accept(stream, (uv_stream_t*)&incoming);
+  ASSERT(r == 0);
+
+  if (++connected == 3) {
+    start_splice();
+  }
+}
+
+
+TEST_IMPL(tcp_splice) {
+  struct sockaddr_in server_addr = uv_ip4_addr("127.0.0.1", TEST_PORT_2);
+  struct sockaddr_in echo_addr = uv_ip4_addr("127.0.0.1", TEST_PORT);
+  int i, r;
+
+  uv_init();
+
+  for (i = 0; i < WRITE_SIZE; i++) {
+    send_buffer[i] = (char)i;
+  }
+
+  r = uv_tcp_init(uv_default_loop(), &server);
+  ASSERT(r == 0);
+  r = uv_tcp_bind(&server, server_addr);
+  ASSERT(r == 0);
+  r = uv_listen((uv_stream_t*)&server, 128, connection_cb);
+  ASSERT(r == 0);
+
+  r = uv_tcp_init(uv_default_loop(), &client);
+  ASSERT(r == 0);
+  r = uv_tcp_connect(&client_connect_req, &client, server_addr, connect_cb);
+  ASSERT(r == 0);
+
+  r = uv_tcp_init(uv_default_loop(), &echo);
+  ASSERT(r == 0);
+  r = uv_tcp_connect(&echo_connect_req, &echo, echo_addr, connect_cb);
+  ASSERT(r == 0);
+
+  uv_run(uv_default_loop());
+
+  ASSERT(splice_cb_called == 1);
+  ASSERT(bytes_echoed == TOTAL_BYTES);
+  ASSERT(close_cb_called == 4);
+
+  return 0;
+}
@@ -0,0 +1,137 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+static uv_tcp_t client;
+static uv_connect_t connect_req;
+static uv_write_t write_req;
+static char recv_buffer[64];
+
+static int connect_cb_called = 0;
+static int write_cb_called = 0;
+static int close_cb_called = 0;
+static int bytes_received = 0;
+
+
+static uv_buf_t alloc_cb(uv_handle_t* handle, size_t size) {
+  uv_buf_t buf;
+  buf.base = (char*)malloc(size);
+  buf.len = size;
+  return buf;
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  ASSERT(handle == (uv_handle_t*)&client);
+  close_cb_called++;
+}
+
+
+static void read_cb(uv_stream_t* tcp, ssize_t nread, uv_buf_t buf) {
+  ASSERT(nread >= 0);
+
+  if (nread > 0) {
+    ASSERT(bytes_received + nread <= (int)sizeof recv_buffer);
+    memcpy(recv_buffer + bytes_received, buf.base, nread);
+    bytes_received += nread;
+  }
+
+  free(buf.base);
+
+  if (bytes_received == 16) {
+    uv_close((uv_handle_t*)tcp, close_cb);
+  }
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(req == &write_req);
+  ASSERT(status == 0);
+  write_cb_called++;
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  uv_stream_t* stream = req->handle;
+  uv_buf_t bufs[2];
+  int r;
+
+  ASSERT(req == &connect_req);
+  ASSERT(status == 0);
+  connect_cb_called++;
+
+  bufs[0].base = "hello ";
+  bufs[0].len = 6;
+  bufs[1].base = "world";
+  bufs[1].len = 5;
+
+  /* An idle socket takes it all at once. */
+  r = uv_try_write(stream, bufs, 2);
+  ASSERT(r == 11);
+
+  /* Nothing is written ahead of queued data. */
+  uv_cork(stream);
+
+  bufs[0].base = "12345";
+  bufs[0].len = 5;
+  r = uv_write(&write_req, stream, bufs, 1, write_cb);
+  ASSERT(r == 0);
+
+  bufs[0].base = "xxxxx";
+  bufs[0].len = 5;
+  r = uv_try_write(stream, bufs, 1);
+  ASSERT(r == 0);
+
+  uv_uncork(stream);
+
+  r = uv_read_start(stream, alloc_cb, read_cb);
+  ASSERT(r == 0);
+}
+
+
+TEST_IMPL(tcp_try_write) {
+  struct sockaddr_in addr = uv_ip4_addr("127.0.0.1", TEST_PORT);
+  int r;
+
+  uv_init();
+
+  r = uv_tcp_init(uv_default_loop(), &client);
+  ASSERT(r == 0);
+
+  r = uv_tcp_connect(&connect_req, &client, addr, connect_cb);
+  ASSERT(r == 0);
+
+  uv_run(uv_default_loop());
+
+  ASSERT(connect_cb_called == 1);
+  ASSERT(write_cb_called == 1);
+  ASSERT(close_cb_called == 1);
+  ASSERT(bytes_received == 16);
+  ASSERT(memcmp(recv_buffer, "hello world12345", 16) == 0);
+
+  return 0;
+}
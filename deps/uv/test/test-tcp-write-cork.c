@@ -0,0 +1,151 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* More writes than fit in one writev, so uv_uncork has to loop. */
+#define WRITES      2500
+#define CHUNK_SIZE  8
+
+#define TOTAL_BYTES (WRITES * CHUNK_SIZE)
+
+
+static uv_tcp_t client;
+static uv_connect_t connect_req;
+static uv_write_t write_reqs[WRITES];
+static char send_buffer[TOTAL_BYTES];
+static char recv_buffer[TOTAL_BYTES];
+
+static int connect_cb_called = 0;
+static int write_cb_called = 0;
+static int close_cb_called = 0;
+static int bytes_received = 0;
+
+
+static uv_buf_t alloc_cb(uv_handle_t* handle, size_t size) {
+  uv_buf_t buf;
+  buf.base = (char*)malloc(size);
+  buf.len = size;
+  return buf;
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  ASSERT(handle == (uv_handle_t*)&client);
+  close_cb_called++;
+}
+
+
+static void read_cb(uv_stream_t* tcp, ssize_t nread, uv_buf_t buf) {
+  ASSERT(tcp == (uv_stream_t*)&client);
+  ASSERT(nread >= 0);
+
+  if (nread > 0) {
+    ASSERT(bytes_received + nread <= TOTAL_BYTES);
+    memcpy(recv_buffer + bytes_received, buf.base, nread);
+    bytes_received += nread;
+  }
+
+  free(buf.base);
+
+  if (bytes_received == TOTAL_BYTES) {
+    uv_close((uv_handle_t*)tcp, close_cb);
+  }
+}
+
+
+static void write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+
+  /* Callbacks come in the order the writes were queued. */
+  ASSERT(req == &write_reqs[write_cb_called]);
+  write_cb_called++;
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  uv_stream_t* stream = req->handle;
+  uv_buf_t buf;
+  int i, r;
+
+  ASSERT(req == &connect_req);
+  ASSERT(status == 0);
+  connect_cb_called++;
+
+  r = uv_tcp_nodelay(&client, 1);
+  ASSERT(r == 0);
+
+  r = uv_cork(stream);
+  ASSERT(r == 0);
+
+  for (i = 0; i < WRITES; i++) {
+    buf.base = send_buffer + i * CHUNK_SIZE;
+    buf.len = CHUNK_SIZE;
+    r = uv_write(&write_reqs[i], stream, &buf, 1, write_cb);
+    ASSERT(r == 0);
+  }
+
+  /* Nothing goes out while corked. */
+  ASSERT(stream->write_queue_size == TOTAL_BYTES);
+
+  r = uv_uncork(stream);
+  ASSERT(r == 0);
+
+  /* Small enough to fit in the socket buffer in one go. */
+  ASSERT(stream->write_queue_size == 0);
+  ASSERT(write_cb_called == 0);
+
+  r = uv_read_start(stream, alloc_cb, read_cb);
+  ASSERT(r == 0);
+}
+
+
+TEST_IMPL(tcp_write_cork) {
+  struct sockaddr_in addr = uv_ip4_addr("127.0.0.1", TEST_PORT);
+  int i, r;
+
+  for (i = 0; i < TOTAL_BYTES; i++) {
+    send_buffer[i] = 'a' + i % 26;
+  }
+
+  uv_init();
+
+  r = uv_tcp_init(uv_default_loop(), &client);
+  ASSERT(r == 0);
+
+  r = uv_tcp_connect(&connect_req, &client, addr, connect_cb);
+  ASSERT(r == 0);
+
+  uv_run(uv_default_loop());
+
+  ASSERT(connect_cb_called == 1);
+  ASSERT(write_cb_called == WRITES);
+  ASSERT(close_cb_called == 1);
+  ASSERT(bytes_received == TOTAL_BYTES);
+  ASSERT(memcmp(send_buffer, recv_buffer, TOTAL_BYTES) == 0);
+
+  return 0;
+}
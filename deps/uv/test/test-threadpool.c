@@ -35,8 +35,9 @@ static void work_cb(uv_work_t* req) {
 }
 
 
-static void after_work_cb(uv_work_t* req) {
+static void after_work_cb(uv_work_t* req, int status) {
   ASSERT(req == &work_req);
+  ASSERT(status == 0);
   ASSERT(req->data == &data);
   after_work_cb_count++;
 }
@@ -57,3 +58,160 @@ TEST_IMPL(threadpool_queue_work_simple) {
 
   return 0;
 }
+
+
+#define MANY_REQS 1000
+
+static uv_work_t many_reqs[MANY_REQS];
+static volatile int many_work_count;
+static volatile int many_after_count;
+static int short_after_long;
+
+
+static void many_work_cb(uv_work_t* req) {
+  if (req == &many_reqs[0]) {
+    /* Holds its thread until every other request has been run and handed
+     * back to the loop, which the other threads can only do by taking the
+     * requests queued behind this one. Its own callback has to come last.
+     */
+    while (many_after_count < MANY_REQS - 1) {
+      uv_sleep(1);
+    }
+  }
+  __sync_fetch_and_add(&many_work_count, 1);
+}
+
+
+static void many_after_work_cb(uv_work_t* req, int status) {
+  ASSERT(status == 0);
+  if (req == &many_reqs[0]) {
+    short_after_long = many_after_count;
+  }
+  many_after_count++;
+}
+
+
+TEST_IMPL(threadpool_queue_work_many) {
+  uv_threadpool_stats_t stats;
+  int i;
+  int r;
+
+  uv_init();
+
+  r = uv_threadpool_set_size(UV_THREADPOOL_WORK, 0);
+  ASSERT(r == -1);
+  r = uv_threadpool_set_size(UV_THREADPOOL_WORK, 4);
+  ASSERT(r == 0);
+
+  for (i = 0; i < MANY_REQS; i++) {
+    r = uv_queue_work(uv_default_loop(), &many_reqs[i], many_work_cb,
+        many_after_work_cb);
+    ASSERT(r == 0);
+  }
+
+  /* Started threads can't be taken away. */
+  r = uv_threadpool_set_size(UV_THREADPOOL_WORK, 2);
+  ASSERT(r == -1);
+
+  uv_run(uv_default_loop());
+
+  ASSERT(many_work_count == MANY_REQS);
+  ASSERT(many_after_count == MANY_REQS);
+  ASSERT(short_after_long == MANY_REQS - 1);
+
+  r = uv_threadpool_stats(UV_THREADPOOL_WORK, &stats);
+  ASSERT(r == 0);
+  ASSERT(stats.threads == 4);
+  ASSERT(stats.queued == 0);
+  ASSERT(stats.active == 0);
+  ASSERT(stats.completed == MANY_REQS);
+
+  return 0;
+}
+
+
+#define CANCEL_THREADS 4
+#define CANCEL_REQS 100
+
+static uv_work_t cancel_blockers[CANCEL_THREADS];
+static uv_work_t cancel_reqs[CANCEL_REQS];
+static volatile int cancel_blockers_started;
+static volatile int cancel_release;
+static volatile int cancel_work_count;
+static int cancel_after_count;
+static int cancel_cancelled_count;
+
+
+static void cancel_blocker_cb(uv_work_t* req) {
+  __sync_fetch_and_add(&cancel_blockers_started, 1);
+  while (!cancel_release) uv_sleep(1);
+}
+
+
+static void cancel_work_cb(uv_work_t* req) {
+  __sync_fetch_and_add(&cancel_work_count, 1);
+}
+
+
+static void cancel_after_work_cb(uv_work_t* req, int status) {
+  if (status == -1) {
+    ASSERT(uv_last_error(uv_default_loop()).code == UV_ECANCELED);
+    cancel_cancelled_count++;
+  } else {
+    ASSERT(status == 0);
+  }
+  cancel_after_count++;
+}
+
+
+TEST_IMPL(threadpool_cancel_many) {
+  int i;
+  int r;
+
+#ifdef _WIN32
+  /* uv_cancel is not supported on windows. */
+  return 0;
+#endif
+
+  uv_init();
+
+  r = uv_threadpool_set_size(UV_THREADPOOL_WORK, CANCEL_THREADS);
+  ASSERT(r == 0);
+
+  /* One blocker per thread; they land in different queues round-robin. */
+  for (i = 0; i < CANCEL_THREADS; i++) {
+    r = uv_queue_work(uv_default_loop(), &cancel_blockers[i],
+        cancel_blocker_cb, cancel_after_work_cb);
+    ASSERT(r == 0);
+  }
+
+  while (cancel_blockers_started < CANCEL_THREADS) uv_sleep(1);
+
+  for (i = 0; i < CANCEL_REQS; i++) {
+    r = uv_queue_work(uv_default_loop(), &cancel_reqs[i], cancel_work_cb,
+        cancel_after_work_cb);
+    ASSERT(r == 0);
+  }
+
+  /* Every thread is busy, so nothing can have been taken from any queue. */
+  for (i = 0; i < CANCEL_REQS; i++) {
+    r = uv_cancel((uv_req_t*) &cancel_reqs[i]);
+    ASSERT(r == 0);
+  }
+
+  cancel_release = 1;
+
+  r = uv_run(uv_default_loop());
+  ASSERT(r == 0);
+
+  ASSERT(cancel_work_count == 0);
+  ASSERT(cancel_cancelled_count == CANCEL_REQS);
+  ASSERT(cancel_after_count == CANCEL_REQS + CANCEL_THREADS);
+
+  /* Finished requests can't be cancelled. */
+  r = uv_cancel((uv_req_t*) &cancel_blockers[0]);
+  ASSERT(r == -1);
+  ASSERT(uv_last_error(uv_default_loop()).code == UV_EBUSY);
+
+  return 0;
+}
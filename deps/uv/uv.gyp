@@ -149,6 +149,8 @@
             'src/unix/tcp.c',
             'src/unix/pipe.c',
             'src/unix/stream.c',
+            'src/unix/uring.c',
+            'src/unix/threadpool.c',
             'src/unix/cares.c',
             'src/unix/error.c',
             'src/unix/process.c',
@@ -225,10 +227,12 @@
         'test/task.h',
         'test/test-async.c',
         'test/test-callback-stack.c',
+        'test/test-cancel.c',
         'test/test-connection-fail.c',
         'test/test-delayed-accept.c',
         'test/test-fail-always.c',
         'test/test-fs.c',
+        'test/test-fs-uring.c',
         'test/test-get-currentexe.c',
         'test/test-getaddrinfo.c',
         'test/test-gethostbyname.c',
@@ -237,6 +241,7 @@
         'test/test-idle.c',
         'test/test-list.h',
         'test/test-loop-handles.c',
+        'test/test-mpsc.c',
         'test/test-pass-always.c',
         'test/test-ping-pong.c',
         'test/test-pipe-bind-error.c',
@@ -246,6 +251,9 @@
         'test/test-tcp-bind-error.c',
         'test/test-tcp-bind6-error.c',
         'test/test-tcp-writealot.c',
+        'test/test-tcp-write-cork.c',
+        'test/test-tcp-try-write.c',
+        'test/test-tcp-splice.c',
         'test/test-threadpool.c',
         'test/test-timer-again.c',
         'test/test-timer.c',
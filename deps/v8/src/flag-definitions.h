@@ -490,6 +490,9 @@ DEFINE_bool(sliding_state_window, false,
             "Update sliding state window counters.")
 DEFINE_string(logfile, "v8.log", "Specify the name of the log file.")
 DEFINE_bool(ll_prof, false, "Enable low-level linux profiler.")
+DEFINE_bool(perf_basic_prof, false,
+            "Write a perf map of generated code to /tmp/perf-<pid>.map "
+            "(implies --never-compact).")
 
 //
 // Disassembler only flags
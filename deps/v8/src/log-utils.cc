@@ -41,6 +41,7 @@ Log::Log(Logger* logger)
   : is_stopped_(false),
     output_handle_(NULL),
     ll_output_handle_(NULL),
+    perf_output_handle_(NULL),
     mutex_(NULL),
     message_buffer_(NULL),
     logger_(logger) {
@@ -78,6 +79,10 @@ void Log::Initialize() {
     FLAG_prof_auto = false;
   }
 
+  // The perf map lives apart from the log file, perf(1) looks for it in a
+  // fixed place.
+  if (FLAG_perf_basic_prof) OpenPerfMap();
+
   bool open_log_file = FLAG_log || FLAG_log_runtime || FLAG_log_api
       || FLAG_log_code || FLAG_log_gc || FLAG_log_handles || FLAG_log_suspect
       || FLAG_log_regexp || FLAG_log_state_changes || FLAG_ll_prof;
@@ -135,6 +140,14 @@ void Log::Initialize() {
 }
 
 
+void Log::OpenPerfMap() {
+  ASSERT(perf_output_handle_ == NULL);
+  ScopedVector<char> name(64);
+  OS::SNPrintF(name, "/tmp/perf-%d.map", OS::GetCurrentProcessId());
+  perf_output_handle_ = OS::FOpen(name.start(), OS::LogFileOpenMode);
+}
+
+
 void Log::OpenStdout() {
   ASSERT(!IsEnabled());
   output_handle_ = stdout;
@@ -182,6 +195,8 @@ FILE* Log::Close() {
   output_handle_ = NULL;
   if (ll_output_handle_ != NULL) fclose(ll_output_handle_);
   ll_output_handle_ = NULL;
+  if (perf_output_handle_ != NULL) fclose(perf_output_handle_);
+  perf_output_handle_ = NULL;
 
   DeleteArray(message_buffer_);
   message_buffer_ = NULL;
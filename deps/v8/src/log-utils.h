@@ -54,6 +54,11 @@ class Log {
     return !is_stopped_ && output_handle_ != NULL;
   }
 
+  // Returns whether the perf map is being written.
+  bool IsPerfEnabled() {
+    return perf_output_handle_ != NULL;
+  }
+
   // Size of buffer used for formatting log messages.
   static const int kMessageBufferSize = 2048;
 
@@ -67,6 +72,9 @@ class Log {
   // Opens stdout for logging.
   void OpenStdout();
 
+  // Opens /tmp/perf-<pid>.map for the perf map.
+  void OpenPerfMap();
+
   // Opens file for logging.
   void OpenFile(const char* name);
 
@@ -93,6 +101,9 @@ class Log {
   // Used when low-level profiling is active.
   FILE* ll_output_handle_;
 
+  // Used when the perf map is being written (--perf-basic-prof).
+  FILE* perf_output_handle_;
+
   // mutex_ is a Mutex used for enforcing exclusive
   // access to the formatting buffer and the log file or log memory buffer.
   Mutex* mutex_;
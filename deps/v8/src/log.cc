@@ -861,8 +861,8 @@ void Logger::SetterCallbackEvent(String* name, Address entry_point) {
 void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              Code* code,
                              const char* comment) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || FLAG_perf_basic_prof || Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -871,6 +871,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (FLAG_perf_basic_prof) {
+    PerfBasicCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
@@ -896,8 +899,8 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
 void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              Code* code,
                              String* name) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || FLAG_perf_basic_prof || Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -906,6 +909,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (FLAG_perf_basic_prof) {
+    PerfBasicCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
@@ -937,8 +943,8 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              Code* code,
                              SharedFunctionInfo* shared,
                              String* name) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || FLAG_perf_basic_prof || Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -948,6 +954,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (FLAG_perf_basic_prof) {
+    PerfBasicCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
@@ -978,8 +987,8 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
                              Code* code,
                              SharedFunctionInfo* shared,
                              String* source, int line) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || FLAG_perf_basic_prof || Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -993,6 +1002,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (FLAG_perf_basic_prof) {
+    PerfBasicCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
@@ -1019,8 +1031,8 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag,
 
 
 void Logger::CodeCreateEvent(LogEventsAndTags tag, Code* code, int args_count) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || FLAG_perf_basic_prof || Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[tag]);
     name_buffer_->AppendByte(':');
@@ -1029,6 +1041,9 @@ void Logger::CodeCreateEvent(LogEventsAndTags tag, Code* code, int args_count) {
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (FLAG_perf_basic_prof) {
+    PerfBasicCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
@@ -1052,8 +1067,8 @@ void Logger::CodeMovingGCEvent() {
 
 
 void Logger::RegExpCodeCreateEvent(Code* code, String* source) {
-  if (!log_->IsEnabled()) return;
-  if (FLAG_ll_prof || Serializer::enabled()) {
+  if (!log_->IsEnabled() && !log_->IsPerfEnabled()) return;
+  if (FLAG_ll_prof || FLAG_perf_basic_prof || Serializer::enabled()) {
     name_buffer_->Reset();
     name_buffer_->AppendBytes(kLogEventsNames[REG_EXP_TAG]);
     name_buffer_->AppendByte(':');
@@ -1062,6 +1077,9 @@ void Logger::RegExpCodeCreateEvent(Code* code, String* source) {
   if (FLAG_ll_prof) {
     LowLevelCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
   }
+  if (FLAG_perf_basic_prof) {
+    PerfBasicCodeCreateEvent(code, name_buffer_->get(), name_buffer_->size());
+  }
   if (Serializer::enabled()) {
     RegisterSnapshotCodeName(code, name_buffer_->get(), name_buffer_->size());
   }
@@ -1389,7 +1407,7 @@ static int EnumerateCompiledFunctions(Handle<SharedFunctionInfo>* sfis,
 
 
 void Logger::LogCodeObject(Object* object) {
-  if (FLAG_log_code || FLAG_ll_prof) {
+  if (FLAG_log_code || FLAG_ll_prof || FLAG_perf_basic_prof) {
     Code* code_object = Code::cast(object);
     LogEventsAndTags tag = Logger::STUB_TAG;
     const char* description = "Unknown code from the snapshot";
@@ -1485,6 +1503,20 @@ void Logger::LowLevelCodeCreateEvent(Code* code,
 }
 
 
+void Logger::PerfBasicCodeCreateEvent(Code* code,
+                                      const char* name,
+                                      int name_size) {
+  if (log_->perf_output_handle_ == NULL) return;
+  OS::FPrint(log_->perf_output_handle_,
+             "%" V8PRIxPTR " %x %.*s\n",
+             reinterpret_cast<uintptr_t>(code->instruction_start()),
+             code->instruction_size(),
+             name_size,
+             name);
+  fflush(log_->perf_output_handle_);
+}
+
+
 void Logger::LowLevelCodeMoveEvent(Address from, Address to) {
   if (log_->ll_output_handle_ == NULL) return;
   LowLevelCodeMoveStruct event;
@@ -1623,6 +1655,12 @@ bool Logger::Setup() {
     FLAG_prof_auto = false;
   }
 
+  // --perf-basic-prof implies --never-compact. The perf map has no way to
+  // say that code has moved, so code must stay where it was created.
+  if (FLAG_perf_basic_prof) {
+    FLAG_never_compact = true;
+  }
+
   // TODO(isolates): this assert introduces cyclic dependency (logger
   // -> thread local top -> heap -> logger).
   // ASSERT(VMState::is_outermost_external());
@@ -1640,7 +1678,8 @@ bool Logger::Setup() {
 
   bool start_logging = FLAG_log || FLAG_log_runtime || FLAG_log_api
     || FLAG_log_code || FLAG_log_gc || FLAG_log_handles || FLAG_log_suspect
-    || FLAG_log_regexp || FLAG_log_state_changes || FLAG_ll_prof;
+    || FLAG_log_regexp || FLAG_log_state_changes || FLAG_ll_prof
+    || FLAG_perf_basic_prof;
 
   if (start_logging) {
     logging_nesting_ = 1;
@@ -333,6 +333,8 @@ class Logger {
 
   void LowLevelCodeCreateEvent(Code* code, const char* name, int name_size);
 
+  void PerfBasicCodeCreateEvent(Code* code, const char* name, int name_size);
+
   void LowLevelCodeMoveEvent(Address from, Address to);
 
   void LowLevelCodeDeleteEvent(Address from);
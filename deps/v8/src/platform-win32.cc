@@ -657,6 +657,11 @@ static void VPrintHelper(FILE* stream, const char* format, va_list args) {
 }
 
 
+int OS::GetCurrentProcessId() {
+  return static_cast<int>(::GetCurrentProcessId());
+}
+
+
 FILE* OS::FOpen(const char* path, const char* mode) {
   FILE* result;
   if (fopen_s(&result, path, mode) == 0) {
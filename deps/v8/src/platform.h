@@ -140,6 +140,7 @@ class OS {
   static int GetLastError();
 
   static FILE* FOpen(const char* path, const char* mode);
+  static int GetCurrentProcessId();
   static bool Remove(const char* path);
 
   // Opens a temporary file, the file is auto removed on close.
@@ -45,21 +45,6 @@ SlowBuffer.prototype.inspect = function() {
 };
 
 
-SlowBuffer.prototype.hexSlice = function(start, end) {
-  var len = this.length;
-
-  if (!start || start < 0) start = 0;
-  if (!end || end < 0 || end > len) end = len;
-
-  var out = '';
-  for (var i = start; i < end; i++) {
-    out += toHex(this[i]);
-  }
-  return out;
-};
-
-
-
 SlowBuffer.prototype.toString = function(encoding, start, end) {
   encoding = String(encoding || 'utf8').toLowerCase();
   start = +start || 0;
@@ -97,36 +82,6 @@ SlowBuffer.prototype.toString = function(encoding, start, end) {
 };
 
 
-SlowBuffer.prototype.hexWrite = function(string, offset, length) {
-  offset = +offset || 0;
-  var remaining = this.length - offset;
-  if (!length) {
-    length = remaining;
-  } else {
-    length = +length;
-    if (length > remaining) {
-      length = remaining;
-    }
-  }
-
-  // must be an even number of digits
-  var strLen = string.length;
-  if (strLen % 2) {
-    throw new Error('Invalid hex string');
-  }
-  if (length > strLen / 2) {
-    length = strLen / 2;
-  }
-  for (var i = 0; i < length; i++) {
-    var byte = parseInt(string.substr(i * 2, 2), 16);
-    if (isNaN(byte)) throw new Error('Invalid hex string');
-    this[offset + i] = byte;
-  }
-  SlowBuffer._charsWritten = i * 2;
-  return i;
-};
-
-
 SlowBuffer.prototype.write = function(string, offset, length, encoding) {
   // Support both (string, offset, length, encoding)
   // and the legacy (string, encoding, offset, length)
@@ -281,6 +236,67 @@ Buffer.isBuffer = function isBuffer(b) {
 };
 
 
+// Buffer.concat(list, [totalLength])
+// Returns a buffer holding the contents of every buffer in `list`. The copy
+// is done in a single call into C++.
+Buffer.concat = function(list, length) {
+  if (!Array.isArray(list)) {
+    throw new TypeError('Usage: Buffer.concat(list, [length])');
+  }
+
+  if (list.length === 0) {
+    return new Buffer(0);
+  } else if (list.length === 1) {
+    return list[0];
+  }
+
+  if (typeof length !== 'number') {
+    length = 0;
+    for (var i = 0; i < list.length; i++) {
+      length += list[i].length;
+    }
+  }
+
+  var buffer = new Buffer(length);
+  SlowBuffer.concat(list, buffer);
+  return buffer;
+};
+
+
+// A list of buffers which is only joined on demand. It can be passed as is
+// to socket.write(), hash.update() and fs.writeFile(), which all consume
+// the chunks without concatenating them.
+function BufferList() {
+  this.buffers = [];
+  this.length = 0;
+}
+exports.BufferList = BufferList;
+
+
+BufferList.prototype.push = function(chunk, encoding) {
+  if (!Buffer.isBuffer(chunk)) chunk = new Buffer('' + chunk, encoding);
+  this.buffers.push(chunk);
+  this.length += chunk.length;
+  return this.length;
+};
+
+
+BufferList.prototype.clear = function() {
+  this.buffers = [];
+  this.length = 0;
+};
+
+
+BufferList.prototype.toBuffer = function() {
+  return Buffer.concat(this.buffers, this.length);
+};
+
+
+BufferList.prototype.toString = function(encoding) {
+  return this.toBuffer().toString(encoding);
+};
+
+
 // Inspect
 Buffer.prototype.inspect = function inspect() {
   var out = [],
@@ -759,8 +775,9 @@ function readFloat(buffer, offset, isBigEndian, noAssert) {
         'Trying to read beyond buffer length');
   }
 
-  return require('buffer_ieee754').readIEEE754(buffer, offset, isBigEndian,
-      23, 4);
+  offset += buffer.offset;
+  return isBigEndian ? buffer.parent.readFloatBE(offset)
+                     : buffer.parent.readFloatLE(offset);
 }
 
 Buffer.prototype.readFloatLE = function(offset, noAssert) {
@@ -780,8 +797,9 @@ function readDouble(buffer, offset, isBigEndian, noAssert) {
         'Trying to read beyond buffer length');
   }
 
-  return require('buffer_ieee754').readIEEE754(buffer, offset, isBigEndian,
-      52, 8);
+  offset += buffer.offset;
+  return isBigEndian ? buffer.parent.readDoubleBE(offset)
+                     : buffer.parent.readDoubleLE(offset);
 }
 
 Buffer.prototype.readDoubleLE = function(offset, noAssert) {
@@ -1070,8 +1088,12 @@ function writeFloat(buffer, value, offset, isBigEndian, noAssert) {
     verifIEEE754(value, 3.4028234663852886e+38, -3.4028234663852886e+38);
   }
 
-  require('buffer_ieee754').writeIEEE754(buffer, value, offset, isBigEndian,
-      23, 4);
+  offset += buffer.offset;
+  if (isBigEndian) {
+    buffer.parent.writeFloatBE(value, offset);
+  } else {
+    buffer.parent.writeFloatLE(value, offset);
+  }
 }
 
 Buffer.prototype.writeFloatLE = function(value, offset, noAssert) {
@@ -1099,8 +1121,12 @@ function writeDouble(buffer, value, offset, isBigEndian, noAssert) {
     verifIEEE754(value, 1.7976931348623157E+308, -1.7976931348623157E+308);
   }
 
-  require('buffer_ieee754').writeIEEE754(buffer, value, offset, isBigEndian,
-      52, 8);
+  offset += buffer.offset;
+  if (isBigEndian) {
+    buffer.parent.writeDoubleBE(value, offset);
+  } else {
+    buffer.parent.writeDoubleLE(value, offset);
+  }
 }
 
 Buffer.prototype.writeDoubleLE = function(value, offset, noAssert) {
@@ -1110,3 +1136,34 @@ Buffer.prototype.writeDoubleLE = function(value, offset, noAssert) {
 Buffer.prototype.writeDoubleBE = function(value, offset, noAssert) {
   writeDouble(this, value, offset, true, noAssert);
 };
+
+
+/*
+ * Bulk forms of the accessors above. `array` is a typed array (Int8Array
+ * through Float64Array); its element type decides how many bytes make up a
+ * value and how they are read, its length how many values there are. The byte
+ * order is big endian unless `littleEndian` is set, as with DataView.
+ */
+function checkArray(buffer, offset, array) {
+  assert.ok(offset !== undefined && offset !== null,
+      'missing offset');
+
+  assert.ok(offset >= 0,
+      'offset is negative');
+
+  assert.ok(array && typeof array.BYTES_PER_ELEMENT === 'number',
+      'missing or invalid typed array');
+
+  assert.ok(offset + array.length * array.BYTES_PER_ELEMENT <= buffer.length,
+      'Trying to access beyond buffer length');
+}
+
+Buffer.prototype.readArray = function(offset, array, littleEndian, noAssert) {
+  if (!noAssert) checkArray(this, offset, array);
+  return this.parent.readArray(this.offset + offset, array, !!littleEndian);
+};
+
+Buffer.prototype.writeArray = function(offset, array, littleEndian, noAssert) {
+  if (!noAssert) checkArray(this, offset, array);
+  return this.parent.writeArray(this.offset + offset, array, !!littleEndian);
+};
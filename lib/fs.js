@@ -26,6 +26,7 @@ var constants = process.binding('constants');
 var fs = exports;
 var Stream = require('stream').Stream;
 var EventEmitter = require('events').EventEmitter;
+var BufferList = require('buffer').BufferList;
 
 var kMinPoolSpace = 128;
 var kPoolSize = 40 * 1024;
@@ -84,20 +85,7 @@ fs.readFile = function(path, encoding_) {
 
   readStream.on('end', function() {
     // copy all the buffers into one
-    var buffer;
-    switch (buffers.length) {
-      case 0: buffer = new Buffer(0); break;
-      case 1: buffer = buffers[0]; break;
-      default: // concat together
-        buffer = new Buffer(nread);
-        var n = 0;
-        buffers.forEach(function(b) {
-          var l = b.length;
-          b.copy(buffer, n, 0, l);
-          n += l;
-        });
-        break;
-    }
+    var buffer = Buffer.concat(buffers, nread);
     if (encoding) {
       try {
         buffer = buffer.toString(encoding);
@@ -129,14 +117,10 @@ fs.readFileSync = function(path, encoding) {
   fs.closeSync(fd);
 
   if (buffers.length > 1) {
-    var offset = 0;
-    var i;
-    buffer = new Buffer(nread);
-    buffers.forEach(function(i) {
-      if (!i._bytesRead) return;
-      i.copy(buffer, offset, 0, i._bytesRead);
-      offset += i._bytesRead;
-    });
+    for (var i = 0; i < buffers.length; i++) {
+      buffers[i] = buffers[i].slice(0, buffers[i]._bytesRead);
+    }
+    buffer = Buffer.concat(buffers, nread);
   } else if (buffers.length) {
     // buffers has exactly 1 (possibly zero length) buffer, so this should
     // be a shortcut
@@ -186,7 +170,7 @@ function noop() {}
 // list to make the arguments clear.
 
 fs.close = function(fd, callback) {
-  binding.close(fd, callback || noop);
+  return binding.close(fd, callback || noop);
 };
 
 fs.closeSync = function(fd) {
@@ -214,7 +198,7 @@ fs.open = function(path, flags, mode, callback) {
 
   mode = modeNum(mode, '0666');
 
-  binding.open(path, stringToFlags(flags), mode, callback);
+  return binding.open(path, stringToFlags(flags), mode, callback);
 };
 
 fs.openSync = function(path, flags, mode) {
@@ -246,7 +230,7 @@ fs.read = function(fd, buffer, offset, length, position, callback) {
     callback && callback(err, bytesRead || 0, buffer);
   }
 
-  binding.read(fd, buffer, offset, length, position, wrapper);
+  return binding.read(fd, buffer, offset, length, position, wrapper);
 };
 
 fs.readSync = function(fd, buffer, offset, length, position) {
@@ -296,7 +280,7 @@ fs.write = function(fd, buffer, offset, length, position, callback) {
     callback && callback(err, written || 0, buffer);
   }
 
-  binding.write(fd, buffer, offset, length, position, wrapper);
+  return binding.write(fd, buffer, offset, length, position, wrapper);
 };
 
 fs.writeSync = function(fd, buffer, offset, length, position) {
@@ -313,8 +297,145 @@ fs.writeSync = function(fd, buffer, offset, length, position) {
   return binding.write(fd, buffer, offset, length, position);
 };
 
+// Vectored and batched I/O. Every call is a single request to the thread
+// pool. Where the binding is missing (windows) they are emulated with
+// fs.read / fs.write.
+
+function toBufferArray(buffers) {
+  return buffers instanceof BufferList ? buffers.buffers.slice() : buffers;
+}
+
+function emulateVector(op, fd, buffers, position, callback) {
+  var total = 0;
+  var index = 0;
+  var offset = 0;
+
+  function next() {
+    if (index === buffers.length) return callback(null, total);
+    var buffer = buffers[index];
+    if (offset === buffer.length) {
+      index++;
+      offset = 0;
+      return next();
+    }
+    op(fd, buffer, offset, buffer.length - offset,
+       typeof position === 'number' ? position + total : null,
+       function(err, n) {
+         if (err) return callback(err);
+         if (n === 0) return callback(null, total); // EOF
+         total += n;
+         offset += n;
+         next();
+       });
+  }
+  next();
+}
+
+function emulateVectorSync(op, fd, buffers, position) {
+  var total = 0;
+  for (var i = 0; i < buffers.length; i++) {
+    var buffer = buffers[i];
+    var offset = 0;
+    while (offset < buffer.length) {
+      var n = op(fd, buffer, offset, buffer.length - offset,
+                 typeof position === 'number' ? position + total : null);
+      if (n === 0) return total; // EOF
+      total += n;
+      offset += n;
+    }
+  }
+  return total;
+}
+
+// Writes all of `buffers` (an array of Buffers or a BufferList), starting
+// at `position` or at the current file position when it is null. Calls
+// back with the total number of bytes written.
+fs.writev = function(fd, buffers, position, callback) {
+  buffers = toBufferArray(buffers);
+  callback = callback || noop;
+  if (binding.writev) {
+    return binding.writev(fd, buffers, position, callback);
+  } else {
+    emulateVector(fs.write, fd, buffers, position, callback);
+  }
+};
+
+fs.writevSync = function(fd, buffers, position) {
+  buffers = toBufferArray(buffers);
+  if (binding.writev) return binding.writev(fd, buffers, position);
+  return emulateVectorSync(fs.writeSync, fd, buffers, position);
+};
+
+// Fills `buffers` in order. Calls back with the total number of bytes read,
+// which is less than their combined length at end of file.
+fs.readv = function(fd, buffers, position, callback) {
+  buffers = toBufferArray(buffers);
+  callback = callback || noop;
+  if (binding.readv) {
+    return binding.readv(fd, buffers, position, callback);
+  } else {
+    emulateVector(fs.read, fd, buffers, position, callback);
+  }
+};
+
+fs.readvSync = function(fd, buffers, position) {
+  buffers = toBufferArray(buffers);
+  if (binding.readv) return binding.readv(fd, buffers, position);
+  return emulateVectorSync(fs.readSync, fd, buffers, position);
+};
+
+// Reads several file ranges in one request. `ranges` is an array of
+// [buffer, offset, length, position]; calls back with an array holding the
+// number of bytes read for each range.
+fs.preadMany = function(fd, ranges, callback) {
+  callback = callback || noop;
+  if (binding.preadMany) {
+    return binding.preadMany(fd, ranges, callback);
+  }
+
+  var results = [];
+  (function next(i) {
+    if (i === ranges.length) return callback(null, results);
+    var r = ranges[i];
+    fs.read(fd, r[0], r[1], r[2], r[3], function(err, bytesRead) {
+      if (err) return callback(err);
+      results.push(bytesRead);
+      next(i + 1);
+    });
+  })(0);
+};
+
+fs.preadManySync = function(fd, ranges) {
+  if (binding.preadMany) return binding.preadMany(fd, ranges);
+  return ranges.map(function(r) {
+    return fs.readSync(fd, r[0], r[1], r[2], r[3]);
+  });
+};
+
+// Memory-mapped files. The returned Buffer reads straight from the page
+// cache, so processes mapping the same file share one copy. The mapping
+// goes away when the buffer (and every slice of it) is collected, or at
+// once with fs.munmap(). munmap() empties the buffer it is given; slices
+// taken from it read zeros afterwards.
+if (binding.mmap) {
+  fs.mmap = function(fd, offset, length, prot, flags) {
+    if (typeof prot !== 'number') prot = constants.PROT_READ;
+    if (typeof flags !== 'number') flags = constants.MAP_SHARED;
+    var mapped = binding.mmap(fd, offset, length, prot, flags);
+    return new Buffer(mapped, length, 0);
+  };
+
+  fs.munmap = function(buffer) {
+    return binding.munmap(buffer.parent, buffer);
+  };
+
+  fs.madvise = function(buffer, advice) {
+    binding.madvise(buffer.parent, buffer.offset, buffer.length, advice);
+  };
+}
+
 fs.rename = function(oldPath, newPath, callback) {
-  binding.rename(oldPath, newPath, callback || noop);
+  return binding.rename(oldPath, newPath, callback || noop);
 };
 
 fs.renameSync = function(oldPath, newPath) {
@@ -322,7 +443,7 @@ fs.renameSync = function(oldPath, newPath) {
 };
 
 fs.truncate = function(fd, len, callback) {
-  binding.truncate(fd, len, callback || noop);
+  return binding.truncate(fd, len, callback || noop);
 };
 
 fs.truncateSync = function(fd, len) {
@@ -330,7 +451,7 @@ fs.truncateSync = function(fd, len) {
 };
 
 fs.rmdir = function(path, callback) {
-  binding.rmdir(path, callback || noop);
+  return binding.rmdir(path, callback || noop);
 };
 
 fs.rmdirSync = function(path) {
@@ -338,7 +459,7 @@ fs.rmdirSync = function(path) {
 };
 
 fs.fdatasync = function(fd, callback) {
-  binding.fdatasync(fd, callback || noop);
+  return binding.fdatasync(fd, callback || noop);
 };
 
 fs.fdatasyncSync = function(fd) {
@@ -346,7 +467,7 @@ fs.fdatasyncSync = function(fd) {
 };
 
 fs.fsync = function(fd, callback) {
-  binding.fsync(fd, callback || noop);
+  return binding.fsync(fd, callback || noop);
 };
 
 fs.fsyncSync = function(fd) {
@@ -354,7 +475,7 @@ fs.fsyncSync = function(fd) {
 };
 
 fs.mkdir = function(path, mode, callback) {
-  binding.mkdir(path, modeNum(mode), callback || noop);
+  return binding.mkdir(path, modeNum(mode), callback || noop);
 };
 
 fs.mkdirSync = function(path, mode) {
@@ -362,7 +483,7 @@ fs.mkdirSync = function(path, mode) {
 };
 
 fs.sendfile = function(outFd, inFd, inOffset, length, callback) {
-  binding.sendfile(outFd, inFd, inOffset, length, callback || noop);
+  return binding.sendfile(outFd, inFd, inOffset, length, callback || noop);
 };
 
 fs.sendfileSync = function(outFd, inFd, inOffset, length) {
@@ -370,7 +491,7 @@ fs.sendfileSync = function(outFd, inFd, inOffset, length) {
 };
 
 fs.readdir = function(path, callback) {
-  binding.readdir(path, callback || noop);
+  return binding.readdir(path, callback || noop);
 };
 
 fs.readdirSync = function(path) {
@@ -378,15 +499,15 @@ fs.readdirSync = function(path) {
 };
 
 fs.fstat = function(fd, callback) {
-  binding.fstat(fd, callback || noop);
+  return binding.fstat(fd, callback || noop);
 };
 
 fs.lstat = function(path, callback) {
-  binding.lstat(path, callback || noop);
+  return binding.lstat(path, callback || noop);
 };
 
 fs.stat = function(path, callback) {
-  binding.stat(path, callback || noop);
+  return binding.stat(path, callback || noop);
 };
 
 fs.fstatSync = function(fd) {
@@ -402,7 +523,7 @@ fs.statSync = function(path) {
 };
 
 fs.readlink = function(path, callback) {
-  binding.readlink(path, callback || noop);
+  return binding.readlink(path, callback || noop);
 };
 
 fs.readlinkSync = function(path) {
@@ -413,7 +534,7 @@ fs.symlink = function(destination, path, mode_, callback) {
   var mode = (typeof(mode_) == 'string' ? mode_ : null);
   var callback_ = arguments[arguments.length - 1];
   var callback = (typeof(callback_) == 'function' ? callback_ : null);
-  binding.symlink(destination, path, mode, callback);
+  return binding.symlink(destination, path, mode, callback);
 };
 
 fs.symlinkSync = function(destination, path, mode) {
@@ -421,7 +542,7 @@ fs.symlinkSync = function(destination, path, mode) {
 };
 
 fs.link = function(srcpath, dstpath, callback) {
-  binding.link(srcpath, dstpath, callback || noop);
+  return binding.link(srcpath, dstpath, callback || noop);
 };
 
 fs.linkSync = function(srcpath, dstpath) {
@@ -429,7 +550,7 @@ fs.linkSync = function(srcpath, dstpath) {
 };
 
 fs.unlink = function(path, callback) {
-  binding.unlink(path, callback || noop);
+  return binding.unlink(path, callback || noop);
 };
 
 fs.unlinkSync = function(path) {
@@ -437,7 +558,7 @@ fs.unlinkSync = function(path) {
 };
 
 fs.fchmod = function(fd, mode, callback) {
-  binding.fchmod(fd, modeNum(mode), callback || noop);
+  return binding.fchmod(fd, modeNum(mode), callback || noop);
 };
 
 fs.fchmodSync = function(fd, mode) {
@@ -464,7 +585,7 @@ if (constants.hasOwnProperty('O_SYMLINK')) {
 
 
 fs.chmod = function(path, mode, callback) {
-  binding.chmod(path, modeNum(mode), callback || noop);
+  return binding.chmod(path, modeNum(mode), callback || noop);
 };
 
 fs.chmodSync = function(path, mode) {
@@ -490,7 +611,7 @@ if (constants.hasOwnProperty('O_SYMLINK')) {
 }
 
 fs.fchown = function(fd, uid, gid, callback) {
-  binding.fchown(fd, uid, gid, callback || noop);
+  return binding.fchown(fd, uid, gid, callback || noop);
 };
 
 fs.fchownSync = function(fd, uid, gid) {
@@ -498,7 +619,7 @@ fs.fchownSync = function(fd, uid, gid) {
 };
 
 fs.chown = function(path, uid, gid, callback) {
-  binding.chown(path, uid, gid, callback || noop);
+  return binding.chown(path, uid, gid, callback || noop);
 };
 
 fs.chownSync = function(path, uid, gid) {
@@ -523,7 +644,7 @@ fs._toUnixTimestamp = toUnixTimestamp;
 fs.utimes = function(path, atime, mtime, callback) {
   atime = toUnixTimestamp(atime);
   mtime = toUnixTimestamp(mtime);
-  binding.utimes(path, atime, mtime, callback || noop);
+  return binding.utimes(path, atime, mtime, callback || noop);
 };
 
 fs.utimesSync = function(path, atime, mtime) {
@@ -535,7 +656,7 @@ fs.utimesSync = function(path, atime, mtime) {
 fs.futimes = function(fd, atime, mtime, callback) {
   atime = toUnixTimestamp(atime);
   mtime = toUnixTimestamp(mtime);
-  binding.futimes(fd, atime, mtime, callback || noop);
+  return binding.futimes(fd, atime, mtime, callback || noop);
 };
 
 fs.futimesSync = function(fd, atime, mtime) {
@@ -569,14 +690,31 @@ fs.writeFile = function(path, data, encoding_, callback) {
     if (openErr) {
       if (callback) callback(openErr);
     } else {
-      var buffer = Buffer.isBuffer(data) ? data : new Buffer('' + data, encoding);
-      writeAll(fd, buffer, 0, buffer.length, callback);
+      if (data instanceof BufferList) {
+        fs.writev(fd, data, 0, function(writeErr) {
+          if (writeErr) {
+            fs.close(fd, function() {
+              if (callback) callback(writeErr);
+            });
+          } else {
+            fs.close(fd, callback);
+          }
+        });
+      } else {
+        var buffer = Buffer.isBuffer(data) ? data : new Buffer('' + data, encoding);
+        writeAll(fd, buffer, 0, buffer.length, callback);
+      }
     }
   });
 };
 
 fs.writeFileSync = function(path, data, encoding) {
   var fd = fs.openSync(path, 'w');
+  if (data instanceof BufferList) {
+    fs.writevSync(fd, data, 0);
+    fs.closeSync(fd);
+    return;
+  }
   if (!Buffer.isBuffer(data)) {
     data = new Buffer('' + data, encoding || 'utf8');
   }
@@ -385,11 +385,11 @@ OutgoingMessage.prototype._writeRaw = function(data, encoding) {
       }
       var c = this.output.shift();
       var e = this.outputEncodings.shift();
-      this.connection.write(c, e);
+      socketWrite(this.connection, c, e);
     }
 
     // Directly write to socket.
-    return this.connection.write(data, encoding);
+    return socketWrite(this.connection, data, encoding);
   } else {
     this._buffer(data, encoding);
     return false;
@@ -674,11 +674,12 @@ OutgoingMessage.prototype.end = function(data, encoding) {
 
     if (this.chunkedEncoding) {
       var l = Buffer.byteLength(data, encoding).toString(16);
-      ret = this.connection.write(this._header + l + CRLF +
-                                  data + '\r\n0\r\n' +
-                                  this._trailer + '\r\n', encoding);
+      ret = socketWrite(this.connection,
+                        this._header + l + CRLF +
+                        data + '\r\n0\r\n' +
+                        this._trailer + '\r\n', encoding);
     } else {
-      ret = this.connection.write(this._header + data, encoding);
+      ret = socketWrite(this.connection, this._header + data, encoding);
     }
     this._headerSent = true;
 
@@ -752,7 +753,7 @@ OutgoingMessage.prototype._flush = function() {
     var data = this.output.shift();
     var encoding = this.outputEncodings.shift();
 
-    ret = this.socket.write(data, encoding);
+    ret = socketWrite(this.socket, data, encoding);
   }
 
   if (this.finished) {
@@ -1275,6 +1276,92 @@ exports.get = function(options, cb) {
   return req;
 };
 
+// While the server is parsing a slab of pipelined requests, responses which
+// complete in order are not written out one by one. Their chunks are queued
+// on socket._httpPipeline and handed to the socket in a single (vectored)
+// write once parser.execute() returns, or earlier when the batch grows past
+// PIPELINE_HIGH_WATER so that the writer sees the socket's backpressure.
+var PIPELINE_HIGH_WATER = 64 * 1024;
+
+function socketWrite(socket, data, encoding) {
+  var pipeline = socket._httpPipeline;
+  if (!pipeline) return socket.write(data, encoding);
+
+  if (data.length > 0) {
+    pipeline.push([data, encoding]);
+    pipeline.size += data.length;
+  }
+
+  if (pipeline.size >= PIPELINE_HIGH_WATER) return writePipeline(socket);
+  return true;
+}
+
+
+function newPipeline() {
+  var pipeline = [];
+  pipeline.size = 0;
+  return pipeline;
+}
+
+
+function pipelineExecute(socket, parser, d, start, len) {
+  socket._httpPipeline = newPipeline();
+  try {
+    return parser.execute(d, start, len);
+  } finally {
+    flushPipeline(socket);
+  }
+}
+
+
+// Hands the queued chunks to the socket and starts a new batch. Returns what
+// socket.write() returned.
+function writePipeline(socket) {
+  var chunks = socket._httpPipeline;
+  var ret = true;
+
+  socket._httpPipeline = newPipeline();
+
+  // Written after the socket was ended or destroyed; there is nowhere for
+  // it to go, as with a plain socket.write() at that point.
+  if (chunks.length == 0 || !socket.writable) return ret;
+
+  debug('SERVER flushing ' + chunks.length + ' pipelined chunks');
+  if (chunks.length == 1) {
+    ret = socket.write(chunks[0][0], chunks[0][1]);
+  } else if (socket._writev) {
+    ret = socket._writev(chunks);
+  } else {
+    for (var i = 0; i < chunks.length; i++) {
+      ret = socket.write(chunks[i][0], chunks[i][1]);
+    }
+  }
+
+  return ret;
+}
+
+
+function flushPipeline(socket) {
+  writePipeline(socket);
+  socket._httpPipeline = null;
+
+  if (socket._httpPipelineEnd) {
+    socket._httpPipelineEnd = false;
+    socket.destroySoon();
+  }
+}
+
+
+// Ending or destroying the socket from inside a parse pass (res.destroy(),
+// an error) must not lose what has been batched so far.
+function flushBefore(socket, method) {
+  return function() {
+    if (socket._httpPipeline) writePipeline(socket);
+    return method.apply(socket, arguments);
+  };
+}
+
+
 function httpSocketSetup(socket) {
   // NOTE: be sure not to use ondrain elsewhere in this file!
   socket.ondrain = function() {
@@ -1329,6 +1416,10 @@ function connectionListener(socket) {
 
   httpSocketSetup(socket);
 
+  socket.end = flushBefore(socket, socket.end);
+  socket.destroySoon = flushBefore(socket, socket.destroySoon);
+  socket.destroy = flushBefore(socket, socket.destroy);
+
   socket.setTimeout(2 * 60 * 1000); // 2 minute timeout
   socket.addListener('timeout', function() {
     socket.destroy();
@@ -1344,7 +1435,7 @@ function connectionListener(socket) {
   });
 
   socket.ondata = function(d, start, end) {
-    var ret = parser.execute(d, start, end - start);
+    var ret = pipelineExecute(socket, parser, d, start, end - start);
     if (ret instanceof Error) {
       debug('parse error');
       socket.destroy(ret);
@@ -1427,7 +1518,12 @@ function connectionListener(socket) {
       res.detachSocket(socket);
 
       if (res._last) {
-        socket.destroySoon();
+        if (socket._httpPipeline) {
+          // Let the batched responses go out first.
+          socket._httpPipelineEnd = true;
+        } else {
+          socket.destroySoon();
+        }
       } else {
         // start sending the next message
         var m = outgoing.shift();
@@ -3,6 +3,7 @@ var stream = require('stream');
 var timers = require('timers');
 var util = require('util');
 var assert = require('assert');
+var BufferList = require('buffer').BufferList;
 
 // constructor for lazy loading
 function createPipe() {
@@ -22,6 +23,7 @@ var FLAG_GOT_EOF      = 1 << 0;
 var FLAG_SHUTDOWN     = 1 << 1;
 var FLAG_DESTROY_SOON = 1 << 2;
 var FLAG_SHUTDOWNQUED = 1 << 3;
+var FLAG_NEED_DRAIN   = 1 << 4;
 
 
 var debug;
@@ -60,6 +62,8 @@ function initSocketHandle(self) {
   self._writeRequests = [];
 
   self._flags = 0;
+  self._corked = false;
+  self._spliceQueue = null;
   self._connectQueueSize = 0;
   self.destroyed = false;
   self.bytesRead = 0;
@@ -126,8 +130,29 @@ Socket.prototype._onTimeout = function() {
 };
 
 
-Socket.prototype.setNoDelay = function() {
-  /* TODO implement me */
+Socket.prototype.setNoDelay = function(noDelay) {
+  // backwards compatibility: assume true when `noDelay` is omitted
+  if (this._handle && this._handle.setNoDelay) {
+    this._handle.setNoDelay(noDelay === undefined ? true : !!noDelay);
+  }
+};
+
+
+// Hold back writes until uncork() so that they leave in a single writev
+// call. end() and destroySoon() uncork.
+Socket.prototype.cork = function() {
+  if (this._handle && this._handle.cork && !this._corked) {
+    this._corked = true;
+    this._handle.cork();
+  }
+};
+
+
+Socket.prototype.uncork = function() {
+  if (this._handle && this._corked) {
+    this._corked = false;
+    this._handle.uncork();
+  }
 };
 
 
@@ -171,13 +196,111 @@ Socket.prototype.pause = function() {
 
 
 Socket.prototype.resume = function() {
-  if (this._handle) {
+  // A spliced socket is read by libuv.
+  if (this._handle && !this._splicing) {
     this._handle.readStart();
   }
 };
 
 
+// A socket piped into another socket is spliced in libuv: the data never
+// comes up into JavaScript and the source is only read while dest keeps up.
+// Sockets that have to see the data ('data' listeners, an encoding, ondata)
+// take the generic path.
+// Data that is spliced never passes through JS, so the idle timers would
+// not be refreshed while it flows.
+function canSplice(source, dest) {
+  return dest instanceof Socket &&
+         !(source._idleTimeout >= 0) && !(dest._idleTimeout >= 0) &&
+         dest !== source &&
+         source._handle && source._handle.splice &&
+         dest._handle &&
+         !source._splicing && !dest._splicing &&
+         !source._connecting && !dest._connecting &&
+         source.readable && dest.writable &&
+         !source._decoder && !source.ondata &&
+         source.listeners('data').length == 0 &&
+         dest._writeRequests.length == 0 &&
+         !dest._corked;
+}
+
+
+Socket.prototype.pipe = function(dest, options) {
+  var self = this;
+  var req = canSplice(self, dest) && self._handle.splice(dest._handle);
+
+  if (!req) {
+    return stream.Stream.prototype.pipe.call(self, dest, options);
+  }
+
+  self._splicing = dest._splicing = true;
+
+  // libuv owns dest's fd until the splice is done. write() and end() calls
+  // made in the meantime are held here and replayed in order afterwards.
+  dest._spliceQueue = [];
+
+  req.oncomplete = function(status, bytes) {
+    var queue = dest._spliceQueue;
+
+    self._splicing = dest._splicing = false;
+    dest._spliceQueue = null;
+    self.bytesRead += bytes;
+    dest.bytesWritten += bytes;
+
+    // One of the ends was destroyed; that is where it gets reported. If it
+    // was dest, the source goes back to being read from JavaScript.
+    if (dest.destroyed) {
+      if (!self.destroyed) self.resume();
+      return;
+    }
+
+    if (self.destroyed) {
+      flushSpliceQueue(dest, queue);
+      return;
+    }
+
+    if (status) {
+      var ex = errnoException(errno, 'splice');
+      dest.destroy();
+      self.destroy(ex);
+      return;
+    }
+
+    flushSpliceQueue(dest, queue);
+    if (!options || options.end !== false) dest.end();
+    onEOF(self);
+  };
+
+  dest.emit('pipe', self);
+
+  return dest;
+};
+
+
+function flushSpliceQueue(socket, queue) {
+  var needDrain = socket._flags & FLAG_NEED_DRAIN;
+  socket._flags &= ~FLAG_NEED_DRAIN;
+
+  for (var i = 0; i < queue.length; i++) {
+    socket.write.apply(socket, queue[i]);
+  }
+
+  if (queue.ended) {
+    socket.end();
+  } else if (needDrain && socket._writeRequests.length == 0) {
+    // The queued writes returned false; nothing else will emit 'drain'.
+    emitDrainSoon(socket);
+  }
+}
+
+
 Socket.prototype.end = function(data, encoding) {
+  if (this._spliceQueue) {
+    if (data) this.write(data, encoding);
+    this._spliceQueue.ended = true;
+    return;
+  }
+
   if (this._connecting && ((this._flags & FLAG_SHUTDOWNQUED) == 0)) {
     // still connecting, add data to buffer
     if (data) this.write(data, encoding);
@@ -189,6 +312,7 @@ Socket.prototype.end = function(data, encoding) {
   this.writable = false;
 
   if (data) this.write(data, encoding);
+  this.uncork();
   DTRACE_NET_STREAM_END(this);
 
   if (this._flags & FLAG_GOT_EOF) {
@@ -228,6 +352,7 @@ function afterShutdown(status, handle, req) {
 
 
 Socket.prototype.destroySoon = function() {
+  this.uncork();
   this.writable = false;
   this._flags |= FLAG_DESTROY_SOON;
 
@@ -305,19 +430,7 @@ function onread(buffer, offset, length) {
     if (self.ondata) self.ondata(buffer, offset, end);
 
   } else if (errno == 'EOF') {
-    // EOF
-    self.readable = false;
-
-    assert.ok(!(self._flags & FLAG_GOT_EOF));
-    self._flags |= FLAG_GOT_EOF;
-
-    // We call destroy() before end(). 'close' not emitted until nextTick so
-    // the 'end' event will come first as required.
-    if (!self.writable) self.destroy();
-
-    if (!self.allowHalfOpen) self.end();
-    if (self._events && self._events['end']) self.emit('end');
-    if (self.onend) self.onend();
+    onEOF(self);
   } else {
     // Error
     if (errno == 'ECONNRESET') {
@@ -329,6 +442,22 @@ function onread(buffer, offset, length) {
 }
 
 
+function onEOF(self) {
+  self.readable = false;
+
+  assert.ok(!(self._flags & FLAG_GOT_EOF));
+  self._flags |= FLAG_GOT_EOF;
+
+  // We call destroy() before end(). 'close' not emitted until nextTick so
+  // the 'end' event will come first as required.
+  if (!self.writable) self.destroy();
+
+  if (!self.allowHalfOpen) self.end();
+  if (self._events && self._events['end']) self.emit('end');
+  if (self.onend) self.onend();
+}
+
+
 Socket.prototype.setEncoding = function(encoding) {
   var StringDecoder = require('string_decoder').StringDecoder; // lazy load
   this._decoder = new StringDecoder(encoding);
@@ -361,11 +490,20 @@ Socket.prototype.write = function(data /* [encoding], [fd], [cb] */) {
     }
   }
 
+  // Being spliced into; see Socket.prototype.pipe.
+  if (this._spliceQueue) {
+    this._spliceQueue.push(Array.prototype.slice.call(arguments));
+    this._flags |= FLAG_NEED_DRAIN;
+    return false;
+  }
+
   this.bytesWritten += data.length;
 
   // Change strings to buffers. SLOW
   if (typeof data == 'string') {
     data = new Buffer(data, encoding);
+  } else if (data instanceof BufferList && data.buffers.length == 0) {
+    data = new Buffer(0);
   }
 
   // If we are still connecting, then buffer this for later.
@@ -376,10 +514,38 @@ Socket.prototype.write = function(data /* [encoding], [fd], [cb] */) {
     } else {
       this._connectQueue = [ [data, encoding, fd, cb] ];
     }
+    this._flags |= FLAG_NEED_DRAIN;
     return false;
   }
 
-  var writeReq = this._handle.write(data);
+  var writeReq;
+  if (data instanceof BufferList) {
+    // Hand the chunks to libuv as one vectored write.
+    writeReq = this._handle.writev(data.buffers);
+  } else {
+    var written = 0;
+
+    // Nothing pending: try to write it out right away, without a write
+    // request. Only what the socket didn't take goes through write().
+    if (this._writeRequests.length == 0 && this._handle.tryWrite) {
+      written = this._handle.tryWrite(data);
+
+      if (written < 0) {
+        this.destroy(errnoException(errno, 'write'));
+        return false;
+      }
+
+      if (written == data.length) {
+        if (cb) process.nextTick(cb);
+        // An earlier write returned false and there is no write request
+        // left whose completion would say so.
+        if (this._flags & FLAG_NEED_DRAIN) emitDrainSoon(this);
+        return true;
+      }
+    }
+
+    writeReq = this._handle.write(data, written, data.length - written);
+  }
 
   if (!writeReq) {
     this.destroy(errnoException(errno, 'write'));
@@ -394,6 +560,56 @@ Socket.prototype.write = function(data /* [encoding], [fd], [cb] */) {
 };
 
 
+// Write a list of [data, encoding] pairs with one write request. Adjacent
+// strings with the same encoding are joined before being converted to
+// buffers so that the request carries as few iovecs as possible.
+Socket.prototype._writev = function(chunks) {
+  if (this._connecting || this._spliceQueue || !this._handle.writev) {
+    var ret = false;
+    for (var i = 0; i < chunks.length; i++) {
+      ret = this.write(chunks[i][0], chunks[i][1]);
+    }
+    return ret;
+  }
+
+  var buffers = [];
+  var pending = null, pendingEncoding;
+
+  for (var i = 0; i < chunks.length; i++) {
+    var data = chunks[i][0], encoding = chunks[i][1];
+
+    this.bytesWritten += data.length;
+
+    if (typeof data == 'string') {
+      if (pending !== null && pendingEncoding === encoding) {
+        pending += data;
+        continue;
+      }
+      if (pending !== null) buffers.push(new Buffer(pending, pendingEncoding));
+      pending = data;
+      pendingEncoding = encoding;
+    } else {
+      if (pending !== null) buffers.push(new Buffer(pending, pendingEncoding));
+      pending = null;
+      buffers.push(data);
+    }
+  }
+  if (pending !== null) buffers.push(new Buffer(pending, pendingEncoding));
+
+  var writeReq = this._handle.writev(buffers);
+
+  if (!writeReq) {
+    this.destroy(errnoException(errno, 'write'));
+    return false;
+  }
+
+  writeReq.oncomplete = afterWrite;
+  this._writeRequests.push(writeReq);
+
+  return this._handle.writeQueueSize == 0;
+};
+
+
 function afterWrite(status, handle, req, buffer) {
   var self = handle.socket;
 
@@ -407,6 +623,7 @@ function afterWrite(status, handle, req, buffer) {
   assert.equal(req, req_);
 
   if (self._writeRequests.length == 0) {
+    self._flags &= ~FLAG_NEED_DRAIN;
     // TODO remove all uses of ondrain - this is not a good hack.
     if (self.ondrain) self.ondrain();
     self.emit('drain');
@@ -420,6 +637,16 @@ function afterWrite(status, handle, req, buffer) {
 }
 
 
+function emitDrainSoon(self) {
+  self._flags &= ~FLAG_NEED_DRAIN;
+  process.nextTick(function() {
+    if (self.destroyed) return;
+    if (self.ondrain) self.ondrain();
+    self.emit('drain');
+  });
+}
+
+
 function connect(self, address, port, addressType) {
   if (port) {
     self.remotePort = port;
@@ -532,10 +759,19 @@ function afterConnect(status, handle, req) {
 
     if (self._connectQueue) {
       debug('Drain the connect queue');
+      // Hold 'drain' until the whole queue has been replayed.
+      var needDrain = self._flags & FLAG_NEED_DRAIN;
+      self._flags &= ~FLAG_NEED_DRAIN;
+
       for (var i = 0; i < self._connectQueue.length; i++) {
         self.write.apply(self, self._connectQueue[i]);
       }
       self._connectQueueCleanUp();
+
+      // Everything went out without a write request.
+      if (needDrain && self._writeRequests.length == 0) {
+        emitDrainSoon(self);
+      }
     }
 
     if (self._flags & FLAG_SHUTDOWNQUED) {
@@ -108,6 +108,8 @@ var unenroll = exports.unenroll = function(item) {
     list.close();
     delete lists[item._idleTimeout];
   }
+  // if active is called later, then we want to make sure not to insert again
+  item._idleTimeout = -1;
 };
 
 
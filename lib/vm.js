@@ -30,3 +30,4 @@ exports.createContext = binding.NodeScript.createContext;
 exports.runInContext = binding.NodeScript.runInContext;
 exports.runInThisContext = binding.NodeScript.runInThisContext;
 exports.runInNewContext = binding.NodeScript.runInNewContext;
+exports.setContextPoolSize = binding.NodeScript.setContextPoolSize;
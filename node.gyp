@@ -4,13 +4,13 @@
     'target_arch': 'ia32',
     'node_use_dtrace': 'false',
     'node_use_openssl%': 'true',
+    'node_test_bindings%': 'false',
     'library_files': [
       'src/node.js',
       'lib/_debugger.js',
       'lib/_linklist.js',
       'lib/assert.js',
       'lib/buffer.js',
-      'lib/buffer_ieee754.js',
       'lib/child_process_legacy.js',
       'lib/child_process_uv.js',
       'lib/console.js',
@@ -73,6 +73,7 @@
         'src/cares_wrap.cc',
         'src/handle_wrap.cc',
         'src/node.cc',
+        'src/node_async_queue.cc',
         'src/node_buffer.cc',
         'src/node_constants.cc',
         'src/node_dtrace.cc',
@@ -82,6 +83,7 @@
         'src/node_javascript.cc',
         'src/node_main.cc',
         'src/node_os.cc',
+        'src/node_profiler.cc',
         'src/node_script.cc',
         'src/node_string.cc',
         'src/pipe_wrap.cc',
@@ -95,6 +97,7 @@
         # headers to make for a more pleasant IDE experience
         'src/handle_wrap.h',
         'src/node.h',
+        'src/node_async_queue.h',
         'src/node_buffer.h',
         'src/node_cares.h',
         'src/node_child_process.h',
@@ -107,6 +110,7 @@
         'src/node_javascript.h',
         'src/node_net.h',
         'src/node_os.h',
+        'src/node_profiler.h',
         'src/node_root_certs.h',
         'src/node_script.h',
         'src/node_stdio.h',
@@ -141,7 +145,16 @@
           'defines': [ 'HAVE_OPENSSL=0' ]
         }],
 
-        [ 'node_use_dtrace=="true"', {
+        [ 'node_test_bindings=="true"', {
+          'defines': [ 'NODE_TEST_BINDINGS=1' ],
+        }],
+
+        [ 'node_use_dtrace=="true" and OS=="linux"', {
+          # systemtap USDT probes from <sys/sdt.h>, no dtrace(1) needed
+          'defines': [ 'HAVE_SYSTEMTAP=1' ],
+        }],
+
+        [ 'node_use_dtrace=="true" and OS!="linux"', {
           'sources': [
             'src/node_provider.h', # why does this get generated into src and not SHARED_INTERMEDIATE_DIR?
           ],
@@ -25,6 +25,8 @@
 
 #include <v8-debug.h>
 #include <node_dtrace.h>
+#include <node_profiler.h>
+#include <req_wrap.h>
 
 #include <locale.h>
 #include <signal.h>
@@ -113,6 +115,14 @@ namespace node {
 
 static Persistent<Object> process;
 
+// The loop that everything on the main thread runs on. Bindings get at it
+// through Loop() rather than calling uv_default_loop() themselves, so this
+// is the one place that would have to become per-thread.
+// TODO worker threads (an isolate and a loop each) are not implemented;
+// the Persistent symbols, the stream_wrap slab and the tick/gc watchers
+// are still process-wide.
+static uv_loop_t* node_loop;
+
 static Persistent<String> errno_symbol;
 static Persistent<String> syscall_symbol;
 static Persistent<String> errpath_symbol;
@@ -134,6 +144,7 @@ static bool use_debug_agent = false;
 static bool debug_wait_connect = false;
 static int debug_port=5858;
 static int max_stack_size = 0;
+static bool profile_signal = false;
 
 static uv_check_t check_tick_watcher;
 static uv_prepare_t prepare_tick_watcher;
@@ -168,8 +179,16 @@ static char getbuf[PATH_MAX + 1];
 // true if the heap hasn't be fully compacted, and needs to be run again.
 // Returning false means that it doesn't have anymore work to do.
 //
-// A rather convoluted algorithm has been devised to determine when Node is
-// idle. You'll have to figure it out for yourself.
+// IdleNotification() can't be told how long it may take, so what we control
+// is how often it is called. Every poll adds a share of the time the loop
+// spent blocked to gc_budget, and Check() spends the budget on another
+// IdleNotification() once it covers what the previous one cost. Idle GC thus
+// takes at most a fixed fraction of the idle time and a busy server gets it
+// in the gaps between requests, instead of only after seconds of quiet.
+// Once V8 says it is done we leave it alone until the heap has grown again.
+//
+// The gc_timer below still catches a loop that has gone completely quiet,
+// and is the only trigger on platforms where the poll isn't timed.
 static uv_check_t gc_check;
 static uv_idle_t gc_idle;
 static uv_timer_t gc_timer;
@@ -183,6 +202,33 @@ bool need_gc;
 static int64_t tick_times[RPM_SAMPLES];
 static int tick_time_head;
 
+#define GC_IDLE_SHARE 4                // a quarter of the idle time
+#define GC_BUDGET_MAX 100000000        // ns
+#define GC_HEAP_GROWTH (1024 * 1024)   // bytes
+#define RSS_CHECK_INTERVAL 1000        // ms
+
+static uint64_t gc_budget;
+static uint64_t gc_cost = 1000000;     // until we have measured one
+static bool gc_settled;
+static size_t gc_settled_heap;
+
+// --max-rss: above this many bytes of RSS V8 gets a LowMemoryNotification().
+static size_t max_rss = 0;
+static int64_t rss_checked;
+
+static struct {
+  uint64_t count;
+  uint64_t scavenges;
+  uint64_t mark_sweeps;
+  uint64_t pause_time;
+  uint64_t pause_max;
+  uint64_t idle_notifications;
+  uint64_t idle_time;
+  uint64_t low_memory_notifications;
+} gc_stats;
+
+static uint64_t gc_start;
+
 static void CheckStatus(uv_timer_t* watcher, int status);
 
 static void StartGCTimer () {
@@ -197,10 +243,71 @@ static void StopGCTimer () {
   }
 }
 
+
+static size_t HeapUsed() {
+  HeapStatistics stats;
+  V8::GetHeapStatistics(&stats);
+  return stats.used_heap_size();
+}
+
+
+// Returns true when V8 has nothing more to do.
+static bool IdleGC() {
+  uint64_t start = uv_hrtime();
+  bool done = V8::IdleNotification();
+  uint64_t t = uv_hrtime() - start;
+
+  gc_cost = t;
+  gc_budget = gc_budget > t ? gc_budget - t : 0;
+  gc_stats.idle_notifications++;
+  gc_stats.idle_time += t;
+
+  if (done) {
+    gc_settled = true;
+    gc_settled_heap = HeapUsed();
+  }
+
+  return done;
+}
+
+
+static void CheckMemoryPressure() {
+  int64_t now = uv_now(Loop());
+  if (now - rss_checked < RSS_CHECK_INTERVAL) return;
+  rss_checked = now;
+
+  size_t rss, vsize;
+  if (Platform::GetMemory(&rss, &vsize) != 0 || rss <= max_rss) return;
+
+  V8::LowMemoryNotification();
+  gc_stats.low_memory_notifications++;
+  gc_settled = false;
+}
+
+
+static void GCPrologue(GCType type, GCCallbackFlags flags) {
+  gc_start = uv_hrtime();
+}
+
+
+static void GCEpilogue(GCType type, GCCallbackFlags flags) {
+  uint64_t t = uv_hrtime() - gc_start;
+
+  gc_stats.count++;
+  if (type == kGCTypeScavenge) {
+    gc_stats.scavenges++;
+  } else {
+    gc_stats.mark_sweeps++;
+  }
+  gc_stats.pause_time += t;
+  if (t > gc_stats.pause_max) gc_stats.pause_max = t;
+}
+
+
 static void Idle(uv_idle_t* watcher, int status) {
   assert((uv_idle_t*) watcher == &gc_idle);
 
-  if (V8::IdleNotification()) {
+  if (IdleGC()) {
     uv_idle_stop(&gc_idle);
     StopGCTimer();
   }
@@ -211,26 +318,346 @@ static void Idle(uv_idle_t* watcher, int status) {
 static void Check(uv_check_t* watcher, int status) {
   assert(watcher == &gc_check);
 
-  tick_times[tick_time_head] = uv_now(uv_default_loop());
+  tick_times[tick_time_head] = uv_now(Loop());
   tick_time_head = (tick_time_head + 1) % RPM_SAMPLES;
 
   StartGCTimer();
 
+  if (max_rss > 0) CheckMemoryPressure();
+
+#ifdef __POSIX__
+  if (gc_settled) {
+    if (HeapUsed() < gc_settled_heap + GC_HEAP_GROWTH) return;
+    gc_settled = false;
+  }
+
+  if (gc_budget >= gc_cost && !uv_is_active((uv_handle_t*) &gc_idle)) {
+    IdleGC();
+  }
+#else
   for (int i = 0; i < (int)(GC_WAIT_TIME/FAST_TICK); i++) {
     double d = TICK_TIME(i+1) - TICK_TIME(i+2);
-    //printf("d = %f\n", d);
     // If in the last 5 ticks the difference between
     // ticks was less than 0.7 seconds, then continue.
     if (d < FAST_TICK) {
-      //printf("---\n");
       return;
     }
   }
 
   // Otherwise start the gc!
-
-  //fprintf(stderr, "start idle 2\n");
   uv_idle_start(&node::gc_idle, node::Idle);
+#endif
+}
+
+
+// Loop health. Times are kept in nanoseconds as returned by uv_hrtime() and
+// only converted to milliseconds when handed to JS. An iteration runs from
+// one PrepareTick() to the next; whatever part of it wasn't spent blocked in
+// the poll is time the loop was busy, and that is what the lag histogram
+// records. Bucket 0 is under 1 ms, bucket n is [2^(n-1), 2^n) ms and the
+// last one takes everything above.
+#define LAG_BUCKETS 12
+#define MAX_CALLBACK_KINDS 16
+
+struct CallbackKind {
+  char* method;
+  uint64_t count;
+  uint64_t time;
+};
+
+static struct {
+  uint64_t iterations;
+  uint64_t poll_time;
+  uint64_t tick_time;
+  uint64_t callback_time;
+  uint64_t lag_max;
+  uint64_t lag[LAG_BUCKETS];
+  CallbackKind kinds[MAX_CALLBACK_KINDS];
+  int nkinds;
+} loop_stats;
+
+static uint64_t iteration_start;
+static uint64_t iteration_poll;
+static uint64_t poll_start;
+static int callback_depth;
+static uv_timer_t loop_monitor;
+
+
+static void LoopIteration() {
+  uint64_t now = uv_hrtime();
+
+  if (iteration_start != 0) {
+    uint64_t busy = now - iteration_start - iteration_poll;
+    uint64_t ms = busy / 1000000;
+    int bucket = 0;
+
+    while (ms > 0 && bucket < LAG_BUCKETS - 1) {
+      ms >>= 1;
+      bucket++;
+    }
+
+    loop_stats.lag[bucket]++;
+    if (busy > loop_stats.lag_max) loop_stats.lag_max = busy;
+    loop_stats.iterations++;
+  }
+
+  iteration_start = now;
+  iteration_poll = 0;
+}
+
+
+#ifdef __POSIX__
+// libev calls these right before and right after it blocks in the backend.
+static void LoopRelease(EV_P) {
+  poll_start = uv_hrtime();
+}
+
+
+static void LoopAcquire(EV_P) {
+  uint64_t t = uv_hrtime() - poll_start;
+  iteration_poll += t;
+  loop_stats.poll_time += t;
+
+  gc_budget += t / GC_IDLE_SHARE;
+  if (gc_budget > GC_BUDGET_MAX) gc_budget = GC_BUDGET_MAX;
+}
+#endif  // __POSIX__
+
+
+// Callbacks are counted by the method MakeCallback() was asked to call. That
+// tells the kinds of handles apart well enough: "onread" for streams,
+// "ontimeout" for timers, "oncomplete" for requests and so on.
+static void RecordCallback(const char* method, uint64_t t) {
+  CallbackKind* kind = NULL;
+
+  loop_stats.callback_time += t;
+
+  for (int i = 0; i < loop_stats.nkinds; i++) {
+    if (strcmp(loop_stats.kinds[i].method, method) == 0) {
+      kind = &loop_stats.kinds[i];
+      break;
+    }
+  }
+
+  if (kind == NULL) {
+    if (loop_stats.nkinds == MAX_CALLBACK_KINDS) return;
+    kind = &loop_stats.kinds[loop_stats.nkinds++];
+    kind->method = strdup(method);
+    kind->count = 0;
+    kind->time = 0;
+  }
+
+  kind->count++;
+  kind->time += t;
+}
+
+
+static inline double NanoToMilli(uint64_t t) {
+  return static_cast<double>(t) / 1e6;
+}
+
+
+static Local<Object> BuildLoopStats() {
+  HandleScope scope;
+
+  Local<Object> stats = Object::New();
+  stats->Set(String::NewSymbol("iterations"),
+             Number::New(static_cast<double>(loop_stats.iterations)));
+  stats->Set(String::NewSymbol("pollTime"),
+             Number::New(NanoToMilli(loop_stats.poll_time)));
+  stats->Set(String::NewSymbol("tickTime"),
+             Number::New(NanoToMilli(loop_stats.tick_time)));
+  stats->Set(String::NewSymbol("callbackTime"),
+             Number::New(NanoToMilli(loop_stats.callback_time)));
+
+  Local<Array> histogram = Array::New(LAG_BUCKETS);
+  for (int i = 0; i < LAG_BUCKETS; i++) {
+    histogram->Set(Integer::New(i),
+                   Number::New(static_cast<double>(loop_stats.lag[i])));
+  }
+
+  Local<Object> lag = Object::New();
+  lag->Set(String::NewSymbol("max"), Number::New(NanoToMilli(loop_stats.lag_max)));
+  lag->Set(String::NewSymbol("histogram"), histogram);
+  stats->Set(String::NewSymbol("lag"), lag);
+
+  Local<Object> callbacks = Object::New();
+  for (int i = 0; i < loop_stats.nkinds; i++) {
+    CallbackKind* kind = &loop_stats.kinds[i];
+    Local<Object> o = Object::New();
+    o->Set(String::NewSymbol("count"),
+           Number::New(static_cast<double>(kind->count)));
+    o->Set(String::NewSymbol("time"), Number::New(NanoToMilli(kind->time)));
+    callbacks->Set(String::New(kind->method), o);
+  }
+  stats->Set(String::NewSymbol("callbacks"), callbacks);
+
+  return scope.Close(stats);
+}
+
+
+static void ResetLoopStats() {
+  loop_stats.iterations = 0;
+  loop_stats.poll_time = 0;
+  loop_stats.tick_time = 0;
+  loop_stats.callback_time = 0;
+  loop_stats.lag_max = 0;
+  memset(loop_stats.lag, 0, sizeof loop_stats.lag);
+
+  // Keep the method names, they are likely to show up again.
+  for (int i = 0; i < loop_stats.nkinds; i++) {
+    loop_stats.kinds[i].count = 0;
+    loop_stats.kinds[i].time = 0;
+  }
+}
+
+
+// process.loopStats(reset)
+static Handle<Value> LoopStats(const Arguments& args) {
+  HandleScope scope;
+  Local<Object> stats = BuildLoopStats();
+  if (args[0]->IsTrue()) ResetLoopStats();
+  return scope.Close(stats);
+}
+
+
+static void LoopMonitor(uv_timer_t* handle, int status) {
+  assert(handle == &loop_monitor);
+  assert(status == 0);
+
+  HandleScope scope;
+
+  Local<Value> emit_v = process->Get(String::NewSymbol("emit"));
+  if (!emit_v->IsFunction()) return;
+  Local<Function> emit = Local<Function>::Cast(emit_v);
+
+  Local<Value> argv[2] = { String::New("loopStats"), BuildLoopStats() };
+  ResetLoopStats();
+
+  TryCatch try_catch;
+
+  emit->Call(process, 2, argv);
+
+  if (try_catch.HasCaught()) {
+    FatalException(try_catch);
+  }
+}
+
+
+// process.monitorLoop(interval) - emits 'loopStats' on process every
+// interval ms, with the counters reset each time. 0 turns it off. The timer
+// doesn't keep the process alive.
+static Handle<Value> MonitorLoop(const Arguments& args) {
+  HandleScope scope;
+
+  int64_t interval = args[0]->IntegerValue();
+
+  uv_timer_stop(&loop_monitor);
+  if (interval > 0) {
+    ResetLoopStats();
+    uv_timer_start(&loop_monitor, LoopMonitor, interval, interval);
+  }
+
+  return Undefined();
+}
+
+
+static Local<Object> BuildThreadPoolStats(uv_threadpool_type type) {
+  HandleScope scope;
+
+  uv_threadpool_stats_t s;
+  uv_threadpool_stats(type, &s);
+
+  Local<Object> stats = Object::New();
+  stats->Set(String::NewSymbol("threads"), Integer::New(s.threads));
+  stats->Set(String::NewSymbol("queued"),
+             Number::New(static_cast<double>(s.queued)));
+  stats->Set(String::NewSymbol("active"),
+             Number::New(static_cast<double>(s.active)));
+  if (type == UV_THREADPOOL_WORK) {
+    stats->Set(String::NewSymbol("completed"),
+               Number::New(static_cast<double>(s.completed)));
+    stats->Set(String::NewSymbol("steals"),
+               Number::New(static_cast<double>(s.steals)));
+  }
+
+  return scope.Close(stats);
+}
+
+
+// process.threadPoolStats() - { work: {...}, io: {...} }. `work` is the pool
+// behind uv_queue_work (pbkdf2, addons), `io` the one running
+// fs requests.
+static Handle<Value> ThreadPoolStats(const Arguments& args) {
+  HandleScope scope;
+
+  Local<Object> stats = Object::New();
+  stats->Set(String::NewSymbol("work"),
+             BuildThreadPoolStats(UV_THREADPOOL_WORK));
+  stats->Set(String::NewSymbol("io"), BuildThreadPoolStats(UV_THREADPOOL_IO));
+
+  return scope.Close(stats);
+}
+
+
+// process.setThreadPoolSize(pool, threads) - pool is 'work' or 'io'.
+static Handle<Value> SetThreadPoolSize(const Arguments& args) {
+  HandleScope scope;
+
+  String::AsciiValue pool(args[0]);
+  uv_threadpool_type type;
+
+  if (strcmp(*pool, "work") == 0) {
+    type = UV_THREADPOOL_WORK;
+  } else if (strcmp(*pool, "io") == 0) {
+    type = UV_THREADPOOL_IO;
+  } else {
+    return ThrowException(Exception::TypeError(
+          String::New("Thread pool must be 'work' or 'io'")));
+  }
+
+  int r = uv_threadpool_set_size(type, args[1]->Int32Value());
+
+  return scope.Close(r == 0 ? True() : False());
+}
+
+
+static Persistent<ObjectTemplate> cancelable_req_template;
+
+
+// req.cancel() - true if the request was pulled off its queue before it
+// started. Its callback then runs with an ECANCELED error.
+static Handle<Value> CancelReq(const Arguments& args) {
+  HandleScope scope;
+
+  if (args.This()->InternalFieldCount() < 1) return scope.Close(False());
+
+  uv_req_t* req = static_cast<uv_req_t*>(
+      args.This()->GetPointerFromInternalField(0));
+  if (req == NULL) return scope.Close(False());
+
+  return scope.Close(uv_cancel(req) == 0 ? True() : False());
+}
+
+
+Local<Object> NewCancelableReq(uv_req_t* req) {
+  HandleScope scope;
+
+  if (cancelable_req_template.IsEmpty()) {
+    Local<ObjectTemplate> t = ObjectTemplate::New();
+    t->SetInternalFieldCount(1);
+    t->Set(String::NewSymbol("cancel"), FunctionTemplate::New(CancelReq));
+    cancelable_req_template = Persistent<ObjectTemplate>::New(t);
+  }
+
+  Local<Object> object = cancelable_req_template->NewInstance();
+  object->SetPointerInInternalField(0, req);
+  return scope.Close(object);
+}
+
+
+void DetachCancelableReq(Handle<Object> object) {
+  object->SetPointerInInternalField(0, NULL);
 }
 
 
@@ -241,7 +668,7 @@ static void Tick(void) {
   need_tick_cb = false;
   if (uv_is_active((uv_handle_t*) &tick_spinner)) {
     uv_idle_stop(&tick_spinner);
-    uv_unref(uv_default_loop());
+    uv_unref(Loop());
   }
 
   HandleScope scope;
@@ -258,7 +685,9 @@ static void Tick(void) {
 
   TryCatch try_catch;
 
+  uint64_t start = uv_hrtime();
   cb->Call(process, 0, NULL);
+  loop_stats.tick_time += uv_hrtime() - start;
 
   if (try_catch.HasCaught()) {
     FatalException(try_catch);
@@ -283,7 +712,7 @@ static Handle<Value> NeedTickCallback(const Arguments& args) {
   // tick_spinner to keep the event loop alive long enough to handle it.
   if (!uv_is_active((uv_handle_t*) &tick_spinner)) {
     uv_idle_start(&tick_spinner, Spin);
-    uv_ref(uv_default_loop());
+    uv_ref(Loop());
   }
   return Undefined();
 }
@@ -292,6 +721,7 @@ static Handle<Value> NeedTickCallback(const Arguments& args) {
 static void PrepareTick(uv_prepare_t* handle, int status) {
   assert(handle == &prepare_tick_watcher);
   assert(status == 0);
+  LoopIteration();
   Tick();
 }
 
@@ -1088,14 +1518,26 @@ void MakeCallback(Handle<Object> object,
 
   TryCatch try_catch;
 
+  uint64_t start = uv_hrtime();
+  callback_depth++;
+
   callback->Call(object, argc, argv);
 
+  // Only the outermost callback counts, a nested one is already part of it.
+  if (--callback_depth == 0) RecordCallback(method, uv_hrtime() - start);
+
   if (try_catch.HasCaught()) {
     FatalException(try_catch);
   }
 }
 
 
+uv_loop_t* Loop() {
+  assert(node_loop != NULL);
+  return node_loop;
+}
+
+
 void SetErrno(uv_err_code code) {
   uv_err_t err;
   err.code = code;
@@ -1537,7 +1979,7 @@ static void CheckStatus(uv_timer_t* watcher, int status) {
     }
   }
 
-  double d = uv_now(uv_default_loop()) - TICK_TIME(3);
+  double d = uv_now(Loop()) - TICK_TIME(3);
 
   //printfb("timer d = %f\n", d);
 
@@ -1547,6 +1989,33 @@ static void CheckStatus(uv_timer_t* watcher, int status) {
   }
 }
 
+// process.gcStats(reset)
+static Handle<Value> GCStats(const Arguments& args) {
+  HandleScope scope;
+
+  Local<Object> stats = Object::New();
+  stats->Set(String::NewSymbol("count"),
+             Number::New(static_cast<double>(gc_stats.count)));
+  stats->Set(String::NewSymbol("scavenges"),
+             Number::New(static_cast<double>(gc_stats.scavenges)));
+  stats->Set(String::NewSymbol("markSweeps"),
+             Number::New(static_cast<double>(gc_stats.mark_sweeps)));
+  stats->Set(String::NewSymbol("pauseTime"),
+             Number::New(NanoToMilli(gc_stats.pause_time)));
+  stats->Set(String::NewSymbol("pauseMax"),
+             Number::New(NanoToMilli(gc_stats.pause_max)));
+  stats->Set(String::NewSymbol("idleNotifications"),
+             Number::New(static_cast<double>(gc_stats.idle_notifications)));
+  stats->Set(String::NewSymbol("idleTime"),
+             Number::New(NanoToMilli(gc_stats.idle_time)));
+  stats->Set(String::NewSymbol("lowMemoryNotifications"),
+             Number::New(static_cast<double>(gc_stats.low_memory_notifications)));
+
+  if (args[0]->IsTrue()) memset(&gc_stats, 0, sizeof gc_stats);
+
+  return scope.Close(stats);
+}
+
 static Handle<Value> Uptime(const Arguments& args) {
   HandleScope scope;
   assert(args.Length() == 0);
@@ -2171,6 +2640,17 @@ Handle<Object> SetupProcessObject(int argc, char *argv[]) {
 
   NODE_SET_METHOD(process, "uptime", Uptime);
   NODE_SET_METHOD(process, "memoryUsage", MemoryUsage);
+  NODE_SET_METHOD(process, "loopStats", LoopStats);
+  NODE_SET_METHOD(process, "monitorLoop", MonitorLoop);
+  NODE_SET_METHOD(process, "threadPoolStats", ThreadPoolStats);
+  NODE_SET_METHOD(process, "setThreadPoolSize", SetThreadPoolSize);
+  NODE_SET_METHOD(process, "gcStats", GCStats);
+
+  // Collects the pause times for gcStats().
+  V8::AddGCPrologueCallback(GCPrologue);
+  V8::AddGCEpilogueCallback(GCEpilogue);
+
+  InitProfiler(process, profile_signal);
 
   NODE_SET_METHOD(process, "binding", Binding);
 
@@ -2273,6 +2753,8 @@ static void PrintHelp() {
          "  --v8-options         print v8 command line options\n"
          "  --vars               print various compiled-in variables\n"
          "  --max-stack-size=val set max v8 stack size (bytes)\n"
+         "  --max-rss=val        ask v8 to free memory above this rss (MB)\n"
+         "  --profile-signal     start/stop the cpu profiler on SIGUSR2\n"
          "  --use-legacy         use the legacy backend (default: libuv)\n"
          "  --use-http1          use the legacy http library\n"
          "\n"
@@ -2318,6 +2800,14 @@ static void ParseArgs(int argc, char **argv) {
       p = 1 + strchr(arg, '=');
       max_stack_size = atoi(p);
       argv[i] = const_cast<char*>("");
+    } else if (strstr(arg, "--max-rss=") == arg) {
+      const char *p = 0;
+      p = 1 + strchr(arg, '=');
+      max_rss = static_cast<size_t>(atoi(p)) * 1024 * 1024;
+      argv[i] = const_cast<char*>("");
+    } else if (strcmp(arg, "--profile-signal") == 0) {
+      profile_signal = true;
+      argv[i] = const_cast<char*>("");
     } else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
       PrintHelp();
       exit(0);
@@ -2436,26 +2926,33 @@ char** Init(int argc, char *argv[]) {
   RegisterSignalHandler(SIGTERM, SignalExit);
 #endif // __POSIX__
 
-  uv_prepare_init(uv_default_loop(), &node::prepare_tick_watcher);
+  uv_prepare_init(Loop(), &node::prepare_tick_watcher);
   uv_prepare_start(&node::prepare_tick_watcher, PrepareTick);
-  uv_unref(uv_default_loop());
+  uv_unref(Loop());
 
-  uv_check_init(uv_default_loop(), &node::check_tick_watcher);
+  uv_check_init(Loop(), &node::check_tick_watcher);
   uv_check_start(&node::check_tick_watcher, node::CheckTick);
-  uv_unref(uv_default_loop());
+  uv_unref(Loop());
 
-  uv_idle_init(uv_default_loop(), &node::tick_spinner);
-  uv_unref(uv_default_loop());
+  uv_idle_init(Loop(), &node::tick_spinner);
+  uv_unref(Loop());
 
-  uv_check_init(uv_default_loop(), &node::gc_check);
+  uv_check_init(Loop(), &node::gc_check);
   uv_check_start(&node::gc_check, node::Check);
-  uv_unref(uv_default_loop());
+  uv_unref(Loop());
+
+  uv_idle_init(Loop(), &node::gc_idle);
+  uv_unref(Loop());
+
+  uv_timer_init(Loop(), &node::gc_timer);
+  uv_unref(Loop());
 
-  uv_idle_init(uv_default_loop(), &node::gc_idle);
-  uv_unref(uv_default_loop());
+  uv_timer_init(Loop(), &node::loop_monitor);
+  uv_unref(Loop());
 
-  uv_timer_init(uv_default_loop(), &node::gc_timer);
-  uv_unref(uv_default_loop());
+#ifdef __POSIX__
+  ev_set_loop_release_cb(EV_DEFAULT_UC_ node::LoopRelease, node::LoopAcquire);
+#endif
 
   V8::SetFatalErrorHandler(node::OnFatalError);
 
@@ -2467,10 +2964,10 @@ char** Init(int argc, char *argv[]) {
   // main thread to execute a random bit of javascript - which will give V8
   // control so it can handle whatever new message had been received on the
   // debug thread.
-  uv_async_init(uv_default_loop(), &node::debug_watcher,
+  uv_async_init(Loop(), &node::debug_watcher,
       node::DebugMessageCallback);
   // unref it so that we exit the event loop despite it being active.
-  uv_unref(uv_default_loop());
+  uv_unref(Loop());
 
 
   // If the --debug flag was specified then initialize the debug thread.
@@ -2507,6 +3004,7 @@ int Start(int argc, char *argv[]) {
 #endif
 
   uv_init();
+  node_loop = uv_default_loop();
 
   // This needs to run *before* V8::Initialize()
   argv = Init(argc, argv);
@@ -2530,7 +3028,7 @@ int Start(int argc, char *argv[]) {
   // there are no watchers on the loop (except for the ones that were
   // uv_unref'd) then this function exits. As long as there are active
   // watchers, it blocks.
-  uv_run(uv_default_loop());
+  uv_run(Loop());
 
   EmitExit(process);
 
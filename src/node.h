@@ -75,8 +75,13 @@ void EmitExit(v8::Handle<v8::Object> process);
                 static_cast<v8::PropertyAttribute>(v8::ReadOnly|v8::DontDelete))
 
 #define NODE_SET_METHOD(obj, name, callback)                              \
-  obj->Set(v8::String::NewSymbol(name),                                   \
-           v8::FunctionTemplate::New(callback)->GetFunction())
+do {                                                                      \
+  v8::Local<v8::String> __callback##_NAME = v8::String::NewSymbol(name);  \
+  v8::Local<v8::Function> __callback##_FN =                               \
+    v8::FunctionTemplate::New(callback)->GetFunction();                   \
+  __callback##_FN->SetName(__callback##_NAME);                            \
+  obj->Set(__callback##_NAME, __callback##_FN);                           \
+} while (0)
 
 #define NODE_SET_PROTOTYPE_METHOD(templ, name, callback)                  \
 do {                                                                      \
@@ -191,6 +196,10 @@ node_module_struct* get_builtin_module(const char *name);
 #define NODE_MODULE_DECL(modname) \
   extern node::node_module_struct modname ## _module;
 
+// Returns the event loop that the calling code's handles and requests
+// belong to. Use this instead of uv_default_loop().
+uv_loop_t* Loop();
+
 void SetErrno(uv_err_code code);
 void MakeCallback(v8::Handle<v8::Object> object,
                   const char* method,
@@ -249,6 +249,51 @@
     stderr.write = process.binding('stdio').writeError;
     stderr.end = stderr.destroy = stderr.destroySoon = function() { };
 
+    // Hands stdout and stderr to a writer thread each, so that writes only
+    // copy into a ring buffer. Whatever is queued is written out on exit.
+    process.asyncStdio = function(options) {
+      var binding = process.binding('stdio');
+
+      if (!binding.startWriter) {
+        throw new Error('asyncStdio is not supported on ' + process.platform);
+      }
+
+      options = options || {};
+      var bufferSize = options.bufferSize || 1024 * 1024,
+          overflow = options.overflow || 'block';
+
+      binding.startWriter(binding.stdoutFD, bufferSize, overflow);
+      binding.startWriter(binding.stderrFD, bufferSize, overflow);
+
+      stdout = new EventEmitter();
+      stdout.writable = true;
+      stdout.readable = false;
+      stdout.end = function(data, encoding) {
+        if (data) stdout.write(data, encoding);
+      };
+      stdout.destroy = stdout.destroySoon = function() { };
+
+      asyncWriter(binding, stdout, binding.stdoutFD);
+      asyncWriter(binding, stderr, binding.stderrFD);
+    };
+
+    function asyncWriter(binding, stream, fd) {
+      stream.fd = fd;
+      stream.write = function(data, encoding) {
+        if (typeof data === 'string' &&
+            encoding && !/^utf-?8$/i.test(encoding)) {
+          var Buffer = NativeModule.require('buffer').Buffer;
+          data = new Buffer(data, encoding);
+        }
+        // A dropped write is not back pressure; there will be no 'drain'.
+        binding.writeAsync(fd, data);
+        return true;
+      };
+      stream.writerStats = function() {
+        return binding.writerStats(fd);
+      };
+    }
+
     process.__defineGetter__('stdin', function() {
       if (stdin) return stdin;
 
@@ -481,23 +526,28 @@
     return (id in NativeModule._source);
   }
 
+  // js2c stores the sources already wrapped (see NativeModule.wrapper), so
+  // that compile() can pass them to V8 without first copying them into a new
+  // string. This returns just the body of the module.
   NativeModule.getSource = function(id) {
     id = translateId(id);
-    return NativeModule._source[id];
+    var source = NativeModule._source[id];
+    return source.slice(NativeModule.wrapper[0].length,
+                        source.length - NativeModule.wrapper[1].length);
   }
 
   NativeModule.wrap = function(script) {
     return NativeModule.wrapper[0] + script + NativeModule.wrapper[1];
   };
 
+  // Also used by tools/js2c.py, keep the two in sync.
   NativeModule.wrapper = [
     '(function (exports, require, module, __filename, __dirname) { ',
     '\n});'
   ];
 
   NativeModule.prototype.compile = function() {
-    var source = NativeModule.getSource(this.id);
-    source = NativeModule.wrap(source);
+    var source = NativeModule._source[this.id];
 
     var fn = runInThisContext(source, this.filename, true);
     fn(this.exports, NativeModule.require, this, this.filename);
@@ -0,0 +1,188 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <node_async_queue.h>
+
+#include <assert.h>
+
+namespace node {
+
+using namespace v8;
+
+
+AsyncQueue::AsyncQueue(Handle<Object> object) {
+  HandleScope scope;
+
+  object_ = Persistent<Object>::New(object);
+
+  int r = uv_mpsc_init(Loop(), &mpsc_, OnBatch);
+  assert(r == 0);
+  mpsc_.async.data = this;
+}
+
+
+AsyncQueue::~AsyncQueue() {
+  object_.Dispose();
+  object_.Clear();
+}
+
+
+void AsyncQueue::Push(Item* item) {
+  uv_mpsc_push(&mpsc_, &item->link_.node);
+}
+
+
+void AsyncQueue::Close() {
+  uv_mpsc_node_t* nodes = uv_mpsc_take(&mpsc_);
+
+  while (nodes) {
+    Item* item = ItemFromNode(nodes);
+    nodes = nodes->next;
+    delete item;
+  }
+
+  uv_close(reinterpret_cast<uv_handle_t*>(&mpsc_), OnClose);
+}
+
+
+AsyncQueue::Item* AsyncQueue::ItemFromNode(uv_mpsc_node_t* node) {
+  return reinterpret_cast<Item::Link*>(node)->item;
+}
+
+
+void AsyncQueue::OnBatch(uv_mpsc_t* handle, uv_mpsc_node_t* nodes,
+                         int status) {
+  HandleScope scope;
+
+  AsyncQueue* queue = static_cast<AsyncQueue*>(handle->async.data);
+  assert(&queue->mpsc_ == handle);
+
+  uint32_t count = 0;
+  for (uv_mpsc_node_t* n = nodes; n; n = n->next) count++;
+
+  Local<Array> batch = Array::New(count);
+
+  for (uint32_t i = 0; nodes; i++) {
+    Item* item = ItemFromNode(nodes);
+    nodes = nodes->next;
+    batch->Set(i, item->ToValue());
+    delete item;
+  }
+
+  Local<Value> argv[1] = { batch };
+  MakeCallback(queue->object_, "onbatch", 1, argv);
+}
+
+
+void AsyncQueue::OnClose(uv_handle_t* handle) {
+  AsyncQueue* queue = static_cast<AsyncQueue*>(handle->data);
+  delete queue;
+}
+
+
+#ifdef NODE_TEST_BINDINGS
+// process.binding('async_queue').fill(object, workers, count) pushes the
+// numbers 0 .. workers * count - 1 onto a queue that delivers to
+// object.onbatch, `count` of them from each of `workers` threadpool jobs.
+// object.close() closes the queue. Only built with --with-test-bindings.
+class NumberItem : public AsyncQueue::Item {
+ public:
+  explicit NumberItem(double value) : value_(value) { }
+  Handle<Value> ToValue() { return Number::New(value_); }
+
+ private:
+  double value_;
+};
+
+
+struct FillWork {
+  uv_work_t req;
+  AsyncQueue* queue;
+  int first;
+  int count;
+};
+
+
+static void DoFill(uv_work_t* req) {
+  FillWork* work = static_cast<FillWork*>(req->data);
+  for (int i = 0; i < work->count; i++) {
+    work->queue->Push(new NumberItem(work->first + i));
+  }
+}
+
+
+static void AfterFill(uv_work_t* req, int status) {
+  delete static_cast<FillWork*>(req->data);
+}
+
+
+static Handle<Value> CloseQueue(const Arguments& args) {
+  HandleScope scope;
+  AsyncQueue* queue = static_cast<AsyncQueue*>(External::Unwrap(args.Data()));
+  queue->Close();
+  return Undefined();
+}
+
+
+static Handle<Value> Fill(const Arguments& args) {
+  HandleScope scope;
+
+  if (!args[0]->IsObject()) {
+    return ThrowException(Exception::TypeError(String::New("Bad argument")));
+  }
+
+  Local<Object> object = args[0]->ToObject();
+  int workers = args[1]->Int32Value();
+  int count = args[2]->Int32Value();
+
+  AsyncQueue* queue = new AsyncQueue(object);
+
+  for (int i = 0; i < workers; i++) {
+    FillWork* work = new FillWork;
+    work->req.data = work;
+    work->queue = queue;
+    work->first = i * count;
+    work->count = count;
+
+    int r = uv_queue_work(Loop(), &work->req, DoFill, AfterFill);
+    assert(r == 0);
+  }
+
+  Local<FunctionTemplate> close = FunctionTemplate::New(CloseQueue,
+                                                        External::Wrap(queue));
+  object->Set(String::NewSymbol("close"), close->GetFunction());
+
+  return Undefined();
+}
+
+
+void InitAsyncQueue(Handle<Object> target) {
+  HandleScope scope;
+  NODE_SET_METHOD(target, "fill", Fill);
+}
+#endif  // NODE_TEST_BINDINGS
+
+
+}  // namespace node
+
+#ifdef NODE_TEST_BINDINGS
+NODE_MODULE(node_async_queue, node::InitAsyncQueue);
+#endif
@@ -0,0 +1,87 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef SRC_NODE_ASYNC_QUEUE_H_
+#define SRC_NODE_ASYNC_QUEUE_H_
+
+#include <node.h>
+#include <uv.h>
+#include <v8.h>
+
+namespace node {
+
+// Hands results from other threads to JavaScript in batches. Threads push
+// items with Push(), which is lock-free. Once per loop iteration everything
+// pushed since the last batch is converted with Item::ToValue() and passed to
+// `object.onbatch(array)` in one call, oldest first.
+//
+//   struct Row : public node::AsyncQueue::Item {
+//     v8::Handle<v8::Value> ToValue() { ... }
+//   };
+//
+//   queue = new node::AsyncQueue(object);
+//   queue->Push(new Row(...));  // from any thread
+//   queue->Close();             // when done, on the loop thread
+//
+// An open queue keeps the event loop alive.
+class AsyncQueue {
+ public:
+  class Item {
+   public:
+    Item() { link_.item = this; }
+    virtual ~Item() { }
+
+    // Called on the loop thread. The item is deleted afterwards.
+    virtual v8::Handle<v8::Value> ToValue() = 0;
+
+   private:
+    // node must stay the first member; see AsyncQueue::ItemFromNode.
+    struct Link {
+      uv_mpsc_node_t node;
+      Item* item;
+    } link_;
+
+    friend class AsyncQueue;
+  };
+
+  explicit AsyncQueue(v8::Handle<v8::Object> object);
+
+  // Can be called from any thread. Takes ownership of `item`.
+  void Push(Item* item);
+
+  // Deletes whatever has not been delivered yet and frees the queue once
+  // libuv is done with it. Producers must have stopped pushing.
+  void Close();
+
+ private:
+  ~AsyncQueue();
+
+  static Item* ItemFromNode(uv_mpsc_node_t* node);
+  static void OnBatch(uv_mpsc_t* handle, uv_mpsc_node_t* nodes, int status);
+  static void OnClose(uv_handle_t* handle);
+
+  uv_mpsc_t mpsc_;
+  v8::Persistent<v8::Object> object_;
+};
+
+}  // namespace node
+
+#endif  // SRC_NODE_ASYNC_QUEUE_H_
@@ -37,6 +37,20 @@
 # include <arpa/inet.h> // htons, htonl
 #endif
 
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+// SSSE3 isn't part of the x86 baseline. The kernels that need it are built
+// for it with a target attribute and picked at run time.
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || __GNUC__ > 4 || \
+     (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+# define HAVE_SSSE3_DISPATCH 1
+# include <cpuid.h>
+# include <tmmintrin.h>
+#endif
+
 
 #define MIN(a,b) ((a) < (b) ? (a) : (b))
 
@@ -71,6 +85,86 @@ static Persistent<String> write_sym;
 Persistent<FunctionTemplate> Buffer::constructor_template;
 
 
+// Backing stores of up to 8 kB are rounded up to a power of two and recycled
+// through per-size-class free lists rather than going to new[]/delete[] for
+// every SlowBuffer. Each class keeps at most BUFFER_POOL_DEPTH blocks.
+#define BUFFER_POOL_MIN_SHIFT 4   // 16 bytes
+#define BUFFER_POOL_MAX_SHIFT 13  // 8 kB
+#define BUFFER_POOL_CLASSES (BUFFER_POOL_MAX_SHIFT - BUFFER_POOL_MIN_SHIFT + 1)
+#define BUFFER_POOL_DEPTH 256
+
+// External memory is reported to V8 in batches of this many bytes instead
+// of on every allocation and free.
+#define EXTERNAL_MEMORY_BATCH (256 * 1024)
+
+struct PoolBlock {
+  PoolBlock* next;
+};
+
+static PoolBlock* pool_free[BUFFER_POOL_CLASSES];
+static unsigned int pool_count[BUFFER_POOL_CLASSES];
+static int external_memory_delta;
+
+
+static inline int PoolClass(size_t length) {
+  if (length > (1 << BUFFER_POOL_MAX_SHIFT)) return -1;
+
+  int c = 0;
+  while (((size_t) 1 << (c + BUFFER_POOL_MIN_SHIFT)) < length) c++;
+  return c;
+}
+
+
+static char* AllocData(size_t length) {
+  int c = PoolClass(length);
+  if (c < 0) return new char[length];
+
+  PoolBlock* block = pool_free[c];
+  if (block) {
+    pool_free[c] = block->next;
+    pool_count[c]--;
+    return reinterpret_cast<char*>(block);
+  }
+
+  return new char[1 << (c + BUFFER_POOL_MIN_SHIFT)];
+}
+
+
+static void FreeData(char* data, size_t length) {
+  int c = PoolClass(length);
+
+  if (c < 0 || pool_count[c] >= BUFFER_POOL_DEPTH) {
+    delete [] data;
+    return;
+  }
+
+  PoolBlock* block = reinterpret_cast<PoolBlock*>(data);
+  block->next = pool_free[c];
+  pool_free[c] = block;
+  pool_count[c]++;
+}
+
+
+static inline void AdjustExternalMemory(int change_in_bytes) {
+  external_memory_delta += change_in_bytes;
+
+  if (external_memory_delta > EXTERNAL_MEMORY_BATCH ||
+      external_memory_delta < -EXTERNAL_MEMORY_BATCH) {
+    V8::AdjustAmountOfExternalAllocatedMemory(external_memory_delta);
+    external_memory_delta = 0;
+  }
+}
+
+
+// free_callback for Buffer::NewExternal(). The hint carries the size of the
+// block so it can be taken off the external allocation count again.
+static void FreeExternal(char* data, void* hint) {
+  size_t capacity = reinterpret_cast<size_t>(hint);
+  delete [] data;
+  AdjustExternalMemory(-static_cast<int>(sizeof(Buffer) + capacity));
+}
+
+
 static inline size_t base64_decoded_size(const char *src, size_t size) {
   const char *const end = src + size;
   const int remainder = size % 4;
@@ -168,6 +262,34 @@ Buffer* Buffer::New(char *data, size_t length,
 }
 
 
+// Adopts `data`, which must have been allocated with new[], without copying
+// it. The memory is released with delete[] when the buffer is collected.
+Buffer* Buffer::NewExternal(char* data, size_t length) {
+  return NewExternal(data, length, length);
+}
+
+
+Buffer* Buffer::NewExternal(char* data, size_t length, size_t capacity) {
+  assert(length <= capacity);
+  Buffer *buffer = New(data, length, FreeExternal,
+                       reinterpret_cast<void*>(capacity));
+  AdjustExternalMemory(sizeof(Buffer) + capacity);
+  return buffer;
+}
+
+
+bool Buffer::OwnedBy(Handle<Object> obj, free_callback callback) {
+  return ObjectWrap::Unwrap<Buffer>(obj)->callback_ == callback;
+}
+
+
+void* Buffer::Hint(Handle<Object> obj, free_callback callback) {
+  Buffer *buffer = ObjectWrap::Unwrap<Buffer>(obj);
+  if (buffer->callback_ != callback) return NULL;
+  return buffer->callback_hint_;
+}
+
+
 Handle<Value> Buffer::New(const Arguments &args) {
   if (!args.IsConstructCall()) {
     return FromConstructorTemplate(constructor_template, args);
@@ -209,8 +331,8 @@ void Buffer::Replace(char *data, size_t length,
   if (callback_) {
     callback_(data_, callback_hint_);
   } else if (length_) {
-    delete [] data_;
-    V8::AdjustAmountOfExternalAllocatedMemory(-(sizeof(Buffer) + length_));
+    FreeData(data_, length_);
+    AdjustExternalMemory(-(sizeof(Buffer) + length_));
   }
 
   length_ = length;
@@ -220,10 +342,10 @@ void Buffer::Replace(char *data, size_t length,
   if (callback_) {
     data_ = data;
   } else if (length_) {
-    data_ = new char[length_];
+    data_ = AllocData(length_);
     if (data)
       memcpy(data_, data, length_);
-    V8::AdjustAmountOfExternalAllocatedMemory(sizeof(Buffer) + length_);
+    AdjustExternalMemory(sizeof(Buffer) + length_);
   } else {
     data_ = NULL;
   }
@@ -303,6 +425,117 @@ static const int unbase64_table[] =
 #define unbase64(x) unbase64_table[(uint8_t)(x)]
 
 
+#ifdef HAVE_SSSE3_DISPATCH
+static bool HasSSSE3() {
+  static int has_ssse3 = -1;
+  if (has_ssse3 == -1) {
+    unsigned int a, b, c, d;
+    has_ssse3 = (__get_cpuid(1, &a, &b, &c, &d) && (c & bit_SSSE3)) ? 1 : 0;
+  }
+  return has_ssse3 == 1;
+}
+
+
+// Twelve bytes to sixteen characters per step: shuffle each group of three
+// bytes into place, split it into four 6-bit indices with two multiplies and
+// map the indices onto the alphabet with a 16-entry pshufb table. Returns
+// the number of bytes encoded; the caller finishes the rest.
+__attribute__((target("ssse3")))
+static size_t Base64EncodeSSSE3(const uint8_t *src, size_t len, char *dst) {
+  const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                       4, 5, 3, 4, 1, 2, 0, 1);
+  const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '+' - 62,
+                                        '/' - 63, 'A', 0, 0);
+  size_t i = 0;
+
+  // Each step loads sixteen bytes but only uses twelve.
+  for (; i + 16 <= len; i += 12) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    in = _mm_shuffle_epi8(in, shuffle);
+
+    __m128i hi = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+                                 _mm_set1_epi32(0x04000040));
+    __m128i lo = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+                                 _mm_set1_epi32(0x01000010));
+    __m128i index = _mm_or_si128(hi, lo);
+
+    // 0-25 -> 13, 26-51 -> 0, 52-61 -> 1-10, 62 -> 11, 63 -> 12.
+    __m128i range = _mm_subs_epu8(index, _mm_set1_epi8(51));
+    __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), index);
+    range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+
+    __m128i chars = _mm_add_epi8(index, _mm_shuffle_epi8(offsets, range));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), chars);
+    dst += 16;
+  }
+
+  return i;
+}
+
+
+__attribute__((target("ssse3")))
+static inline __m128i InRange(__m128i c, char lo, char hi) {
+  return _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8(lo - 1)),
+                       _mm_cmplt_epi8(c, _mm_set1_epi8(hi + 1)));
+}
+
+
+// Sixteen characters to twelve bytes per step. Stops at the first block
+// holding anything but the 64 alphabet characters (whitespace, padding,
+// garbage) and returns the number of characters decoded, so the scalar
+// loop can take over from there.
+__attribute__((target("ssse3")))
+static size_t Base64DecodeSSSE3(const char *src, size_t len, char *dst) {
+  const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+                                     8, 14, 13, 12, -1, -1, -1, -1);
+  size_t i = 0;
+
+  for (; i + 16 <= len; i += 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+    // Bytes >= 0x80 compare as negative and fall in none of the ranges.
+    __m128i upper = InRange(in, 'A', 'Z');
+    __m128i lower = InRange(in, 'a', 'z');
+    __m128i digit = InRange(in, '0', '9');
+    __m128i plus = _mm_cmpeq_epi8(in, _mm_set1_epi8('+'));
+    __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+
+    __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                                 _mm_or_si128(digit,
+                                              _mm_or_si128(plus, slash)));
+    if (_mm_movemask_epi8(valid) != 0xFFFF) break;
+
+    __m128i shift = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                     _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+        _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                     _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62 - '+')),
+                                  _mm_and_si128(slash,
+                                                _mm_set1_epi8(63 - '/')))));
+    __m128i values = _mm_add_epi8(in, shift);
+
+    // Merge pairs of 6-bit values into 12 bits, then pairs of those into
+    // 24, and pull the three bytes of every dword out in big-endian order.
+    __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+
+    // Only twelve of the sixteen bytes are data; don't let the other four
+    // land past the end of what gets decoded.
+    char out[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm_shuffle_epi8(quads, pack));
+    memcpy(dst, out, 12);
+    dst += 12;
+  }
+
+  return i;
+}
+#endif  // HAVE_SSSE3_DISPATCH
+
+
 Handle<Value> Buffer::Base64Slice(const Arguments &args) {
   HandleScope scope;
   Buffer *parent = ObjectWrap::Unwrap<Buffer>(args.This());
@@ -312,64 +545,109 @@ Handle<Value> Buffer::Base64Slice(const Arguments &args) {
   int out_len = (n + 2 - ((n + 2) % 3)) / 3 * 4;
   char *out = new char[out_len];
 
-  uint8_t bitbuf[3];
-  int i = start; // data() index
+  const uint8_t *src = reinterpret_cast<uint8_t*>(parent->data_ + start);
+  int i = 0; // src index
   int j = 0; // out index
-  char c;
-  bool b1_oob, b2_oob;
-
-  while (i < end) {
-    bitbuf[0] = parent->data_[i++];
-
-    if (i < end) {
-      bitbuf[1] = parent->data_[i];
-      b1_oob = false;
-    }  else {
-      bitbuf[1] = 0;
-      b1_oob = true;
-    }
-    i++;
-
-    if (i < end) {
-      bitbuf[2] = parent->data_[i];
-      b2_oob = false;
-    }  else {
-      bitbuf[2] = 0;
-      b2_oob = true;
-    }
-    i++;
 
+#ifdef HAVE_SSSE3_DISPATCH
+  if (HasSSSE3()) {
+    i = Base64EncodeSSSE3(src, n, out);
+    j = i / 3 * 4;
+  }
+#endif
 
-    c = bitbuf[0] >> 2;
-    assert(c < 64);
-    out[j++] = base64_table[(int)c];
-    assert(j < out_len);
+  // Whole groups of three bytes map onto four characters without any
+  // bounds checks or padding decisions.
+  for (; i + 3 <= n; i += 3) {
+    uint32_t bits = (src[i] << 16) | (src[i + 1] << 8) | src[i + 2];
+    out[j++] = base64_table[bits >> 18];
+    out[j++] = base64_table[(bits >> 12) & 0x3F];
+    out[j++] = base64_table[(bits >> 6) & 0x3F];
+    out[j++] = base64_table[bits & 0x3F];
+  }
 
-    c = ((bitbuf[0] & 0x03) << 4) | (bitbuf[1] >> 4);
-    assert(c < 64);
-    out[j++] = base64_table[(int)c];
-    assert(j < out_len);
+  if (n - i == 1) {
+    out[j++] = base64_table[src[i] >> 2];
+    out[j++] = base64_table[(src[i] & 0x03) << 4];
+    out[j++] = '=';
+    out[j++] = '=';
+  } else if (n - i == 2) {
+    out[j++] = base64_table[src[i] >> 2];
+    out[j++] = base64_table[((src[i] & 0x03) << 4) | (src[i + 1] >> 4)];
+    out[j++] = base64_table[(src[i + 1] & 0x0F) << 2];
+    out[j++] = '=';
+  }
+  assert(j == out_len);
 
-    if (b1_oob) {
-      out[j++] = '=';
-    } else {
-      c = ((bitbuf[1] & 0x0F) << 2) | (bitbuf[2] >> 6);
-      assert(c < 64);
-      out[j++] = base64_table[(int)c];
-    }
-    assert(j < out_len);
+  Local<String> string = String::New(out, out_len);
+  delete [] out;
+  return scope.Close(string);
+}
 
-    if (b2_oob) {
-      out[j++] = '=';
-    } else {
-      c = bitbuf[2] & 0x3F;
-      assert(c < 64);
-      out[j++]  = base64_table[(int)c];
-    }
-    assert(j <= out_len);
+
+static const char hex_table[] = "0123456789abcdef";
+
+
+static inline int unhex(uint8_t c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  c |= 0x20;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+
+static void HexEncode(const uint8_t *src, size_t len, char *dst) {
+  size_t i = 0;
+
+#ifdef __SSE2__
+  // Sixteen bytes at a time: split into nibbles, interleave high/low and
+  // map 0-9 onto '0'-'9' and 10-15 onto 'a'-'f'.
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  const __m128i nine = _mm_set1_epi8(9);
+  const __m128i digit = _mm_set1_epi8('0');
+  const __m128i alpha = _mm_set1_epi8('a' - '0' - 10);
+
+  for (; i + 16 <= len; i += 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), nibble);
+    __m128i lo = _mm_and_si128(in, nibble);
+    __m128i a = _mm_unpacklo_epi8(hi, lo);
+    __m128i b = _mm_unpackhi_epi8(hi, lo);
+    a = _mm_add_epi8(a, _mm_add_epi8(digit,
+        _mm_and_si128(_mm_cmpgt_epi8(a, nine), alpha)));
+    b = _mm_add_epi8(b, _mm_add_epi8(digit,
+        _mm_and_si128(_mm_cmpgt_epi8(b, nine), alpha)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), a);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 16), b);
   }
+#endif
 
-  Local<String> string = String::New(out, out_len);
+  for (; i < len; i++) {
+    dst[2 * i] = hex_table[src[i] >> 4];
+    dst[2 * i + 1] = hex_table[src[i] & 0x0F];
+  }
+}
+
+
+// buffer.hexSlice(start, end);
+Handle<Value> Buffer::HexSlice(const Arguments &args) {
+  HandleScope scope;
+  Buffer *parent = ObjectWrap::Unwrap<Buffer>(args.This());
+
+  // Out of range arguments are clamped rather than rejected, like the
+  // JavaScript implementation this replaces.
+  int32_t start = args[0]->Int32Value();
+  int32_t end = args[1]->Int32Value();
+  if (start < 0) start = 0;
+  if (end <= 0 || (size_t)end > parent->length_) end = parent->length_;
+  if (start >= end) return scope.Close(String::Empty());
+
+  size_t n = end - start;
+  char *out = new char[n * 2];
+
+  HexEncode(reinterpret_cast<uint8_t*>(parent->data_ + start), n, out);
+
+  Local<String> string = String::New(out, n * 2);
   delete [] out;
   return scope.Close(string);
 }
@@ -455,6 +733,87 @@ Handle<Value> Buffer::Copy(const Arguments &args) {
 }
 
 
+// var bytesCopied = SlowBuffer.concat(list, target);
+// Copies every buffer in `list` back to back into `target` in one call.
+Handle<Value> Buffer::Concat(const Arguments &args) {
+  HandleScope scope;
+
+  if (!args[0]->IsArray()) {
+    return ThrowException(Exception::TypeError(String::New(
+            "First argument must be an Array")));
+  }
+
+  if (!Buffer::HasInstance(args[1])) {
+    return ThrowException(Exception::TypeError(String::New(
+            "Second argument must be a Buffer")));
+  }
+
+  Local<Array> list = Local<Array>::Cast(args[0]);
+  Local<Object> target = args[1]->ToObject();
+  char *target_data = Buffer::Data(target);
+  size_t target_length = Buffer::Length(target);
+  size_t copied = 0;
+
+  for (uint32_t i = 0; i < list->Length() && copied < target_length; i++) {
+    Local<Value> chunk = list->Get(i);
+    if (!Buffer::HasInstance(chunk)) {
+      return ThrowException(Exception::TypeError(String::New(
+              "List must contain only Buffers")));
+    }
+
+    Local<Object> chunk_obj = chunk->ToObject();
+    size_t to_copy = MIN(Buffer::Length(chunk_obj), target_length - copied);
+    memcpy(target_data + copied, Buffer::Data(chunk_obj), to_copy);
+    copied += to_copy;
+  }
+
+  return scope.Close(Integer::New(copied));
+}
+
+
+// Copies the first `length` characters of `s` to `dst` as long as they are
+// all ASCII, which is then also their UTF-8 encoding. This goes through
+// String::Write, a flat copy, instead of WriteUtf8's per-character encoder.
+// Returns false at the first block holding a wider character. Only the
+// ASCII prefix before it has been written then, which WriteUtf8 rewrites
+// with the same bytes.
+static bool WriteAsciiOnly(Handle<String> s, char *dst, int length) {
+  uint16_t chunk[1024];
+  int pos = 0;
+
+  while (pos < length) {
+    int n = MIN(length - pos, (int)ARRAY_SIZE(chunk));
+    s->Write(chunk, pos, n, String::HINT_MANY_WRITES_EXPECTED |
+                            String::NO_NULL_TERMINATION);
+    int i = 0;
+
+#ifdef __SSE2__
+    const __m128i high = _mm_set1_epi16((short)0xFF80);
+    for (; i + 16 <= n; i += 16) {
+      __m128i a = _mm_loadu_si128(reinterpret_cast<__m128i*>(chunk + i));
+      __m128i b = _mm_loadu_si128(reinterpret_cast<__m128i*>(chunk + i + 8));
+      __m128i wide = _mm_and_si128(_mm_or_si128(a, b), high);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(wide, _mm_setzero_si128())) !=
+          0xFFFF) {
+        return false;
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pos + i),
+                       _mm_packus_epi16(a, b));
+    }
+#endif
+
+    uint16_t bits = 0;
+    for (int j = i; j < n; j++) bits |= chunk[j];
+    if (bits & 0xFF80) return false;
+    for (; i < n; i++) dst[pos + i] = chunk[i];
+
+    pos += n;
+  }
+
+  return true;
+}
+
+
 // var charsWritten = buffer.utf8Write(string, offset, [maxLength]);
 Handle<Value> Buffer::Utf8Write(const Arguments &args) {
   HandleScope scope;
@@ -488,6 +847,14 @@ Handle<Value> Buffer::Utf8Write(const Arguments &args) {
 
   char* p = buffer->data_ + offset;
 
+  // Pure ASCII strings, the common case, need one byte per character.
+  int ascii_length = MIN((size_t)length, max_length);
+  if (WriteAsciiOnly(s, p, ascii_length)) {
+    constructor_template->GetFunction()->Set(chars_written_sym,
+                                             Integer::New(ascii_length));
+    return scope.Close(Integer::New(ascii_length));
+  }
+
   int char_written;
 
   int written = s->WriteUtf8(p,
@@ -633,6 +1000,28 @@ Handle<Value> Buffer::Base64Write(const Arguments &args) {
   const char *src = *s;
   const char *const srcEnd = src + s.length();
 
+#ifdef HAVE_SSSE3_DISPATCH
+  if (HasSSSE3()) {
+    size_t decoded = Base64DecodeSSSE3(src, s.length(), dst);
+    src += decoded;
+    dst += decoded / 4 * 3;
+  }
+#endif
+
+  // Fast path: groups of four valid characters. Whitespace, padding and
+  // illegal characters drop through to the general loop below.
+  while (srcEnd - src >= 4) {
+    int v0 = unbase64(src[0]);
+    int v1 = unbase64(src[1]);
+    int v2 = unbase64(src[2]);
+    int v3 = unbase64(src[3]);
+    if ((v0 | v1 | v2 | v3) < 0) break;
+    *dst++ = (v0 << 2) | (v1 >> 4);
+    *dst++ = (v1 << 4) | (v2 >> 2);
+    *dst++ = (v2 << 6) | v3;
+    src += 4;
+  }
+
   while (src < srcEnd) {
     int remaining = srcEnd - src;
 
@@ -675,6 +1064,58 @@ Handle<Value> Buffer::Base64Write(const Arguments &args) {
 }
 
 
+// var bytesWritten = buffer.hexWrite(string, offset, [maxLength]);
+Handle<Value> Buffer::HexWrite(const Arguments &args) {
+  HandleScope scope;
+
+  Buffer *buffer = ObjectWrap::Unwrap<Buffer>(args.This());
+
+  if (!args[0]->IsString()) {
+    return ThrowException(Exception::TypeError(String::New(
+            "Argument must be a string")));
+  }
+
+  String::AsciiValue s(args[0]->ToString());
+  size_t offset = args[1]->Uint32Value();
+
+  if (s.length() > 0 && offset >= buffer->length_) {
+    return ThrowException(Exception::TypeError(String::New(
+            "Offset is out of bounds")));
+  }
+
+  // must be an even number of digits
+  if (s.length() % 2) {
+    return ThrowException(Exception::Error(String::New(
+            "Invalid hex string")));
+  }
+
+  size_t max_length = args[2]->Uint32Value();
+  if (max_length == 0 || max_length > buffer->length_ - offset) {
+    max_length = buffer->length_ - offset;
+  }
+  max_length = MIN(max_length, (size_t)s.length() / 2);
+
+  const uint8_t *src = reinterpret_cast<const uint8_t*>(*s);
+  uint8_t *dst = reinterpret_cast<uint8_t*>(buffer->data_ + offset);
+  size_t i;
+
+  for (i = 0; i < max_length; i++) {
+    int hi = unhex(src[i * 2]);
+    int lo = unhex(src[i * 2 + 1]);
+    if ((hi | lo) < 0) {
+      return ThrowException(Exception::Error(String::New(
+              "Invalid hex string")));
+    }
+    dst[i] = (hi << 4) | lo;
+  }
+
+  constructor_template->GetFunction()->Set(chars_written_sym,
+                                           Integer::New(i * 2));
+
+  return scope.Close(Integer::New(i));
+}
+
+
 Handle<Value> Buffer::BinaryWrite(const Arguments &args) {
   HandleScope scope;
 
@@ -761,6 +1202,147 @@ bool Buffer::HasInstance(v8::Handle<v8::Value> val) {
 }
 
 
+static inline bool IsBigEndian() {
+  const union { uint16_t u16; uint8_t u8[2]; } probe = { 1 };
+  return probe.u8[0] == 0;
+}
+
+
+static inline void SwapBytes(char* data, size_t size) {
+  for (size_t i = 0; i < size / 2; i++) {
+    char c = data[i];
+    data[i] = data[size - 1 - i];
+    data[size - 1 - i] = c;
+  }
+}
+
+
+// Offsets come from lib/buffer.js, which has checked them unless told not
+// to. This keeps noAssert from reading or writing outside the SlowBuffer.
+#define CHECK_OFFSET(offset, size, parent)                           \
+  if (!((offset) >= 0 && (offset) + (size) <= (parent)->length_)) {  \
+    return ThrowException(Exception::RangeError(                     \
+          String::New("Trying to access beyond buffer length")));    \
+  }
+
+
+// var value = buffer.readFloatLE(offset);
+template <typename T, bool ENDIANNESS_BIG>
+Handle<Value> Buffer::ReadFloatGeneric(const Arguments &args) {
+  HandleScope scope;
+
+  Buffer *parent = ObjectWrap::Unwrap<Buffer>(args.This());
+  double offset = args[0]->NumberValue();
+  CHECK_OFFSET(offset, sizeof(T), parent)
+
+  union { T value; char bytes[sizeof(T)]; } u;
+  memcpy(u.bytes, parent->data_ + static_cast<size_t>(offset), sizeof(T));
+  if (ENDIANNESS_BIG != IsBigEndian()) SwapBytes(u.bytes, sizeof(T));
+
+  return scope.Close(Number::New(u.value));
+}
+
+
+// buffer.writeFloatLE(value, offset);
+template <typename T, bool ENDIANNESS_BIG>
+Handle<Value> Buffer::WriteFloatGeneric(const Arguments &args) {
+  HandleScope scope;
+
+  Buffer *parent = ObjectWrap::Unwrap<Buffer>(args.This());
+  double offset = args[1]->NumberValue();
+  CHECK_OFFSET(offset, sizeof(T), parent)
+
+  union { T value; char bytes[sizeof(T)]; } u;
+  u.value = static_cast<T>(args[0]->NumberValue());
+  if (ENDIANNESS_BIG != IsBigEndian()) SwapBytes(u.bytes, sizeof(T));
+  memcpy(parent->data_ + static_cast<size_t>(offset), u.bytes, sizeof(T));
+
+  return Undefined();
+}
+
+
+static size_t ElementSize(ExternalArrayType type) {
+  switch (type) {
+    case kExternalByteArray:
+    case kExternalUnsignedByteArray:
+    case kExternalPixelArray:
+      return 1;
+    case kExternalShortArray:
+    case kExternalUnsignedShortArray:
+      return 2;
+    case kExternalIntArray:
+    case kExternalUnsignedIntArray:
+    case kExternalFloatArray:
+      return 4;
+    case kExternalDoubleArray:
+      return 8;
+  }
+  return 0;
+}
+
+
+#define ARRAY_ARGS(offset_arg, array_arg, little_endian_arg)           \
+  if (!array_arg->IsObject() ||                                        \
+      !array_arg->ToObject()->HasIndexedPropertiesInExternalArrayData()) { \
+    return ThrowException(Exception::TypeError(                        \
+          String::New("Argument must be a typed array")));             \
+  }                                                                    \
+  Local<Object> array = array_arg->ToObject();                         \
+  size_t size = ElementSize(                                           \
+      array->GetIndexedPropertiesExternalArrayDataType());             \
+  size_t count = array->GetIndexedPropertiesExternalArrayDataLength(); \
+  char *array_data =                                                   \
+      static_cast<char*>(array->GetIndexedPropertiesExternalArrayData()); \
+  double offset = offset_arg->NumberValue();                           \
+  CHECK_OFFSET(offset, size * count, parent)                           \
+  char *data = parent->data_ + static_cast<size_t>(offset);            \
+  bool swap = size > 1 && little_endian_arg->BooleanValue() == IsBigEndian();
+
+
+// Fills a typed array with consecutive values read from the buffer. The
+// element type of the array decides how the bytes are read; the byte order
+// is big endian unless littleEndian is set, as with DataView.
+//
+// buffer.readArray(offset, array, littleEndian);
+Handle<Value> Buffer::ReadArray(const Arguments &args) {
+  HandleScope scope;
+
+  Buffer *parent = ObjectWrap::Unwrap<Buffer>(args.This());
+  ARRAY_ARGS(args[0], args[1], args[2])
+
+  memcpy(array_data, data, size * count);
+
+  if (swap) {
+    for (size_t i = 0; i < count; i++) {
+      SwapBytes(array_data + i * size, size);
+    }
+  }
+
+  return scope.Close(array);
+}
+
+
+// The reverse of readArray(); returns the number of bytes written.
+//
+// buffer.writeArray(offset, array, littleEndian);
+Handle<Value> Buffer::WriteArray(const Arguments &args) {
+  HandleScope scope;
+
+  Buffer *parent = ObjectWrap::Unwrap<Buffer>(args.This());
+  ARRAY_ARGS(args[0], args[1], args[2])
+
+  memcpy(data, array_data, size * count);
+
+  if (swap) {
+    for (size_t i = 0; i < count; i++) {
+      SwapBytes(data + i * size, size);
+    }
+  }
+
+  return scope.Close(Integer::NewFromUnsigned(size * count));
+}
+
+
 void Buffer::Initialize(Handle<Object> target) {
   HandleScope scope;
 
@@ -777,6 +1359,7 @@ void Buffer::Initialize(Handle<Object> target) {
   NODE_SET_PROTOTYPE_METHOD(constructor_template, "asciiSlice", Buffer::AsciiSlice);
   NODE_SET_PROTOTYPE_METHOD(constructor_template, "base64Slice", Buffer::Base64Slice);
   NODE_SET_PROTOTYPE_METHOD(constructor_template, "ucs2Slice", Buffer::Ucs2Slice);
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "hexSlice", Buffer::HexSlice);
   // TODO NODE_SET_PROTOTYPE_METHOD(t, "utf16Slice", Utf16Slice);
   // copy
   NODE_SET_PROTOTYPE_METHOD(constructor_template, "utf8Slice", Buffer::Utf8Slice);
@@ -786,15 +1369,40 @@ void Buffer::Initialize(Handle<Object> target) {
   NODE_SET_PROTOTYPE_METHOD(constructor_template, "binaryWrite", Buffer::BinaryWrite);
   NODE_SET_PROTOTYPE_METHOD(constructor_template, "base64Write", Buffer::Base64Write);
   NODE_SET_PROTOTYPE_METHOD(constructor_template, "ucs2Write", Buffer::Ucs2Write);
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "hexWrite", Buffer::HexWrite);
   NODE_SET_PROTOTYPE_METHOD(constructor_template, "fill", Buffer::Fill);
   NODE_SET_PROTOTYPE_METHOD(constructor_template, "copy", Buffer::Copy);
 
+  // The commas in the template arguments would split the macro arguments.
+  InvocationCallback read_float_le = Buffer::ReadFloatGeneric<float, false>;
+  InvocationCallback read_float_be = Buffer::ReadFloatGeneric<float, true>;
+  InvocationCallback read_double_le = Buffer::ReadFloatGeneric<double, false>;
+  InvocationCallback read_double_be = Buffer::ReadFloatGeneric<double, true>;
+  InvocationCallback write_float_le = Buffer::WriteFloatGeneric<float, false>;
+  InvocationCallback write_float_be = Buffer::WriteFloatGeneric<float, true>;
+  InvocationCallback write_double_le = Buffer::WriteFloatGeneric<double, false>;
+  InvocationCallback write_double_be = Buffer::WriteFloatGeneric<double, true>;
+
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "readFloatLE", read_float_le);
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "readFloatBE", read_float_be);
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "readDoubleLE", read_double_le);
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "readDoubleBE", read_double_be);
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "writeFloatLE", write_float_le);
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "writeFloatBE", write_float_be);
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "writeDoubleLE", write_double_le);
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "writeDoubleBE", write_double_be);
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "readArray", Buffer::ReadArray);
+  NODE_SET_PROTOTYPE_METHOD(constructor_template, "writeArray", Buffer::WriteArray);
+
   NODE_SET_METHOD(constructor_template->GetFunction(),
                   "byteLength",
                   Buffer::ByteLength);
   NODE_SET_METHOD(constructor_template->GetFunction(),
                   "makeFastBuffer",
                   Buffer::MakeFastBuffer);
+  NODE_SET_METHOD(constructor_template->GetFunction(),
+                  "concat",
+                  Buffer::Concat);
 
   target->Set(String::NewSymbol("SlowBuffer"), constructor_template->GetFunction());
 }
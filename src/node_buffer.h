@@ -97,6 +97,16 @@ class Buffer : public ObjectWrap {
   static Buffer* New(char *data, size_t len); // public constructor
   static Buffer* New(char *data, size_t length,
                      free_callback callback, void *hint); // public constructor
+  // Takes ownership of `data` (allocated with new[]) instead of copying it.
+  static Buffer* NewExternal(char *data, size_t length);
+  // Same, for a block of `capacity` bytes of which the first `length` are
+  // used. The whole block is counted as external memory.
+  static Buffer* NewExternal(char *data, size_t length, size_t capacity);
+  // True if the buffer's memory was handed over with `callback`.
+  static bool OwnedBy(v8::Handle<v8::Object> obj, free_callback callback);
+  // The hint the buffer was created with, or NULL if its memory isn't owned
+  // by `callback`.
+  static void* Hint(v8::Handle<v8::Object> obj, free_callback callback);
 
   private:
   static v8::Persistent<v8::FunctionTemplate> constructor_template;
@@ -107,15 +117,24 @@ class Buffer : public ObjectWrap {
   static v8::Handle<v8::Value> Base64Slice(const v8::Arguments &args);
   static v8::Handle<v8::Value> Utf8Slice(const v8::Arguments &args);
   static v8::Handle<v8::Value> Ucs2Slice(const v8::Arguments &args);
+  static v8::Handle<v8::Value> HexSlice(const v8::Arguments &args);
   static v8::Handle<v8::Value> BinaryWrite(const v8::Arguments &args);
   static v8::Handle<v8::Value> Base64Write(const v8::Arguments &args);
   static v8::Handle<v8::Value> AsciiWrite(const v8::Arguments &args);
   static v8::Handle<v8::Value> Utf8Write(const v8::Arguments &args);
   static v8::Handle<v8::Value> Ucs2Write(const v8::Arguments &args);
+  static v8::Handle<v8::Value> HexWrite(const v8::Arguments &args);
   static v8::Handle<v8::Value> ByteLength(const v8::Arguments &args);
   static v8::Handle<v8::Value> MakeFastBuffer(const v8::Arguments &args);
   static v8::Handle<v8::Value> Fill(const v8::Arguments &args);
   static v8::Handle<v8::Value> Copy(const v8::Arguments &args);
+  static v8::Handle<v8::Value> Concat(const v8::Arguments &args);
+  template <typename T, bool ENDIANNESS_BIG>
+  static v8::Handle<v8::Value> ReadFloatGeneric(const v8::Arguments &args);
+  template <typename T, bool ENDIANNESS_BIG>
+  static v8::Handle<v8::Value> WriteFloatGeneric(const v8::Arguments &args);
+  static v8::Handle<v8::Value> ReadArray(const v8::Arguments &args);
+  static v8::Handle<v8::Value> WriteArray(const v8::Arguments &args);
 
   Buffer(v8::Handle<v8::Object> wrapper, size_t length);
   void Replace(char *data, size_t length, free_callback callback, void *hint);
@@ -891,7 +891,7 @@ Handle<Value> Connection::EncIn(const Arguments& args) {
   size_t len = args[2]->Int32Value();
   if (off + len > buffer_length) {
     return ThrowException(Exception::Error(
-          String::New("Length is extends beyond buffer")));
+          String::New("Length extends beyond buffer")));
   }
 
   int bytes_written = BIO_write(ss->bio_read_, buffer_data + off, len);
@@ -930,7 +930,7 @@ Handle<Value> Connection::ClearOut(const Arguments& args) {
   size_t len = args[2]->Int32Value();
   if (off + len > buffer_length) {
     return ThrowException(Exception::Error(
-          String::New("Length is extends beyond buffer")));
+          String::New("Length extends beyond buffer")));
   }
 
   if (!SSL_is_init_finished(ss->ssl_)) {
@@ -1003,7 +1003,7 @@ Handle<Value> Connection::EncOut(const Arguments& args) {
   size_t len = args[2]->Int32Value();
   if (off + len > buffer_length) {
     return ThrowException(Exception::Error(
-          String::New("Length is extends beyond buffer")));
+          String::New("Length extends beyond buffer")));
   }
 
   int bytes_read = BIO_read(ss->bio_write_, buffer_data + off, len);
@@ -1043,7 +1043,7 @@ Handle<Value> Connection::ClearIn(const Arguments& args) {
   size_t len = args[2]->Int32Value();
   if (off + len > buffer_length) {
     return ThrowException(Exception::Error(
-          String::New("Length is extends beyond buffer")));
+          String::New("Length extends beyond buffer")));
   }
 
   if (!SSL_is_init_finished(ss->ssl_)) {
@@ -2815,6 +2815,32 @@ class Hash : public ObjectWrap {
 
     Hash *hash = ObjectWrap::Unwrap<Hash>(args.This());
 
+    // An array of buffers, or a BufferList's, is hashed in order without
+    // concatenating it first.
+    Local<Value> data = args[0];
+    if (data->IsObject() && !data->IsArray() && !Buffer::HasInstance(data)) {
+      Local<Value> buffers = data->ToObject()->Get(String::NewSymbol("buffers"));
+      if (buffers->IsArray()) data = buffers;
+    }
+
+    if (data->IsArray()) {
+      Local<Array> chunks = Local<Array>::Cast(data);
+      for (uint32_t i = 0; i < chunks->Length(); i++) {
+        Local<Value> chunk = chunks->Get(i);
+        if (!Buffer::HasInstance(chunk)) {
+          Local<Value> exception = Exception::TypeError(String::New("Bad argument"));
+          return ThrowException(exception);
+        }
+        Local<Object> buffer_obj = chunk->ToObject();
+        if (!hash->HashUpdate(Buffer::Data(buffer_obj),
+                              Buffer::Length(buffer_obj))) {
+          Local<Value> exception = Exception::TypeError(String::New("HashUpdate fail"));
+          return ThrowException(exception);
+        }
+      }
+      return args.This();
+    }
+
     ASSERT_IS_STRING_OR_BUFFER(args[0]);
     enum encoding enc = ParseEncoding(args[1]);
     ssize_t len = DecodeBytes(args[0], enc);
@@ -3910,7 +3936,7 @@ EIO_PBKDF2(uv_work_t* req) {
 }
 
 void
-EIO_PBKDF2After(uv_work_t* req) {
+EIO_PBKDF2After(uv_work_t* req, int status) {
   HandleScope scope;
 
   pbkdf2_req* request = (pbkdf2_req*)req->data;
@@ -3994,7 +4020,7 @@ PBKDF2(const Arguments& args) {
 
   uv_work_t* req = new uv_work_t();
   req->data = request;
-  uv_queue_work(uv_default_loop(), req, EIO_PBKDF2, EIO_PBKDF2After);
+  uv_queue_work(Loop(), req, EIO_PBKDF2, EIO_PBKDF2After);
 
   return Undefined();
 }
@@ -24,6 +24,85 @@
 
 #ifdef HAVE_DTRACE
 #include "node_provider.h"
+#elif HAVE_SYSTEMTAP
+/*
+ * On Linux the probes of node_provider.d are emitted as systemtap-style USDT
+ * probes, which perf, systemtap and bpftrace all understand. Each probe has
+ * a semaphore that the tracer bumps when it attaches, so a probe nobody is
+ * looking at costs a load and a branch. There are no translators here, so
+ * the probes take the interesting fields as plain arguments rather than the
+ * structures node.d expects.
+ */
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+#define NODE_SEMAPHORE(name) node_##name##_semaphore
+
+extern "C" {
+#define NODE_DEFINE_SEMAPHORE(name) \
+  unsigned short NODE_SEMAPHORE(name) __attribute__((section(".probes")));
+NODE_DEFINE_SEMAPHORE(net__server__connection)
+NODE_DEFINE_SEMAPHORE(net__stream__end)
+NODE_DEFINE_SEMAPHORE(net__socket__read)
+NODE_DEFINE_SEMAPHORE(net__socket__write)
+NODE_DEFINE_SEMAPHORE(http__server__request)
+NODE_DEFINE_SEMAPHORE(http__server__response)
+NODE_DEFINE_SEMAPHORE(http__client__request)
+NODE_DEFINE_SEMAPHORE(http__client__response)
+NODE_DEFINE_SEMAPHORE(gc__start)
+NODE_DEFINE_SEMAPHORE(gc__done)
+#undef NODE_DEFINE_SEMAPHORE
+}
+
+#define NODE_PROBE_ENABLED(name) \
+  __builtin_expect(NODE_SEMAPHORE(name) != 0, 0)
+
+#define NODE_NET_SERVER_CONNECTION(conn) \
+  STAP_PROBE4(node, net__server__connection, \
+              (conn)->remote, (conn)->port, (conn)->fd, (conn)->buffered)
+#define NODE_NET_SERVER_CONNECTION_ENABLED() \
+  NODE_PROBE_ENABLED(net__server__connection)
+#define NODE_NET_STREAM_END(conn) \
+  STAP_PROBE4(node, net__stream__end, \
+              (conn)->remote, (conn)->port, (conn)->fd, (conn)->buffered)
+#define NODE_NET_STREAM_END_ENABLED() \
+  NODE_PROBE_ENABLED(net__stream__end)
+#define NODE_NET_SOCKET_READ(conn, nbytes) \
+  STAP_PROBE4(node, net__socket__read, \
+              (conn)->remote, (conn)->port, (conn)->fd, nbytes)
+#define NODE_NET_SOCKET_READ_ENABLED() \
+  NODE_PROBE_ENABLED(net__socket__read)
+#define NODE_NET_SOCKET_WRITE(conn, nbytes) \
+  STAP_PROBE4(node, net__socket__write, \
+              (conn)->remote, (conn)->port, (conn)->fd, nbytes)
+#define NODE_NET_SOCKET_WRITE_ENABLED() \
+  NODE_PROBE_ENABLED(net__socket__write)
+#define NODE_HTTP_SERVER_REQUEST(req, conn) \
+  STAP_PROBE6(node, http__server__request, \
+              (req)->method, (req)->url, (req)->forwardedFor, \
+              (conn)->remote, (conn)->port, (conn)->fd)
+#define NODE_HTTP_SERVER_REQUEST_ENABLED() \
+  NODE_PROBE_ENABLED(http__server__request)
+#define NODE_HTTP_SERVER_RESPONSE(conn) \
+  STAP_PROBE3(node, http__server__response, \
+              (conn)->remote, (conn)->port, (conn)->fd)
+#define NODE_HTTP_SERVER_RESPONSE_ENABLED() \
+  NODE_PROBE_ENABLED(http__server__response)
+#define NODE_HTTP_CLIENT_REQUEST(req, conn) \
+  STAP_PROBE5(node, http__client__request, \
+              (req)->method, (req)->url, \
+              (conn)->remote, (conn)->port, (conn)->fd)
+#define NODE_HTTP_CLIENT_REQUEST_ENABLED() \
+  NODE_PROBE_ENABLED(http__client__request)
+#define NODE_HTTP_CLIENT_RESPONSE(conn) \
+  STAP_PROBE3(node, http__client__response, \
+              (conn)->remote, (conn)->port, (conn)->fd)
+#define NODE_HTTP_CLIENT_RESPONSE_ENABLED() \
+  NODE_PROBE_ENABLED(http__client__response)
+#define NODE_GC_START(type, flags) \
+  STAP_PROBE2(node, gc__start, type, flags)
+#define NODE_GC_DONE(type, flags) \
+  STAP_PROBE2(node, gc__done, type, flags)
 #else
 #define NODE_HTTP_SERVER_REQUEST(arg0, arg1)
 #define NODE_HTTP_SERVER_REQUEST_ENABLED() (0)
@@ -315,7 +394,7 @@ void InitDTrace(Handle<Object> target) {
     target->Set(String::NewSymbol(tab[i].name), tab[i].templ->GetFunction());
   }
 
-#ifdef HAVE_DTRACE
+#if defined(HAVE_DTRACE) || defined(HAVE_SYSTEMTAP)
   v8::V8::AddGCPrologueCallback((GCPrologueCallback)dtrace_gc_start);
   v8::V8::AddGCEpilogueCallback((GCEpilogueCallback)dtrace_gc_done);
 #endif
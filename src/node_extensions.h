@@ -40,6 +40,9 @@ NODE_EXT_LIST_ITEM(node_signal_watcher)
 #endif
 NODE_EXT_LIST_ITEM(node_stdio)
 NODE_EXT_LIST_ITEM(node_os)
+#ifdef NODE_TEST_BINDINGS
+NODE_EXT_LIST_ITEM(node_async_queue)
+#endif
 
 // libuv rewrite
 NODE_EXT_LIST_ITEM(node_timer_wrap)
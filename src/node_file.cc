@@ -34,6 +34,20 @@
 #include <string.h>
 #include <errno.h>
 #include <limits.h>
+#include <stdint.h>
+
+#ifndef SIZE_MAX
+# define SIZE_MAX ((size_t) -1)
+#endif
+
+#ifdef __POSIX__
+# include <sys/mman.h>
+# include <sys/uio.h>
+# include <unistd.h>
+# if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#  define MAP_ANONYMOUS MAP_ANON
+# endif
+#endif
 
 #if defined(__MINGW32__) || defined(_MSC_VER)
 # include <io.h>
@@ -83,9 +97,6 @@ static void After(uv_fs_t *req) {
 
   FSReqWrap* req_wrap = (FSReqWrap*) req->data;
   assert(&req_wrap->req_ == req);
-  Local<Value> callback_v = req_wrap->object_->Get(oncomplete_sym);
-  assert(callback_v->IsFunction());
-  Local<Function> callback = Local<Function>::Cast(callback_v);
 
   // there is always at least one argument. "error"
   int argc = 1;
@@ -98,13 +109,15 @@ static void After(uv_fs_t *req) {
   // for a success, which is possible.
   if (req->result == -1) {
     // If the request doesn't have a path parameter set.
+    const char* msg = NULL;
+    if (req->errorno == UV_ECANCELED) msg = "operation canceled";
 
     if (!req->path) {
-      argv[0] = FSError(req->errorno);
+      argv[0] = FSError(req->errorno, NULL, msg);
     } else {
       argv[0] = FSError(req->errorno,
                         NULL,
-                        NULL,
+                        msg,
                         static_cast<const char*>(req->path));
     }
   } else {
@@ -196,13 +209,7 @@ static void After(uv_fs_t *req) {
     }
   }
 
-  TryCatch try_catch;
-
-  callback->Call(req_wrap->object_, argc, argv);
-
-  if (try_catch.HasCaught()) {
-    FatalException(try_catch);
-  }
+  MakeCallback(req_wrap->object_, "oncomplete", argc, argv);
 
   uv_fs_req_cleanup(&req_wrap->req_);
   delete req_wrap;
@@ -283,8 +290,8 @@ Local<Value> FSError(int errorno,
 
 
 #define ASYNC_CALL(func, callback, ...)                           \
-  FSReqWrap* req_wrap = new FSReqWrap();                          \
-  int r = uv_fs_##func(uv_default_loop(), &req_wrap->req_,        \
+  FSReqWrap* req_wrap = new FSReqWrap(true);                      \
+  int r = uv_fs_##func(Loop(), &req_wrap->req_,        \
       __VA_ARGS__, After);                                        \
   assert(r == 0);                                                 \
   req_wrap->object_->Set(oncomplete_sym, callback);                 \
@@ -293,9 +300,9 @@ Local<Value> FSError(int errorno,
 
 #define SYNC_CALL(func, path, ...)                                \
   fs_req_wrap req_wrap;                                           \
-  uv_fs_##func(uv_default_loop(), &req_wrap.req, __VA_ARGS__, NULL); \
+  uv_fs_##func(Loop(), &req_wrap.req, __VA_ARGS__, NULL); \
   if (req_wrap.req.result < 0) {                                  \
-    int code = uv_last_error(uv_default_loop()).code;             \
+    int code = uv_last_error(Loop()).code;             \
     return ThrowException(FSError(code, #func, "", path));        \
   }
 
@@ -784,7 +791,7 @@ static Handle<Value> Write(const Arguments& args) {
   ssize_t len = args[3]->Int32Value();
   if (off + len > buffer_length) {
     return ThrowException(Exception::Error(
-          String::New("Length is extends beyond buffer")));
+          String::New("Length extends beyond buffer")));
   }
 
   ASSERT_OFFSET(args[4]);
@@ -847,7 +854,7 @@ static Handle<Value> Read(const Arguments& args) {
   len = args[3]->Int32Value();
   if (off + len > buffer_length) {
     return ThrowException(Exception::Error(
-          String::New("Length is extends beyond buffer")));
+          String::New("Length extends beyond buffer")));
   }
 
   pos = GET_OFFSET(args[4]);
@@ -866,6 +873,530 @@ static Handle<Value> Read(const Arguments& args) {
 }
 
 
+#ifdef __POSIX__
+
+#if defined(__linux__) || defined(__FreeBSD__)
+# define HAVE_PREADV 1
+#endif
+
+#ifndef IOV_MAX
+# define IOV_MAX 1024
+#endif
+
+/*
+ * Batched I/O. fs.writev(), fs.readv() and fs.preadMany() carry several
+ * buffers or file ranges to the I/O pool in a single request and
+ * complete with a single callback.
+ */
+enum BatchType { BATCH_WRITEV, BATCH_READV, BATCH_PREAD_MANY };
+
+struct BatchChunk {
+  char* data;
+  size_t length;
+  off_t position; // preadMany only
+  ssize_t result; // preadMany only
+};
+
+struct BatchIO {
+  BatchIO(BatchType type_, int fd_, off_t position_, uint32_t count_)
+      : type(type_), fd(fd_), position(position_), count(count_),
+        chunks(new BatchChunk[count_]), result(0), errorno(0) { }
+  ~BatchIO() { delete [] chunks; }
+
+  BatchType type;
+  int fd;
+  off_t position; // -1 for the current file position
+  uint32_t count;
+  BatchChunk* chunks;
+  ssize_t result;
+  int errorno;
+};
+
+typedef class ReqWrap<uv_fs_t> BatchReqWrap;
+
+
+static inline ssize_t PositionalIO(BatchType type, int fd,
+                                   const struct iovec* iov, int iovcnt,
+                                   off_t pos) {
+#ifdef HAVE_PREADV
+  return type == BATCH_WRITEV ? pwritev(fd, iov, iovcnt, pos)
+                              : preadv(fd, iov, iovcnt, pos);
+#else
+  // No preadv/pwritev: do the first buffer, the caller loops for the rest.
+  return type == BATCH_WRITEV ? pwrite(fd, iov[0].iov_base, iov[0].iov_len, pos)
+                              : pread(fd, iov[0].iov_base, iov[0].iov_len, pos);
+#endif
+}
+
+
+// readv/writev until every buffer has been transferred, EOF or an error.
+static void VectorIO(BatchIO* io) {
+  struct iovec iov_[32];
+  struct iovec* iov = io->count > ARRAY_SIZE(iov_) ? new struct iovec[io->count]
+                                                   : iov_;
+
+  for (uint32_t i = 0; i < io->count; i++) {
+    iov[i].iov_base = io->chunks[i].data;
+    iov[i].iov_len = io->chunks[i].length;
+  }
+
+  struct iovec* cur = iov;
+  int remaining = io->count;
+  ssize_t total = 0;
+
+  while (remaining > 0) {
+    int iovcnt = MIN(remaining, IOV_MAX);
+    ssize_t n;
+
+    if (io->position < 0) {
+      n = io->type == BATCH_WRITEV ? writev(io->fd, cur, iovcnt)
+                                   : readv(io->fd, cur, iovcnt);
+    } else {
+      n = PositionalIO(io->type, io->fd, cur, iovcnt, io->position + total);
+    }
+
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      io->errorno = errno;
+      total = -1;
+      break;
+    }
+
+    // Skip the buffers that are done, trim the one that is partially done.
+    bool progress = n > 0;
+    total += n;
+
+    while (remaining > 0 && (size_t) n >= cur->iov_len) {
+      n -= cur->iov_len;
+      cur++;
+      remaining--;
+    }
+    if (remaining > 0) {
+      if (!progress) break; // EOF
+      cur->iov_base = static_cast<char*>(cur->iov_base) + n;
+      cur->iov_len -= n;
+    }
+  }
+
+  if (iov != iov_) delete [] iov;
+
+  io->result = total;
+}
+
+
+static void PreadMany(BatchIO* io) {
+  for (uint32_t i = 0; i < io->count; i++) {
+    BatchChunk* chunk = &io->chunks[i];
+    size_t done = 0;
+
+    while (done < chunk->length) {
+      ssize_t n = pread(io->fd, chunk->data + done, chunk->length - done,
+                        chunk->position + done);
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        io->errorno = errno;
+        io->result = -1;
+        return;
+      }
+      if (n == 0) break; // EOF
+      done += n;
+    }
+
+    chunk->result = done;
+    io->result += done;
+  }
+}
+
+
+static void DoBatch(BatchIO* io) {
+  if (io->type == BATCH_PREAD_MANY) {
+    PreadMany(io);
+  } else {
+    VectorIO(io);
+  }
+}
+
+
+static void BatchWork(uv_fs_t* req) {
+  BatchReqWrap* req_wrap = static_cast<BatchReqWrap*>(req->data);
+  BatchIO* io = static_cast<BatchIO*>(req_wrap->data_);
+  DoBatch(io);
+  req->result = io->result < 0 ? -1 : 0;
+}
+
+
+static const char* BatchSyscall(BatchIO* io) {
+  switch (io->type) {
+    case BATCH_WRITEV: return "writev";
+    case BATCH_READV: return "readv";
+    default: return "pread";
+  }
+}
+
+
+// Total bytes for writev/readv, an array of bytes read per range for
+// preadMany.
+static Local<Value> BatchResult(BatchIO* io) {
+  HandleScope scope;
+
+  if (io->type != BATCH_PREAD_MANY) {
+    return scope.Close(Integer::New(io->result));
+  }
+
+  Local<Array> results = Array::New(io->count);
+  for (uint32_t i = 0; i < io->count; i++) {
+    results->Set(i, Integer::New(io->chunks[i].result));
+  }
+  return scope.Close(results);
+}
+
+
+static void AfterBatch(uv_fs_t* req) {
+  HandleScope scope;
+
+  BatchReqWrap* req_wrap = static_cast<BatchReqWrap*>(req->data);
+  BatchIO* io = static_cast<BatchIO*>(req_wrap->data_);
+
+  Local<Value> argv[2];
+  int argc;
+
+  if (req->result == -1 && req->errorno == UV_ECANCELED) {
+    argv[0] = ErrnoException(ECANCELED, BatchSyscall(io));
+    argc = 1;
+  } else if (io->result < 0) {
+    argv[0] = ErrnoException(io->errorno, BatchSyscall(io));
+    argc = 1;
+  } else {
+    argv[0] = Local<Value>::New(Null());
+    argv[1] = BatchResult(io);
+    argc = 2;
+  }
+
+  MakeCallback(req_wrap->object_, "oncomplete", argc, argv);
+
+  uv_fs_req_cleanup(&req_wrap->req_);
+  delete io;
+  delete req_wrap;
+}
+
+
+// Runs `io` on the I/O pool when a callback is given, inline otherwise.
+// `keep` is an array of the buffers `io` points into, made for the request
+// alone so that the caller can't drop them while a thread is using them.
+static Handle<Value> DispatchBatch(BatchIO* io,
+                                   Handle<Value> keep,
+                                   Handle<Value> cb) {
+  HandleScope scope;
+
+  if (cb->IsFunction()) {
+    BatchReqWrap* req_wrap = new BatchReqWrap(true);
+    req_wrap->data_ = io;
+    req_wrap->object_->Set(oncomplete_sym, cb);
+    req_wrap->object_->Set(buf_symbol, keep);
+    req_wrap->Dispatched();
+
+    int r = uv_fs_work(Loop(), &req_wrap->req_, BatchWork, AfterBatch);
+    assert(r == 0);
+
+    return scope.Close(req_wrap->object_);
+  }
+
+  DoBatch(io);
+
+  if (io->result < 0) {
+    Local<Value> e = ErrnoException(io->errorno, BatchSyscall(io));
+    delete io;
+    return ThrowException(e);
+  }
+
+  Local<Value> result = BatchResult(io);
+  delete io;
+  return scope.Close(result);
+}
+
+
+/* fs.writev(fd, buffers, position, [callback])
+ * fs.readv(fd, buffers, position, [callback])
+ *
+ * 0 fd        integer. file descriptor
+ * 1 buffers   array of Buffers, written or filled in order
+ * 2 position  file position - null for current position
+ */
+static Handle<Value> Vector(const Arguments& args, BatchType type) {
+  HandleScope scope;
+
+  if (!args[0]->IsInt32() || !args[1]->IsArray()) {
+    return THROW_BAD_ARGS;
+  }
+
+  int fd = args[0]->Int32Value();
+  Local<Array> buffers = Local<Array>::Cast(args[1]);
+
+  ASSERT_OFFSET(args[2]);
+  off_t pos = GET_OFFSET(args[2]);
+
+  BatchIO* io = new BatchIO(type, fd, pos, buffers->Length());
+  Local<Array> keep = Array::New(io->count);
+
+  for (uint32_t i = 0; i < io->count; i++) {
+    Local<Value> buffer = buffers->Get(i);
+    if (!Buffer::HasInstance(buffer)) {
+      delete io;
+      return ThrowException(Exception::Error(
+                  String::New("Array must contain only buffers")));
+    }
+    Local<Object> buffer_obj = buffer->ToObject();
+    io->chunks[i].data = Buffer::Data(buffer_obj);
+    io->chunks[i].length = Buffer::Length(buffer_obj);
+    keep->Set(i, buffer_obj);
+  }
+
+  return scope.Close(DispatchBatch(io, keep, args[3]));
+}
+
+
+static Handle<Value> Writev(const Arguments& args) {
+  return Vector(args, BATCH_WRITEV);
+}
+
+
+static Handle<Value> Readv(const Arguments& args) {
+  return Vector(args, BATCH_READV);
+}
+
+
+/* fs.preadMany(fd, ranges, [callback])
+ *
+ * 0 fd        integer. file descriptor
+ * 1 ranges    array of [buffer, offset, length, position]
+ *
+ * Returns (or calls back with) an array of bytes read per range.
+ */
+static Handle<Value> PreadMany(const Arguments& args) {
+  HandleScope scope;
+
+  if (!args[0]->IsInt32() || !args[1]->IsArray()) {
+    return THROW_BAD_ARGS;
+  }
+
+  int fd = args[0]->Int32Value();
+  Local<Array> ranges = Local<Array>::Cast(args[1]);
+
+  BatchIO* io = new BatchIO(BATCH_PREAD_MANY, fd, -1, ranges->Length());
+  Local<Array> keep = Array::New(io->count);
+
+  for (uint32_t i = 0; i < io->count; i++) {
+    Local<Value> range_v = ranges->Get(i);
+    if (!range_v->IsArray()) {
+      delete io;
+      return THROW_BAD_ARGS;
+    }
+
+    Local<Array> range = Local<Array>::Cast(range_v);
+    Local<Value> buffer = range->Get(0);
+    if (!Buffer::HasInstance(buffer)) {
+      delete io;
+      return ThrowException(Exception::Error(
+                  String::New("Range needs to start with a buffer")));
+    }
+
+    Local<Object> buffer_obj = buffer->ToObject();
+    size_t buffer_length = Buffer::Length(buffer_obj);
+    size_t off = range->Get(1)->Uint32Value();
+    size_t len = range->Get(2)->Uint32Value();
+
+    if (off > buffer_length || off + len > buffer_length) {
+      delete io;
+      return ThrowException(Exception::Error(
+            String::New("Length extends beyond buffer")));
+    }
+
+    Local<Value> position = range->Get(3);
+    if (!position->IsNumber() || !IsInt64(position->NumberValue()) ||
+        position->IntegerValue() < 0) {
+      delete io;
+      return ThrowException(Exception::TypeError(
+            String::New("Position must be a non-negative integer")));
+    }
+
+    io->chunks[i].data = Buffer::Data(buffer_obj) + off;
+    io->chunks[i].length = len;
+    io->chunks[i].position = position->IntegerValue();
+    io->chunks[i].result = 0;
+    keep->Set(i, buffer_obj);
+  }
+
+  return scope.Close(DispatchBatch(io, keep, args[2]));
+}
+
+
+// The mapping behind an mmap'd buffer. The buffer's data may start past
+// `base` when the file offset isn't page aligned.
+struct MappedRegion {
+  void* base;
+  size_t length;
+  int prot;
+  bool released; // by munmap(); the range now holds anonymous zero pages
+};
+
+
+static void Unmap(char* data, void* hint) {
+  MappedRegion* region = static_cast<MappedRegion*>(hint);
+  munmap(region->base, region->length);
+  delete region;
+}
+
+
+static inline size_t PageSize() {
+  static size_t page_size;
+  if (page_size == 0) page_size = sysconf(_SC_PAGESIZE);
+  return page_size;
+}
+
+
+/* fs.mmap(fd, offset, length, prot, flags)
+ *
+ * 0 fd        integer. file descriptor
+ * 1 offset    file offset, need not be page aligned
+ * 2 length    bytes to map
+ * 3 prot      PROT_* flags
+ * 4 flags     MAP_* flags
+ *
+ * Returns a SlowBuffer over the mapping. It is unmapped when the buffer is
+ * collected or passed to munmap().
+ */
+static Handle<Value> MMap(const Arguments& args) {
+  HandleScope scope;
+
+  if (!args[0]->IsInt32() || !args[2]->IsNumber() ||
+      !args[3]->IsInt32() || !args[4]->IsInt32()) {
+    return THROW_BAD_ARGS;
+  }
+
+  int fd = args[0]->Int32Value();
+  ASSERT_OFFSET(args[1]);
+  off_t offset = GET_OFFSET(args[1]);
+  double length_arg = args[2]->NumberValue();
+  int prot = args[3]->Int32Value();
+  int flags = args[4]->Int32Value();
+
+  if (offset < 0 || !(length_arg > 0)) {
+    return ThrowException(Exception::RangeError(
+          String::New("Offset must be non-negative and length positive")));
+  }
+
+  size_t delta = offset % PageSize();
+
+  // SIZE_MAX as a double rounds up, hence >=.
+  if (length_arg >= static_cast<double>(SIZE_MAX) ||
+      static_cast<size_t>(length_arg) > SIZE_MAX - delta) {
+    return ThrowException(Exception::RangeError(
+          String::New("Length is too large")));
+  }
+
+  size_t length = static_cast<size_t>(length_arg);
+  size_t map_length = length + delta;
+
+  void* base = mmap(NULL, map_length, prot, flags, fd, offset - delta);
+  if (base == MAP_FAILED) {
+    return ThrowException(ErrnoException(errno, "mmap"));
+  }
+
+  MappedRegion* region = new MappedRegion;
+  region->base = base;
+  region->length = map_length;
+  region->prot = prot;
+  region->released = false;
+
+  Buffer* buffer = Buffer::New(static_cast<char*>(base) + delta, length,
+                               Unmap, region);
+  return scope.Close(buffer->handle_);
+}
+
+
+static void EmptyBuffer(Handle<Object> buffer) {
+  buffer->SetIndexedPropertiesToExternalArrayData(NULL,
+                                                  kExternalUnsignedByteArray,
+                                                  0);
+  buffer->Set(String::NewSymbol("length"), Integer::New(0));
+}
+
+
+// munmap(slowBuffer, buffer) - false if the buffer is not (or no longer)
+// mapped. The file's pages are swapped for anonymous zero pages at the same
+// address, so slices that still point into the range read zeros instead of
+// faulting; the range itself is unmapped when slowBuffer is collected.
+// `buffer`, the Buffer over slowBuffer that JS code holds, is emptied along
+// with slowBuffer.
+static Handle<Value> MUnmap(const Arguments& args) {
+  HandleScope scope;
+
+  if (!Buffer::HasInstance(args[0]) || !args[1]->IsObject()) {
+    return THROW_BAD_ARGS;
+  }
+
+  Local<Object> slow = args[0]->ToObject();
+  MappedRegion* region = static_cast<MappedRegion*>(Buffer::Hint(slow, Unmap));
+
+  if (region == NULL || region->released) return scope.Close(False());
+
+  void* r = mmap(region->base, region->length, region->prot,
+                 MAP_FIXED | MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+  if (r == MAP_FAILED) {
+    return ThrowException(ErrnoException(errno, "mmap"));
+  }
+  region->released = true;
+
+  EmptyBuffer(slow);
+  EmptyBuffer(args[1]->ToObject());
+
+  return scope.Close(True());
+}
+
+
+/* fs.madvise(slowBuffer, offset, length, advice)
+ *
+ * Applies `advice` to the pages holding the given range of a buffer
+ * returned by mmap(). The range is widened to page boundaries.
+ */
+static Handle<Value> MAdvise(const Arguments& args) {
+  HandleScope scope;
+
+  if (!Buffer::HasInstance(args[0]) || !args[3]->IsInt32()) {
+    return THROW_BAD_ARGS;
+  }
+
+  Local<Object> buffer_obj = args[0]->ToObject();
+  if (!Buffer::OwnedBy(buffer_obj, Unmap)) {
+    return ThrowException(Exception::Error(
+          String::New("Buffer is not memory mapped")));
+  }
+
+  size_t buffer_length = Buffer::Length(buffer_obj);
+  size_t off = args[1]->Uint32Value();
+  size_t len = args[2]->Uint32Value();
+
+  if (off > buffer_length || off + len > buffer_length) {
+    return ThrowException(Exception::Error(
+          String::New("Length extends beyond buffer")));
+  }
+
+  if (len == 0) return Undefined();
+
+  uintptr_t start = reinterpret_cast<uintptr_t>(Buffer::Data(buffer_obj) + off);
+  uintptr_t aligned = start & ~(static_cast<uintptr_t>(PageSize()) - 1);
+
+  if (madvise(reinterpret_cast<void*>(aligned), len + (start - aligned),
+              args[3]->Int32Value()) == -1) {
+    return ThrowException(ErrnoException(errno, "madvise"));
+  }
+
+  return Undefined();
+}
+
+#endif  // __POSIX__
+
+
 /* fs.chmod(path, mode);
  * Wrapper for chmod(1) / EIO_CHMOD
  */
@@ -1031,6 +1562,14 @@ void File::Initialize(Handle<Object> target) {
   NODE_SET_METHOD(target, "readlink", ReadLink);
   NODE_SET_METHOD(target, "unlink", Unlink);
   NODE_SET_METHOD(target, "write", Write);
+#ifdef __POSIX__
+  NODE_SET_METHOD(target, "writev", Writev);
+  NODE_SET_METHOD(target, "readv", Readv);
+  NODE_SET_METHOD(target, "preadMany", PreadMany);
+  NODE_SET_METHOD(target, "mmap", MMap);
+  NODE_SET_METHOD(target, "munmap", MUnmap);
+  NODE_SET_METHOD(target, "madvise", MAdvise);
+#endif
 
   NODE_SET_METHOD(target, "chmod", Chmod);
   NODE_SET_METHOD(target, "fchmod", FChmod);
@@ -286,7 +286,7 @@ class Parser : public ObjectWrap {
     size_t len = args[2]->Int32Value();
     if (off+len > buffer_len) {
       return ThrowException(Exception::Error(
-            String::New("Length is extends beyond buffer")));
+            String::New("Length extends beyond buffer")));
     }
 
     // Assign 'buffer_' while we parse. The callbacks will access that varible.
@@ -749,7 +749,7 @@ static Handle<Value> Read(const Arguments& args) {
   size_t len = args[3]->Int32Value();
   if (off + len > buffer_length) {
     return ThrowException(Exception::Error(
-          String::New("Length is extends beyond buffer")));
+          String::New("Length extends beyond buffer")));
   }
 
 #ifdef __POSIX__
@@ -809,7 +809,7 @@ static Handle<Value> RecvFrom(const Arguments& args) {
   size_t len = args[3]->Int32Value();
   if (off + len > buffer_length) {
     return ThrowException(Exception::Error(
-          String::New("Length is extends beyond buffer")));
+          String::New("Length extends beyond buffer")));
   }
 
   int flags = args[4]->Int32Value();
@@ -881,7 +881,7 @@ static Handle<Value> RecvMsg(const Arguments& args) {
   size_t len = args[3]->Int32Value();
   if (off + len > buffer_length) {
     return ThrowException(Exception::Error(
-          String::New("Length is extends beyond buffer")));
+          String::New("Length extends beyond buffer")));
   }
 
   struct iovec iov[1];
@@ -978,7 +978,7 @@ static Handle<Value> Write(const Arguments& args) {
   size_t len = args[3]->Int32Value();
   if (off + len > buffer_length) {
     return ThrowException(Exception::Error(
-          String::New("Length is extends beyond buffer")));
+          String::New("Length extends beyond buffer")));
   }
 
 #ifdef __POSIX__
@@ -0,0 +1,515 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <node.h>
+#include <node_profiler.h>
+#include <req_wrap.h>
+
+#include <v8.h>
+#include <v8-profiler.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __POSIX__
+# include <signal.h>
+# include <unistd.h>
+#else
+# include <process.h>
+# define getpid _getpid
+#endif
+
+// The native sampler reads the interrupted pc out of the signal context,
+// which is only done for the platforms below.
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+# include <cxxabi.h>
+# include <dlfcn.h>
+# include <sys/syscall.h>
+# include <time.h>
+# include <ucontext.h>
+# define HAVE_NATIVE_SAMPLER 1
+# ifndef sigev_notify_thread_id
+#  define sigev_notify_thread_id _sigev_un._tid
+# endif
+#endif
+
+namespace node {
+
+using namespace v8;
+
+// The profile file is plain text. After a short header comes V8's top-down
+// call tree, one function per line:
+//
+//   <depth> <self samples> <total samples> <function> <script>:<line>
+//
+// and, where the native sampler is available, a flat list of the native
+// functions the samples landed in:
+//
+//   <samples> <symbol>
+//
+// V8 only sees JS frames; everything under a binding shows up as "(program)"
+// there, which is what the native list is for.
+
+static bool profiling = false;
+static int profile_seq = 0;
+static Persistent<String> profile_title;
+
+struct ProfileBuffer {
+  char* data;
+  size_t len;
+  size_t size;
+};
+
+struct ProfileWrite {
+  char* path;
+  ProfileBuffer buf;
+  int errorno;
+  bool announce;
+};
+
+typedef ReqWrap<uv_fs_t> ProfileReqWrap;
+
+
+static void Append(ProfileBuffer* buf, const char* fmt, ...) {
+  va_list ap;
+
+  for (;;) {
+    size_t avail = buf->size - buf->len;
+
+    va_start(ap, fmt);
+    int n = vsnprintf(buf->data + buf->len, avail, fmt, ap);
+    va_end(ap);
+
+    if (n < 0) return;
+    if (static_cast<size_t>(n) < avail) {
+      buf->len += n;
+      return;
+    }
+
+    buf->size = buf->size * 2 + n + 1;
+    buf->data = static_cast<char*>(realloc(buf->data, buf->size));
+    assert(buf->data != NULL);
+  }
+}
+
+
+#ifdef HAVE_NATIVE_SAMPLER
+
+#define NATIVE_SLOTS 4096
+
+// The native sampler has a timer and a signal of its own; V8 only installs
+// its SIGPROF handler once its sampler thread gets around to it, and tears
+// it down again when profiling stops.
+#define NATIVE_SAMPLER_SIGNAL (SIGRTMIN + 1)
+
+struct NativeSample {
+  uintptr_t pc;
+  const char* name;
+  uintptr_t start;
+  unsigned count;
+};
+
+// Filled in from the signal handler, so no locks and no allocation.
+static NativeSample native_samples[NATIVE_SLOTS];
+static volatile unsigned native_dropped;
+static volatile sig_atomic_t native_sampling;
+static bool native_handler_installed;
+static timer_t native_timer;
+
+
+static void RecordPC(uintptr_t pc) {
+  unsigned i = (pc >> 2) % NATIVE_SLOTS;
+
+  for (int n = 0; n < NATIVE_SLOTS; n++) {
+    if (native_samples[i].pc == pc) {
+      native_samples[i].count++;
+      return;
+    }
+    if (native_samples[i].pc == 0) {
+      native_samples[i].pc = pc;
+      native_samples[i].count = 1;
+      return;
+    }
+    i = (i + 1) % NATIVE_SLOTS;
+  }
+
+  native_dropped++;
+}
+
+
+static void NativeSampleHandler(int signum, siginfo_t* info, void* context) {
+  // A tick can still be pending when the timer is deleted.
+  if (!native_sampling) return;
+
+  ucontext_t* uc = static_cast<ucontext_t*>(context);
+
+#ifdef __x86_64__
+  RecordPC(uc->uc_mcontext.gregs[REG_RIP]);
+#else
+  RecordPC(uc->uc_mcontext.gregs[REG_EIP]);
+#endif
+}
+
+
+// Samples the main thread every millisecond of CPU time it uses. The
+// handler stays installed once it is; it ignores the signal while the
+// sampler is stopped.
+static void StartNativeSampler() {
+  memset(native_samples, 0, sizeof native_samples);
+  native_dropped = 0;
+
+  if (!native_handler_installed) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sa_sigaction = NativeSampleHandler;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(NATIVE_SAMPLER_SIGNAL, &sa, NULL)) return;
+    native_handler_installed = true;
+  }
+
+  struct sigevent sev;
+  memset(&sev, 0, sizeof sev);
+  sev.sigev_notify = SIGEV_THREAD_ID;
+  sev.sigev_signo = NATIVE_SAMPLER_SIGNAL;
+  sev.sigev_notify_thread_id = syscall(SYS_gettid);
+
+  if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &native_timer)) return;
+
+  struct itimerspec interval;
+  interval.it_interval.tv_sec = 0;
+  interval.it_interval.tv_nsec = 1000 * 1000;
+  interval.it_value = interval.it_interval;
+
+  native_sampling = 1;
+  if (timer_settime(native_timer, 0, &interval, NULL)) {
+    native_sampling = 0;
+    timer_delete(native_timer);
+  }
+}
+
+
+static void StopNativeSampler() {
+  if (!native_sampling) return;
+  native_sampling = 0;
+  timer_delete(native_timer);
+}
+
+
+static int CompareStart(const void* a, const void* b) {
+  uintptr_t x = static_cast<const NativeSample*>(a)->start;
+  uintptr_t y = static_cast<const NativeSample*>(b)->start;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+
+static int CompareCount(const void* a, const void* b) {
+  unsigned x = static_cast<const NativeSample*>(a)->count;
+  unsigned y = static_cast<const NativeSample*>(b)->count;
+  return x > y ? -1 : x < y ? 1 : 0;
+}
+
+
+// Folds the sampled pcs into the functions that contain them. Anything
+// dladdr() can't place - JIT code, mostly - is lumped together.
+static void WriteNativeSamples(ProfileBuffer* buf) {
+  int n = 0;
+
+  for (int i = 0; i < NATIVE_SLOTS; i++) {
+    if (native_samples[i].pc == 0) continue;
+
+    NativeSample s = native_samples[i];
+    Dl_info info;
+
+    if (dladdr(reinterpret_cast<void*>(s.pc), &info) && info.dli_sname) {
+      s.name = info.dli_sname;
+      s.start = reinterpret_cast<uintptr_t>(info.dli_saddr);
+    } else {
+      s.name = NULL;
+      s.start = 0;
+    }
+
+    native_samples[n++] = s;
+  }
+
+  qsort(native_samples, n, sizeof native_samples[0], CompareStart);
+
+  int m = 0;
+  for (int i = 0; i < n; i++) {
+    if (m > 0 && native_samples[m - 1].start == native_samples[i].start) {
+      native_samples[m - 1].count += native_samples[i].count;
+    } else {
+      native_samples[m++] = native_samples[i];
+    }
+  }
+
+  qsort(native_samples, m, sizeof native_samples[0], CompareCount);
+
+  Append(buf, "# native, %u samples dropped\n", native_dropped);
+  Append(buf, "# samples symbol\n");
+
+  for (int i = 0; i < m; i++) {
+    const char* name = native_samples[i].name;
+    char* demangled = NULL;
+    int status;
+
+    if (name == NULL) {
+      name = "(unresolved)";
+    } else {
+      demangled = abi::__cxa_demangle(name, NULL, NULL, &status);
+      if (status == 0) name = demangled;
+    }
+
+    Append(buf, "%u %s\n", native_samples[i].count, name);
+    free(demangled);
+  }
+}
+
+#endif  // HAVE_NATIVE_SAMPLER
+
+
+static void WriteNode(ProfileBuffer* buf,
+                      const CpuProfileNode* node,
+                      int depth) {
+  String::Utf8Value name(node->GetFunctionName());
+  String::Utf8Value script(node->GetScriptResourceName());
+
+  Append(buf,
+         "%d %.0f %.0f %s %s:%d\n",
+         depth,
+         node->GetSelfSamplesCount(),
+         node->GetTotalSamplesCount(),
+         name.length() > 0 ? *name : "(anonymous)",
+         script.length() > 0 ? *script : "",
+         node->GetLineNumber());
+
+  for (int i = 0; i < node->GetChildrenCount(); i++) {
+    WriteNode(buf, node->GetChild(i), depth + 1);
+  }
+}
+
+
+static void StartProfiler() {
+  if (profiling) return;
+
+  CpuProfiler::StartProfiling(profile_title);
+#ifdef HAVE_NATIVE_SAMPLER
+  StartNativeSampler();
+#endif
+  profiling = true;
+}
+
+
+static void WriteWork(uv_fs_t* req) {
+  ProfileReqWrap* req_wrap = static_cast<ProfileReqWrap*>(req->data);
+  ProfileWrite* w = static_cast<ProfileWrite*>(req_wrap->data_);
+
+  FILE* f = fopen(w->path, "w");
+
+  if (f == NULL ||
+      fwrite(w->buf.data, 1, w->buf.len, f) != w->buf.len ||
+      fclose(f) != 0) {
+    w->errorno = errno;
+  }
+
+  req->result = w->errorno ? -1 : 0;
+}
+
+
+static void AfterWrite(uv_fs_t* req) {
+  HandleScope scope;
+
+  ProfileReqWrap* req_wrap = static_cast<ProfileReqWrap*>(req->data);
+  ProfileWrite* w = static_cast<ProfileWrite*>(req_wrap->data_);
+
+  if (w->announce) {
+    if (w->errorno) {
+      fprintf(stderr, "node: cpu profile not written to %s: %s\n",
+              w->path, strerror(w->errorno));
+    } else {
+      fprintf(stderr, "node: cpu profile written to %s\n", w->path);
+    }
+  }
+
+  if (req_wrap->object_->Get(String::NewSymbol("oncomplete"))->IsFunction()) {
+    Local<Value> argv[2];
+
+    if (w->errorno) {
+      argv[0] = ErrnoException(w->errorno, "open", "", w->path);
+    } else {
+      argv[0] = Local<Value>::New(Null());
+    }
+    argv[1] = String::New(w->path);
+
+    MakeCallback(req_wrap->object_, "oncomplete", 2, argv);
+  }
+
+  uv_fs_req_cleanup(req);
+  free(w->path);
+  free(w->buf.data);
+  delete w;
+  delete req_wrap;
+}
+
+
+// Stops the profiler and writes the profile out on the I/O pool; only
+// walking V8's call tree happens on the loop thread. Returns the path.
+static Local<String> StopProfiler(Handle<Value> path_v,
+                                  Handle<Value> cb,
+                                  bool announce) {
+  HandleScope scope;
+
+  assert(profiling);
+  profiling = false;
+
+#ifdef HAVE_NATIVE_SAMPLER
+  StopNativeSampler();
+#endif
+  const CpuProfile* profile = CpuProfiler::StopProfiling(profile_title);
+
+  ProfileWrite* w = new ProfileWrite;
+  w->errorno = 0;
+  w->announce = announce;
+  w->buf.len = 0;
+  w->buf.size = 64 * 1024;
+  w->buf.data = static_cast<char*>(malloc(w->buf.size));
+
+  if (path_v->IsString()) {
+    String::Utf8Value path(path_v);
+    w->path = strdup(*path);
+  } else {
+    char path[64];
+    snprintf(path, sizeof path, "node-%d-%d.profile",
+             static_cast<int>(getpid()), ++profile_seq);
+    w->path = strdup(path);
+  }
+
+  const CpuProfileNode* root = profile ? profile->GetTopDownRoot() : NULL;
+
+  Append(&w->buf, "# node cpu profile, pid %d, %.0f samples\n",
+         static_cast<int>(getpid()),
+         root ? root->GetTotalSamplesCount() : 0.);
+  Append(&w->buf, "# depth self total function script:line\n");
+  if (root) WriteNode(&w->buf, root, 0);
+#ifdef HAVE_NATIVE_SAMPLER
+  WriteNativeSamples(&w->buf);
+#endif
+
+  if (profile) const_cast<CpuProfile*>(profile)->Delete();
+
+  ProfileReqWrap* req_wrap = new ProfileReqWrap();
+  req_wrap->data_ = w;
+  if (cb->IsFunction()) {
+    req_wrap->object_->Set(String::NewSymbol("oncomplete"), cb);
+  }
+
+  // WriteWork can run before uv_fs_work returns.
+  req_wrap->Dispatched();
+  uv_fs_work(Loop(), &req_wrap->req_, WriteWork, AfterWrite);
+
+  return scope.Close(String::New(w->path));
+}
+
+
+// process.startProfiling()
+static Handle<Value> StartProfiling(const Arguments& args) {
+  HandleScope scope;
+  bool was_profiling = profiling;
+  StartProfiler();
+  return scope.Close(Boolean::New(!was_profiling));
+}
+
+
+// path = process.stopProfiling([path], [callback])
+static Handle<Value> StopProfiling(const Arguments& args) {
+  HandleScope scope;
+
+  if (!profiling) {
+    return ThrowException(Exception::Error(
+          String::New("The profiler is not running")));
+  }
+
+  Handle<Value> path = args[0];
+  Handle<Value> cb = args[1];
+
+  if (path->IsFunction()) {
+    cb = path;
+    path = Undefined();
+  }
+
+  return scope.Close(StopProfiler(path, cb, false));
+}
+
+
+#ifdef __POSIX__
+
+static uv_async_t profile_signal_watcher;
+
+
+static void ProfileSignal(uv_async_t* handle, int status) {
+  assert(handle == &profile_signal_watcher);
+
+  HandleScope scope;
+
+  if (profiling) {
+    StopProfiler(Undefined(), Undefined(), true);
+  } else {
+    StartProfiler();
+  }
+}
+
+
+static void ProfileSignalHandler(int signum) {
+  // This is signal safe.
+  uv_async_send(&profile_signal_watcher);
+}
+
+#endif  // __POSIX__
+
+
+void InitProfiler(Handle<Object> process, bool on_signal) {
+  HandleScope scope;
+
+  profile_title = Persistent<String>::New(String::New("node"));
+
+  NODE_SET_METHOD(process, "startProfiling", StartProfiling);
+  NODE_SET_METHOD(process, "stopProfiling", StopProfiling);
+
+#ifdef __POSIX__
+  if (on_signal) {
+    struct sigaction sa;
+
+    uv_async_init(Loop(), &profile_signal_watcher, ProfileSignal);
+    uv_unref(Loop());
+
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = ProfileSignalHandler;
+    sigfillset(&sa.sa_mask);
+    sigaction(SIGUSR2, &sa, NULL);
+  }
+#endif
+}
+
+}  // namespace node
@@ -40,7 +40,11 @@ using v8::Local;
 using v8::Array;
 using v8::Persistent;
 using v8::Integer;
+using v8::Boolean;
+using v8::External;
 using v8::FunctionTemplate;
+using v8::ObjectTemplate;
+using v8::AccessorInfo;
 
 
 class WrappedContext : ObjectWrap {
@@ -82,7 +86,7 @@ class WrappedScript : ObjectWrap {
  protected:
   static Persistent<FunctionTemplate> constructor_template;
 
-  WrappedScript() : ObjectWrap() {}
+  WrappedScript() : ObjectWrap(), creates_functions_(true) {}
   ~WrappedScript();
 
   static Handle<Value> New(const Arguments& args);
@@ -93,11 +97,341 @@ class WrappedScript : ObjectWrap {
   static Handle<Value> CompileRunInContext(const Arguments& args);
   static Handle<Value> CompileRunInThisContext(const Arguments& args);
   static Handle<Value> CompileRunInNewContext(const Arguments& args);
+  static Handle<Value> SetContextPoolSize(const Arguments& args);
 
   Persistent<Script> script_;
+  // Whether it may be run in a pooled context, see CreatesFunctions().
+  bool creates_functions_;
 };
 
 
+// A context for runInNewContext() that is reused once
+// vm.setContextPoolSize() has been called. Its global forwards to the
+// sandbox through named interceptors, so nothing is copied in. Only what
+// bypasses the interceptors (function declarations, defineProperty) ends up
+// on the global itself; that is moved to the sandbox afterwards and deleted,
+// which is all the reset there is. Changes to the builtins stick.
+//
+// A function keeps the context it was created in, and would look up its
+// globals in whatever sandbox that context serves next. Code that can create
+// functions therefore never gets a pooled context.
+class PooledContext {
+ public:
+  static PooledContext* Acquire(Handle<Object> sandbox);
+  void Release(bool copy_back);
+
+  static void SetPoolSize(int size);
+
+  Persistent<Context> context_;
+
+ private:
+  PooledContext();
+  ~PooledContext();
+
+  static Handle<Value> GlobalGetter(Local<String> property,
+                                    const AccessorInfo& info);
+  static Handle<Value> GlobalSetter(Local<String> property,
+                                    Local<Value> value,
+                                    const AccessorInfo& info);
+  static Handle<Integer> GlobalQuery(Local<String> property,
+                                     const AccessorInfo& info);
+  static Handle<Boolean> GlobalDeleter(Local<String> property,
+                                       const AccessorInfo& info);
+  static Handle<Array> GlobalEnumerator(const AccessorInfo& info);
+
+  Persistent<Object> global_;
+  Persistent<Object> sandbox_;
+};
+
+
+#define CONTEXT_POOL_MAX 64
+
+static PooledContext* context_pool[CONTEXT_POOL_MAX];
+static int context_pool_used;
+// Idle contexts kept around, 0 turns pooling off.
+static int context_pool_size;
+
+
+PooledContext::PooledContext() {
+  HandleScope scope;
+
+  Local<ObjectTemplate> global_template = ObjectTemplate::New();
+  global_template->SetNamedPropertyHandler(GlobalGetter,
+                                           GlobalSetter,
+                                           GlobalQuery,
+                                           GlobalDeleter,
+                                           GlobalEnumerator,
+                                           External::Wrap(this));
+
+  context_ = Context::New(NULL, global_template);
+  global_ = Persistent<Object>::New(context_->Global());
+}
+
+
+PooledContext::~PooledContext() {
+  global_.Dispose();
+  context_->DetachGlobal();
+  context_.Dispose();
+}
+
+
+PooledContext* PooledContext::Acquire(Handle<Object> sandbox) {
+  PooledContext* pc = context_pool_used > 0
+                    ? context_pool[--context_pool_used]
+                    : new PooledContext();
+
+  assert(pc->sandbox_.IsEmpty());
+  pc->sandbox_ = Persistent<Object>::New(sandbox);
+
+  return pc;
+}
+
+
+void PooledContext::Release(bool copy_back) {
+  HandleScope scope;
+  // The global is only visible from inside its own context.
+  Context::Scope context_scope(context_);
+
+  Local<Object> sandbox = Local<Object>::New(sandbox_);
+  sandbox_.Dispose();
+  sandbox_.Clear();
+
+  // With the sandbox gone the enumerator is empty and this only lists what
+  // was put on the global itself (plus anything enumerable that was added to
+  // the builtin prototypes, which HasRealNamedProperty() filters out).
+  Local<Array> keys = global_->GetPropertyNames();
+
+  for (uint32_t i = 0; i < keys->Length(); i++) {
+    Local<String> key = keys->Get(Integer::New(i))->ToString();
+    if (!global_->HasRealNamedProperty(key)) continue;
+
+    if (copy_back) {
+      Local<Value> value = global_->Get(key);
+      if (value == global_) { value = sandbox; }
+      sandbox->Set(key, value);
+    }
+
+    global_->ForceDelete(key);
+  }
+
+  if (context_pool_used < context_pool_size) {
+    context_pool[context_pool_used++] = this;
+  } else {
+    delete this;
+  }
+}
+
+
+void PooledContext::SetPoolSize(int size) {
+  if (size < 0) size = 0;
+  if (size > CONTEXT_POOL_MAX) size = CONTEXT_POOL_MAX;
+
+  context_pool_size = size;
+
+  while (context_pool_used > context_pool_size) {
+    delete context_pool[--context_pool_used];
+  }
+}
+
+
+#define UNWRAP_POOLED_CONTEXT \
+  PooledContext* pc = static_cast<PooledContext*>(External::Unwrap(info.Data()))
+
+
+Handle<Value> PooledContext::GlobalGetter(Local<String> property,
+                                          const AccessorInfo& info) {
+  HandleScope scope;
+  UNWRAP_POOLED_CONTEXT;
+
+  // A function declaration lands on the global itself and has to win over
+  // whatever an earlier script left on the sandbox under the same name.
+  if (pc->global_->HasRealNamedProperty(property)) return Handle<Value>();
+
+  if (pc->sandbox_.IsEmpty() || !pc->sandbox_->HasRealNamedProperty(property)) {
+    return Handle<Value>();
+  }
+
+  Local<Value> value = pc->sandbox_->Get(property);
+  if (value == pc->sandbox_) { value = Local<Value>::New(pc->global_); }
+
+  return scope.Close(value);
+}
+
+
+Handle<Value> PooledContext::GlobalSetter(Local<String> property,
+                                          Local<Value> value,
+                                          const AccessorInfo& info) {
+  HandleScope scope;
+  UNWRAP_POOLED_CONTEXT;
+
+  if (pc->sandbox_.IsEmpty()) return Handle<Value>();
+
+  if (value == pc->global_) {
+    pc->sandbox_->Set(property, pc->sandbox_);
+  } else {
+    pc->sandbox_->Set(property, value);
+  }
+
+  return scope.Close(value);
+}
+
+
+Handle<Integer> PooledContext::GlobalQuery(Local<String> property,
+                                           const AccessorInfo& info) {
+  HandleScope scope;
+  UNWRAP_POOLED_CONTEXT;
+
+  if (pc->sandbox_.IsEmpty() || !pc->sandbox_->HasRealNamedProperty(property)) {
+    return Handle<Integer>();
+  }
+
+  return scope.Close(Integer::New(v8::None));
+}
+
+
+Handle<Boolean> PooledContext::GlobalDeleter(Local<String> property,
+                                             const AccessorInfo& info) {
+  HandleScope scope;
+  UNWRAP_POOLED_CONTEXT;
+
+  if (pc->sandbox_.IsEmpty() || !pc->sandbox_->HasRealNamedProperty(property)) {
+    return Handle<Boolean>();
+  }
+
+  return scope.Close(Boolean::New(pc->sandbox_->Delete(property)));
+}
+
+
+Handle<Array> PooledContext::GlobalEnumerator(const AccessorInfo& info) {
+  HandleScope scope;
+  UNWRAP_POOLED_CONTEXT;
+
+  if (pc->sandbox_.IsEmpty()) return scope.Close(Array::New());
+
+  return scope.Close(pc->sandbox_->GetPropertyNames());
+}
+
+
+static inline bool IsIdentifierChar(uint16_t c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || c == '$' || c > 127;
+}
+
+
+static bool IdentifierIs(const uint16_t* p, int len, const char* name) {
+  int i;
+  for (i = 0; i < len && name[i]; i++) {
+    if (p[i] != static_cast<uint8_t>(name[i])) return false;
+  }
+  return i == len && name[i] == '\0';
+}
+
+
+// Errs on the side of yes: looks for the words that create functions
+// (function, Function, eval, constructor, and get/set in an object literal)
+// anywhere in the source, strings and comments included.
+static bool CreatesFunctions(Handle<String> source) {
+  String::Value value(source);
+  const uint16_t* p = *value;
+  int n = value.length();
+  int i = 0;
+
+  while (i < n) {
+    if (!IsIdentifierChar(p[i])) {
+      i++;
+      continue;
+    }
+
+    int start = i;
+    while (i < n && IsIdentifierChar(p[i])) i++;
+    int len = i - start;
+
+    if (IdentifierIs(p + start, len, "function") ||
+        IdentifierIs(p + start, len, "Function") ||
+        IdentifierIs(p + start, len, "eval") ||
+        IdentifierIs(p + start, len, "constructor")) {
+      return true;
+    }
+
+    // get name() { ... } and set name(v) { ... }
+    if (IdentifierIs(p + start, len, "get") ||
+        IdentifierIs(p + start, len, "set")) {
+      int j = i;
+      while (j < n && (p[j] == ' ' || p[j] == '\t' || p[j] == '\n' ||
+                       p[j] == '\r')) {
+        j++;
+      }
+      if (j > i && j < n &&
+          (IsIdentifierChar(p[j]) || p[j] == '"' || p[j] == '\'')) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+
+// Compiled code for runInContext() and runInNewContext(), which callers
+// tend to hand the same source over and over. Scripts from Script::New()
+// aren't bound to a context so one entry serves every sandbox. The table is
+// direct mapped on a hash of the source; a collision just evicts.
+#define SCRIPT_CACHE_SIZE 64
+
+struct CachedScript {
+  uint32_t hash;
+  Persistent<String> source;
+  Persistent<String> filename;
+  Persistent<Script> script;
+};
+
+static CachedScript script_cache[SCRIPT_CACHE_SIZE];
+
+
+static uint32_t HashSource(Handle<String> source) {
+  String::Value value(source);
+  uint32_t hash = 2166136261u;  // FNV-1a
+
+  for (int i = 0; i < value.length(); i++) {
+    hash = (hash ^ (*value)[i]) * 16777619u;
+  }
+
+  return hash;
+}
+
+
+// Returns an empty handle with the exception pending in the caller's
+// TryCatch when the code doesn't compile.
+static Handle<Script> CompileCached(Handle<String> code,
+                                    Handle<String> filename) {
+  HandleScope scope;
+
+  uint32_t hash = HashSource(code);
+  CachedScript& entry = script_cache[hash % SCRIPT_CACHE_SIZE];
+
+  if (!entry.script.IsEmpty() &&
+      entry.hash == hash &&
+      entry.source->StrictEquals(code) &&
+      entry.filename->StrictEquals(filename)) {
+    return scope.Close(Local<Script>::New(entry.script));
+  }
+
+  Local<Script> script = Script::New(code, filename);
+  if (script.IsEmpty()) return Handle<Script>();
+
+  entry.source.Dispose();
+  entry.filename.Dispose();
+  entry.script.Dispose();
+
+  entry.hash = hash;
+  entry.source = Persistent<String>::New(code);
+  entry.filename = Persistent<String>::New(filename);
+  entry.script = Persistent<Script>::New(script);
+
+  return scope.Close(script);
+}
+
+
 void WrappedContext::Initialize(Handle<Object> target) {
   HandleScope scope;
 
@@ -193,6 +527,10 @@ void WrappedScript::Initialize(Handle<Object> target) {
                   "runInNewContext",
                   WrappedScript::CompileRunInNewContext);
 
+  NODE_SET_METHOD(constructor_template,
+                  "setContextPoolSize",
+                  WrappedScript::SetContextPoolSize);
+
   target->Set(String::NewSymbol("NodeScript"),
               constructor_template->GetFunction());
 }
@@ -276,6 +614,15 @@ Handle<Value> WrappedScript::CompileRunInNewContext(const Arguments& args) {
 }
 
 
+Handle<Value> WrappedScript::SetContextPoolSize(const Arguments& args) {
+  HandleScope scope;
+
+  PooledContext::SetPoolSize(args[0]->Int32Value());
+
+  return v8::Undefined();
+}
+
+
 template <WrappedScript::EvalInputFlags input_flag,
           WrappedScript::EvalContextFlags context_flag,
           WrappedScript::EvalOutputFlags output_flag>
@@ -322,10 +669,26 @@ Handle<Value> WrappedScript::EvalMachine(const Arguments& args) {
   }
 
   Persistent<Context> context;
+  PooledContext* pooled = NULL;
+  bool poolable = false;
+
+  if (context_flag == newContext && context_pool_size > 0) {
+    if (input_flag == compileCode) {
+      poolable = !CreatesFunctions(code);
+    } else {
+      WrappedScript *n_script = ObjectWrap::Unwrap<WrappedScript>(args.Holder());
+      poolable = n_script && !n_script->creates_functions_;
+    }
+  }
 
   Local<Array> keys;
   unsigned int i;
-  if (context_flag == newContext) {
+  if (poolable) {
+    // Take one from the pool, it reads the sandbox directly.
+    pooled = PooledContext::Acquire(sandbox);
+    context = pooled->context_;
+
+  } else if (context_flag == newContext) {
     // Create the new context
     context = Context::New();
 
@@ -343,7 +706,7 @@ Handle<Value> WrappedScript::EvalMachine(const Arguments& args) {
 
     // Copy everything from the passed in sandbox (either the persistent
     // context for runInContext(), or the sandbox arg to runInNewContext()).
-    keys = sandbox->GetPropertyNames();
+    keys = pooled ? Array::New() : sandbox->GetPropertyNames();
 
     for (i = 0; i < keys->Length(); i++) {
       Handle<String> key = keys->Get(Integer::New(i))->ToString();
@@ -362,12 +725,27 @@ Handle<Value> WrappedScript::EvalMachine(const Arguments& args) {
   if (input_flag == compileCode) {
     // well, here WrappedScript::New would suffice in all cases, but maybe
     // Compile has a little better performance where possible
-    script = output_flag == returnResult ? Script::Compile(code, filename)
-                                         : Script::New(code, filename);
+    if (output_flag == returnResult && context_flag != thisContext) {
+      script = CompileCached(code, filename);
+    } else {
+      script = output_flag == returnResult ? Script::Compile(code, filename)
+                                           : Script::New(code, filename);
+    }
     if (script.IsEmpty()) {
       // FIXME UGLY HACK TO DISPLAY SYNTAX ERRORS.
       if (display_error) DisplayExceptionLine(try_catch);
 
+      if (pooled) {
+        context->Exit();
+        pooled->Release(false);
+      } else if (context_flag == newContext) {
+        context->DetachGlobal();
+        context->Exit();
+        context.Dispose();
+      } else if (context_flag == userContext) {
+        context->Exit();
+      }
+
       // Hack because I can't get a proper stacktrace on SyntaxError
       return try_catch.ReThrow();
     }
@@ -389,7 +767,10 @@ Handle<Value> WrappedScript::EvalMachine(const Arguments& args) {
   if (output_flag == returnResult) {
     result = script->Run();
     if (result.IsEmpty()) {
-      if (context_flag == newContext) {
+      if (pooled) {
+        context->Exit();
+        pooled->Release(false);
+      } else if (context_flag == newContext) {
         context->DetachGlobal();
         context->Exit();
         context.Dispose();
@@ -403,10 +784,17 @@ Handle<Value> WrappedScript::EvalMachine(const Arguments& args) {
             String::New("Must be called as a method of Script.")));
     }
     n_script->script_ = Persistent<Script>::New(script);
+    n_script->creates_functions_ = input_flag != compileCode ||
+                                   CreatesFunctions(code);
     result = args.This();
   }
 
-  if (context_flag == userContext || context_flag == newContext) {
+  if (pooled) {
+    // Everything but declarations went to the sandbox already.
+    context->Exit();
+    pooled->Release(true);
+
+  } else if (context_flag == userContext || context_flag == newContext) {
     // success! copy changes back onto the sandbox object.
     keys = context->Global()->GetPropertyNames();
     for (i = 0; i < keys->Length(); i++) {
@@ -417,7 +805,9 @@ Handle<Value> WrappedScript::EvalMachine(const Arguments& args) {
     }
   }
 
-  if (context_flag == newContext) {
+  if (pooled) {
+    // Already back in the pool.
+  } else if (context_flag == newContext) {
     // Clean up, clean up, everybody everywhere!
     context->DetachGlobal();
     context->Exit();
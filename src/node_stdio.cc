@@ -20,11 +20,18 @@
 // USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <node_stdio.h>
+#include <node_buffer.h>
 
 #include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
 #include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <sys/uio.h>
 #if defined(__APPLE__) || defined(__OpenBSD__)
 # include <util.h>
 #elif __FreeBSD__
@@ -163,7 +170,389 @@ static Handle<Value> IsATTY (const Arguments& args) {
 }
 
 
-/* STDERR IS ALWAY SYNC ALWAYS UTF8 */
+// Background writers for stdout and stderr, started by
+// process.binding('stdio').startWriter(). A write copies the data into a ring
+// buffer and returns; a thread per fd drains the ring with writev(), so a
+// stalled reader on the other end of the pipe no longer stalls the event loop.
+//
+// The main thread is the only producer and the writer thread the only
+// consumer, so neither takes a lock to move data. The mutex and condition
+// variables are only touched when one side has to sleep: the writer when the
+// ring is empty, the main thread when the ring is full under
+// OVERFLOW_BLOCK.
+enum OverflowPolicy {
+  OVERFLOW_BLOCK,  // wait for the writer to make room
+  OVERFLOW_DROP,   // drop the write
+  OVERFLOW_COUNT   // drop the write, note how many were lost in the output
+};
+
+struct StdioWriter {
+  int fd;
+  OverflowPolicy policy;
+
+  char* buf;
+  size_t size;              // a power of two
+  volatile size_t head;     // advanced by the writer thread
+  volatile size_t tail;     // advanced by the main thread
+
+  volatile int sleeping;    // writer waits on data_cond
+  volatile int waiting;     // main thread waits on space_cond
+  volatile int closing;
+  volatile int done;        // the writer thread has returned
+  volatile int error;       // errno of the write that failed, if any
+
+  double written;           // bytes
+  double dropped;           // writes
+  unsigned int unreported;  // writes dropped since the last note
+
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t data_cond;
+  pthread_cond_t space_cond;
+};
+
+#define STDIO_WRITER_MIN (4 * 1024)
+#define STDIO_WRITER_MAX (256 * 1024 * 1024)
+// How long StopWriter waits for a writer that isn't getting anywhere.
+#define STDIO_WRITER_STALL_MS 1000
+
+static StdioWriter* writers[3];
+
+
+static void* WriterThread(void* arg) {
+  StdioWriter* w = static_cast<StdioWriter*>(arg);
+  struct iovec iov[2];
+
+  for (;;) {
+    size_t head = w->head;
+    size_t tail = w->tail;
+    __sync_synchronize();
+
+    if (head == tail) {
+      if (w->closing) break;
+
+      pthread_mutex_lock(&w->mutex);
+      w->sleeping = 1;
+      __sync_synchronize();
+      if (w->tail == w->head && !w->closing) {
+        pthread_cond_wait(&w->data_cond, &w->mutex);
+      }
+      w->sleeping = 0;
+      pthread_mutex_unlock(&w->mutex);
+      continue;
+    }
+
+    size_t start = head & (w->size - 1);
+    size_t len = tail - head;
+    size_t first = w->size - start < len ? w->size - start : len;
+    int iovcnt = 1;
+
+    iov[0].iov_base = w->buf + start;
+    iov[0].iov_len = first;
+    if (len > first) {
+      iov[1].iov_base = w->buf;
+      iov[1].iov_len = len - first;
+      iovcnt = 2;
+    }
+
+    ssize_t r = writev(w->fd, iov, iovcnt);
+
+    if (r < 0) {
+      if (errno == EINTR) continue;
+
+      if (errno == EAGAIN) {
+        // stdout is non-blocking when it is a tty.
+        struct pollfd pfd;
+        pfd.fd = w->fd;
+        pfd.events = POLLOUT;
+        poll(&pfd, 1, -1);
+        continue;
+      }
+
+      // Nobody is reading anymore. Keep draining so that the main thread
+      // never blocks on a ring that cannot empty.
+      w->error = errno;
+      r = len;
+    } else {
+      w->written += r;
+    }
+
+    __sync_synchronize();
+    w->head = head + r;
+    __sync_synchronize();
+
+    if (w->waiting) {
+      pthread_mutex_lock(&w->mutex);
+      pthread_cond_signal(&w->space_cond);
+      pthread_mutex_unlock(&w->mutex);
+    }
+  }
+
+  pthread_mutex_lock(&w->mutex);
+  w->done = 1;
+  pthread_cond_signal(&w->space_cond);
+  pthread_mutex_unlock(&w->mutex);
+
+  return NULL;
+}
+
+
+static void WakeWriter(StdioWriter* w) {
+  __sync_synchronize();
+  if (w->sleeping) {
+    pthread_mutex_lock(&w->mutex);
+    pthread_cond_signal(&w->data_cond);
+    pthread_mutex_unlock(&w->mutex);
+  }
+}
+
+
+static size_t WriterSpace(StdioWriter* w) {
+  __sync_synchronize();
+  return w->size - (w->tail - w->head);
+}
+
+
+// Copies `len` bytes into the ring. The caller has checked that they fit.
+static void WriterPut(StdioWriter* w, const char* data, size_t len) {
+  size_t tail = w->tail;
+  size_t start = tail & (w->size - 1);
+  size_t first = w->size - start < len ? w->size - start : len;
+
+  memcpy(w->buf + start, data, first);
+  memcpy(w->buf, data + first, len - first);
+
+  __sync_synchronize();
+  w->tail = tail + len;
+}
+
+
+// Returns false if the write was dropped.
+static bool WriterPush(StdioWriter* w, const char* data, size_t len) {
+  if (w->policy == OVERFLOW_BLOCK) {
+    // Writes larger than the ring go in pieces.
+    while (len > 0) {
+      size_t space = WriterSpace(w);
+
+      if (space == 0) {
+        pthread_mutex_lock(&w->mutex);
+        w->waiting = 1;
+        __sync_synchronize();
+        if (WriterSpace(w) == 0) {
+          pthread_cond_wait(&w->space_cond, &w->mutex);
+        }
+        w->waiting = 0;
+        pthread_mutex_unlock(&w->mutex);
+        continue;
+      }
+
+      size_t n = space < len ? space : len;
+      WriterPut(w, data, n);
+      WakeWriter(w);
+      data += n;
+      len -= n;
+    }
+    return true;
+  }
+
+  char note[64];
+  size_t note_len = 0;
+
+  if (w->unreported > 0 && w->policy == OVERFLOW_COUNT) {
+    note_len = snprintf(note, sizeof note, "(%u writes dropped)\n",
+                        w->unreported);
+  }
+
+  if (WriterSpace(w) < note_len + len) {
+    w->dropped++;
+    w->unreported++;
+    return false;
+  }
+
+  if (note_len > 0) WriterPut(w, note, note_len);
+  WriterPut(w, data, len);
+  w->unreported = 0;
+  WakeWriter(w);
+
+  return true;
+}
+
+
+static StdioWriter* GetWriter(Handle<Value> fd_value) {
+  int fd = fd_value->Int32Value();
+  if (fd != STDOUT_FILENO && fd != STDERR_FILENO) return NULL;
+  return writers[fd];
+}
+
+
+// process.binding('stdio').startWriter(fd, bufferSize, overflow);
+// fd is stdoutFD or stderrFD, overflow is 'block', 'drop' or 'count'.
+static Handle<Value> StartWriter(const Arguments& args) {
+  HandleScope scope;
+
+  int fd = args[0]->Int32Value();
+  if (fd != STDOUT_FILENO && fd != STDERR_FILENO) {
+    return ThrowException(Exception::TypeError(
+          String::New("Only stdout and stderr can have a writer")));
+  }
+
+  if (writers[fd]) {
+    return False();
+  }
+
+  OverflowPolicy policy = OVERFLOW_BLOCK;
+  if (args[2]->IsString()) {
+    String::AsciiValue name(args[2]);
+    if (strcmp(*name, "drop") == 0) {
+      policy = OVERFLOW_DROP;
+    } else if (strcmp(*name, "count") == 0) {
+      policy = OVERFLOW_COUNT;
+    } else if (strcmp(*name, "block") != 0) {
+      return ThrowException(Exception::TypeError(
+            String::New("Unknown overflow policy")));
+    }
+  }
+
+  size_t size = STDIO_WRITER_MIN;
+  double wanted = args[1]->NumberValue();
+  while (size < wanted && size < STDIO_WRITER_MAX) size *= 2;
+
+  StdioWriter* w = new StdioWriter;
+  memset(w, 0, sizeof *w);
+  w->fd = fd;
+  w->policy = policy;
+  w->size = size;
+  w->buf = new char[size];
+
+  pthread_mutex_init(&w->mutex, NULL);
+  pthread_cond_init(&w->data_cond, NULL);
+  pthread_cond_init(&w->space_cond, NULL);
+
+  // Signals are for the main thread.
+  sigset_t set, old;
+  sigfillset(&set);
+  pthread_sigmask(SIG_SETMASK, &set, &old);
+  int r = pthread_create(&w->thread, NULL, WriterThread, w);
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+  if (r) {
+    pthread_cond_destroy(&w->space_cond);
+    pthread_cond_destroy(&w->data_cond);
+    pthread_mutex_destroy(&w->mutex);
+    delete [] w->buf;
+    delete w;
+    return ThrowException(ErrnoException(r, "pthread_create"));
+  }
+
+  writers[fd] = w;
+
+  return True();
+}
+
+
+// process.binding('stdio').writeAsync(fd, data);
+// data is a string, written as UTF-8, or a Buffer. Returns false if the
+// write was dropped.
+static Handle<Value> WriteAsync(const Arguments& args) {
+  HandleScope scope;
+
+  StdioWriter* w = GetWriter(args[0]);
+  if (!w) {
+    return ThrowException(Exception::Error(
+          String::New("No writer started for this fd")));
+  }
+
+  bool queued;
+
+  if (Buffer::HasInstance(args[1])) {
+    Local<Object> buffer = args[1]->ToObject();
+    queued = WriterPush(w, Buffer::Data(buffer), Buffer::Length(buffer));
+  } else {
+    String::Utf8Value data(args[1]->ToString());
+    queued = WriterPush(w, *data, data.length());
+  }
+
+  return queued ? True() : False();
+}
+
+
+// process.binding('stdio').writerStats(fd);
+static Handle<Value> WriterStats(const Arguments& args) {
+  HandleScope scope;
+
+  StdioWriter* w = GetWriter(args[0]);
+  if (!w) return Null();
+
+  Local<Object> stats = Object::New();
+  stats->Set(String::NewSymbol("bufferSize"), Number::New(w->size));
+  stats->Set(String::NewSymbol("pending"),
+             Number::New(w->size - WriterSpace(w)));
+  stats->Set(String::NewSymbol("written"), Number::New(w->written));
+  stats->Set(String::NewSymbol("dropped"), Number::New(w->dropped));
+  if (w->error) {
+    stats->Set(String::NewSymbol("error"), ErrnoException(w->error, "writev"));
+  }
+
+  return scope.Close(stats);
+}
+
+
+// Writes out whatever is still queued and stops the writer. If the reader
+// has stopped reading, writev() blocks for good; once the writer hasn't
+// moved for STDIO_WRITER_STALL_MS it is detached, with the rest unwritten.
+static void StopWriter(int fd) {
+  StdioWriter* w = writers[fd];
+  if (!w) return;
+
+  writers[fd] = NULL;
+
+  pthread_mutex_lock(&w->mutex);
+  w->closing = 1;
+  w->waiting = 1;  // have the writer signal space_cond as it makes progress
+  __sync_synchronize();
+  pthread_cond_signal(&w->data_cond);
+
+  size_t head = w->head;
+  struct timeval now;
+  struct timespec deadline;
+
+  while (!w->done) {
+    gettimeofday(&now, NULL);
+    deadline.tv_sec = now.tv_sec + STDIO_WRITER_STALL_MS / 1000;
+    deadline.tv_nsec = now.tv_usec * 1000 +
+                       (STDIO_WRITER_STALL_MS % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000;
+    }
+
+    int r = pthread_cond_timedwait(&w->space_cond, &w->mutex, &deadline);
+
+    if (r == ETIMEDOUT && !w->done && w->head == head) break;
+    head = w->head;
+  }
+
+  int done = w->done;
+  pthread_mutex_unlock(&w->mutex);
+
+  if (!done) {
+    // It still owns `w`, which is never freed.
+    pthread_detach(w->thread);
+    return;
+  }
+
+  pthread_join(w->thread, NULL);
+
+  if (w->unreported > 0 && w->policy == OVERFLOW_COUNT && !w->error) {
+    char note[64];
+    int len = snprintf(note, sizeof note, "(%u writes dropped)\n",
+                       w->unreported);
+    write(fd, note, len);
+  }
+}
+
+
+/* STDERR IS ALWAY SYNC ALWAYS UTF8, UNLESS IT HAS A WRITER */
 static Handle<Value> WriteError (const Arguments& args) {
   HandleScope scope;
 
@@ -173,6 +562,11 @@ static Handle<Value> WriteError (const Arguments& args) {
 
   String::Utf8Value msg(args[0]->ToString());
 
+  if (writers[STDERR_FILENO]) {
+    return WriterPush(writers[STDERR_FILENO], *msg, msg.length()) ? True()
+                                                                   : False();
+  }
+
   ssize_t r;
   size_t written = 0;
   while (written < (size_t) msg.length()) {
@@ -274,6 +668,9 @@ typedef void (*sighandler)(int);
 
 
 void Stdio::Flush() {
+  StopWriter(STDOUT_FILENO);
+  StopWriter(STDERR_FILENO);
+
   if (stdin_flags != -1) {
     fcntl(STDIN_FILENO, F_SETFL, stdin_flags & ~O_NONBLOCK);
   }
@@ -309,6 +706,9 @@ void Stdio::Initialize(v8::Handle<v8::Object> target) {
   target->Set(String::NewSymbol("stdinFD"), Integer::New(STDIN_FILENO));
 
   NODE_SET_METHOD(target, "writeError", WriteError);
+  NODE_SET_METHOD(target, "startWriter", StartWriter);
+  NODE_SET_METHOD(target, "writeAsync", WriteAsync);
+  NODE_SET_METHOD(target, "writerStats", WriterStats);
   NODE_SET_METHOD(target, "openStdin", OpenStdin);
   NODE_SET_METHOD(target, "isStdoutBlocking", IsStdoutBlocking);
   NODE_SET_METHOD(target, "isStdinBlocking", IsStdinBlocking);
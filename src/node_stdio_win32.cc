@@ -477,7 +477,7 @@ static void tty_watcher_start() {
   assert(tty_watcher_initialized);
   if (!tty_watcher_active) {
     tty_watcher_active = true;
-    uv_ref(uv_default_loop());
+    uv_ref(Loop());
     tty_watcher_arm();
   }
 }
@@ -486,7 +486,7 @@ static void tty_watcher_start() {
 static void tty_watcher_stop() {
   if (tty_watcher_active) {
     tty_watcher_active = false;
-    uv_unref(uv_default_loop());
+    uv_unref(Loop());
     tty_watcher_disarm();
   }
 }
@@ -668,8 +668,8 @@ static Handle<Value> StopTTYWatcher(const Arguments& args) {
 void Stdio::Initialize(v8::Handle<v8::Object> target) {
   init_scancode_table();
   
-  uv_async_init(uv_default_loop(), &tty_avail_notifier, tty_poll);
-  uv_unref(uv_default_loop());
+  uv_async_init(Loop(), &tty_avail_notifier, tty_poll);
+  uv_unref(Loop());
 
   /* Set stdio streams to binary mode. */
   _setmode(_fileno(stdin), _O_BINARY);
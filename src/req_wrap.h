@@ -3,18 +3,29 @@
 
 namespace node {
 
+// Request objects that script may abort with req.cancel(). The object holds
+// a pointer to the uv request until the request is deleted.
+v8::Local<v8::Object> NewCancelableReq(uv_req_t* req);
+void DetachCancelableReq(v8::Handle<v8::Object> object);
+
 template <typename T>
 class ReqWrap {
  public:
-  ReqWrap() {
+  explicit ReqWrap(bool cancelable = false) : cancelable_(cancelable) {
     v8::HandleScope scope;
-    object_ = v8::Persistent<v8::Object>::New(v8::Object::New());
+    if (cancelable) {
+      object_ = v8::Persistent<v8::Object>::New(
+          NewCancelableReq(reinterpret_cast<uv_req_t*>(&req_)));
+    } else {
+      object_ = v8::Persistent<v8::Object>::New(v8::Object::New());
+    }
   }
 
   ~ReqWrap() {
     // Assert that someone has called Dispatched()
     assert(req_.data == this);
     assert(!object_.IsEmpty());
+    if (cancelable_) DetachCancelableReq(object_);
     object_.Dispose();
     object_.Clear();
   }
@@ -27,6 +38,9 @@ class ReqWrap {
   v8::Persistent<v8::Object> object_;
   T req_;
   void* data_;
+
+ private:
+  bool cancelable_;
 };
 
 
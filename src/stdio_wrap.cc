@@ -51,6 +51,10 @@ class StdIOWrap : StreamWrap {
     NODE_SET_PROTOTYPE_METHOD(t, "readStart", StreamWrap::ReadStart);
     NODE_SET_PROTOTYPE_METHOD(t, "readStop", StreamWrap::ReadStop);
     NODE_SET_PROTOTYPE_METHOD(t, "write", StreamWrap::Write);
+    NODE_SET_PROTOTYPE_METHOD(t, "writev", StreamWrap::Writev);
+    NODE_SET_PROTOTYPE_METHOD(t, "tryWrite", StreamWrap::TryWrite);
+    NODE_SET_PROTOTYPE_METHOD(t, "cork", StreamWrap::Cork);
+    NODE_SET_PROTOTYPE_METHOD(t, "uncork", StreamWrap::Uncork);
     NODE_SET_PROTOTYPE_METHOD(t, "listen", Listen);
 
     constructor = Persistent<Function>::New(t->GetFunction());
@@ -69,7 +73,7 @@ class StdIOWrap : StreamWrap {
 
     assert(stdHandleType == UV_STDIN || stdHandleType == UV_STDOUT || stdHandleType == UV_STDERR);
 
-    uv_stream_t* stdHandle = uv_std_handle(uv_default_loop(), stdHandleType);
+    uv_stream_t* stdHandle = uv_std_handle(Loop(), stdHandleType);
     if (stdHandle) {
       HandleScope scope;
       StdIOWrap* wrap = new StdIOWrap(args.This());
@@ -98,7 +102,7 @@ class StdIOWrap : StreamWrap {
     int r = uv_listen(wrap->handle_, SOMAXCONN, OnConnection);
 
     // Error starting the pipe.
-    if (r) SetErrno(uv_last_error(uv_default_loop()).code);
+    if (r) SetErrno(uv_last_error(Loop()).code);
 
     return scope.Close(Integer::New(r));
   }
@@ -25,6 +25,10 @@ using v8::TryCatch;
 using v8::Context;
 using v8::Arguments;
 using v8::Integer;
+using v8::Number;
+using v8::Array;
+using v8::Exception;
+using v8::ThrowException;
 
 
 #define UNWRAP \
@@ -40,6 +44,7 @@ using v8::Integer;
 
 typedef class ReqWrap<uv_shutdown_t> ShutdownWrap;
 typedef class ReqWrap<uv_write_t> WriteWrap;
+typedef class ReqWrap<uv_splice_t> SpliceWrap;
 
 
 static size_t slab_used;
@@ -98,7 +103,7 @@ Handle<Value> StreamWrap::ReadStart(const Arguments& args) {
   int r = uv_read_start(wrap->stream_, OnAlloc, OnRead);
 
   // Error starting the tcp.
-  if (r) SetErrno(uv_last_error(uv_default_loop()).code);
+  if (r) SetErrno(uv_last_error(Loop()).code);
 
   return scope.Close(Integer::New(r));
 }
@@ -112,7 +117,37 @@ Handle<Value> StreamWrap::ReadStop(const Arguments& args) {
   int r = uv_read_stop(wrap->stream_);
 
   // Error starting the tcp.
-  if (r) SetErrno(uv_last_error(uv_default_loop()).code);
+  if (r) SetErrno(uv_last_error(Loop()).code);
+
+  return scope.Close(Integer::New(r));
+}
+
+
+// Writes issued between cork() and uncork() are queued and go out together,
+// in a single writev where they fit.
+Handle<Value> StreamWrap::Cork(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP
+
+  int r = uv_cork(wrap->stream_);
+
+  if (r) SetErrno(uv_last_error(Loop()).code);
+
+  return scope.Close(Integer::New(r));
+}
+
+
+Handle<Value> StreamWrap::Uncork(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP
+
+  int r = uv_uncork(wrap->stream_);
+
+  if (r) SetErrno(uv_last_error(Loop()).code);
+
+  wrap->UpdateWriteQueueSize();
 
   return scope.Close(Integer::New(r));
 }
@@ -189,7 +224,7 @@ void StreamWrap::OnRead(uv_stream_t* handle, ssize_t nread, uv_buf_t buf) {
       slab_used -= buf.len;
     }
 
-    SetErrno(uv_last_error(uv_default_loop()).code);
+    SetErrno(uv_last_error(Loop()).code);
     MakeCallback(wrap->object_, "onread", 0, NULL);
     return;
   }
@@ -246,7 +281,104 @@ Handle<Value> StreamWrap::Write(const Arguments& args) {
   wrap->UpdateWriteQueueSize();
 
   if (r) {
-    SetErrno(uv_last_error(uv_default_loop()).code);
+    SetErrno(uv_last_error(Loop()).code);
+    delete req_wrap;
+    return scope.Close(v8::Null());
+  } else {
+    return scope.Close(req_wrap->object_);
+  }
+}
+
+
+// Writes what the socket takes right now, without a request object or a
+// callback. Returns the number of bytes written, which is 0 when earlier
+// writes are still queued, or -1 on error. The caller write()s the rest.
+Handle<Value> StreamWrap::TryWrite(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP
+
+  // The first argument is a buffer.
+  assert(Buffer::HasInstance(args[0]));
+  Local<Object> buffer_obj = args[0]->ToObject();
+
+  size_t offset = 0;
+  size_t length = Buffer::Length(buffer_obj);
+
+  if (args.Length() > 1) {
+    offset = args[1]->IntegerValue();
+  }
+
+  if (args.Length() > 2) {
+    length = args[2]->IntegerValue();
+  }
+
+  size_t buffer_length = Buffer::Length(buffer_obj);
+  if (offset > buffer_length) {
+    return ThrowException(Exception::Error(
+          String::New("Offset is out of bounds")));
+  }
+  if (length > buffer_length - offset) {
+    return ThrowException(Exception::Error(
+          String::New("Length extends beyond buffer")));
+  }
+
+  uv_buf_t buf;
+  buf.base = Buffer::Data(buffer_obj) + offset;
+  buf.len = length;
+
+  int r = uv_try_write(wrap->stream_, &buf, 1);
+
+  if (r < 0) SetErrno(uv_last_error(Loop()).code);
+
+  return scope.Close(Integer::New(r));
+}
+
+
+// Like Write() but takes an array of buffers which are written out with a
+// single uv_write() request and a single writev(2) when the socket allows.
+Handle<Value> StreamWrap::Writev(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP
+
+  assert(args[0]->IsArray());
+  Local<Array> chunks = Local<Array>::Cast(args[0]);
+  uint32_t count = chunks->Length();
+
+  uv_buf_t bufs_[16];
+  uv_buf_t* bufs = bufs_;
+
+  if (count > ARRAY_SIZE(bufs_)) {
+    bufs = new uv_buf_t[count];
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> chunk = chunks->Get(i);
+    assert(Buffer::HasInstance(chunk));
+    Local<Object> buffer_obj = chunk->ToObject();
+    bufs[i].base = Buffer::Data(buffer_obj);
+    bufs[i].len = Buffer::Length(buffer_obj);
+  }
+
+  WriteWrap* req_wrap = new WriteWrap();
+
+  // Keep the buffers alive until the write completes.
+  req_wrap->object_->SetHiddenValue(buffer_sym, chunks);
+
+  int r = uv_write(&req_wrap->req_, wrap->stream_, bufs, count,
+                   StreamWrap::AfterWrite);
+
+  if (bufs != bufs_) {
+    delete[] bufs;
+  }
+
+  req_wrap->Dispatched();
+
+  wrap->UpdateWriteQueueSize();
+
+  if (r) {
+    SetErrno(uv_last_error(Loop()).code);
     delete req_wrap;
     return scope.Close(v8::Null());
   } else {
@@ -266,7 +398,7 @@ void StreamWrap::AfterWrite(uv_write_t* req, int status) {
   assert(wrap->object_.IsEmpty() == false);
 
   if (status) {
-    SetErrno(uv_last_error(uv_default_loop()).code);
+    SetErrno(uv_last_error(Loop()).code);
   }
 
   wrap->UpdateWriteQueueSize();
@@ -296,7 +428,7 @@ Handle<Value> StreamWrap::Shutdown(const Arguments& args) {
   req_wrap->Dispatched();
 
   if (r) {
-    SetErrno(uv_last_error(uv_default_loop()).code);
+    SetErrno(uv_last_error(Loop()).code);
     delete req_wrap;
     return scope.Close(v8::Null());
   } else {
@@ -316,7 +448,7 @@ void StreamWrap::AfterShutdown(uv_shutdown_t* req, int status) {
   HandleScope scope;
 
   if (status) {
-    SetErrno(uv_last_error(uv_default_loop()).code);
+    SetErrno(uv_last_error(Loop()).code);
   }
 
   Local<Value> argv[3] = {
@@ -331,4 +463,62 @@ void StreamWrap::AfterShutdown(uv_shutdown_t* req, int status) {
 }
 
 
+// Everything read from this stream is written to the stream passed in, inside
+// libuv. JavaScript only hears about it again through oncomplete, once this
+// stream has ended or either side failed.
+Handle<Value> StreamWrap::Splice(const Arguments& args) {
+  HandleScope scope;
+
+  UNWRAP
+
+  assert(args[0]->IsObject());
+  Local<Object> dst_obj = args[0]->ToObject();
+  assert(dst_obj->InternalFieldCount() > 0);
+  StreamWrap* dst =
+      static_cast<StreamWrap*>(dst_obj->GetPointerFromInternalField(0));
+
+  if (!dst) {
+    SetErrno(UV_EBADF);
+    return scope.Close(v8::Null());
+  }
+
+  SpliceWrap* req_wrap = new SpliceWrap();
+
+  int r = uv_splice(&req_wrap->req_, wrap->stream_, dst->stream_, AfterSplice);
+
+  req_wrap->Dispatched();
+
+  if (r) {
+    SetErrno(uv_last_error(Loop()).code);
+    delete req_wrap;
+    return scope.Close(v8::Null());
+  } else {
+    return scope.Close(req_wrap->object_);
+  }
+}
+
+
+void StreamWrap::AfterSplice(uv_splice_t* req, int status) {
+  SpliceWrap* req_wrap = (SpliceWrap*) req->data;
+
+  // Either stream may have been closed already; only the request is left.
+  assert(req_wrap->object_.IsEmpty() == false);
+
+  HandleScope scope;
+
+  if (status) {
+    SetErrno(uv_last_error(Loop()).code);
+  }
+
+  Local<Value> argv[2] = {
+    Integer::New(status),
+    Number::New(req->bytes)
+  };
+
+  MakeCallback(req_wrap->object_, "oncomplete", 2, argv);
+
+  delete req_wrap;
+}
+
+
 }
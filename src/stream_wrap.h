@@ -15,9 +15,14 @@ class StreamWrap : public HandleWrap {
 
   // JavaScript functions
   static v8::Handle<v8::Value> Write(const v8::Arguments& args);
+  static v8::Handle<v8::Value> Writev(const v8::Arguments& args);
+  static v8::Handle<v8::Value> TryWrite(const v8::Arguments& args);
   static v8::Handle<v8::Value> ReadStart(const v8::Arguments& args);
   static v8::Handle<v8::Value> ReadStop(const v8::Arguments& args);
   static v8::Handle<v8::Value> Shutdown(const v8::Arguments& args);
+  static v8::Handle<v8::Value> Cork(const v8::Arguments& args);
+  static v8::Handle<v8::Value> Uncork(const v8::Arguments& args);
+  static v8::Handle<v8::Value> Splice(const v8::Arguments& args);
 
  protected:
   StreamWrap(v8::Handle<v8::Object> object, uv_stream_t* stream);
@@ -34,6 +39,7 @@ class StreamWrap : public HandleWrap {
   static uv_buf_t OnAlloc(uv_handle_t* handle, size_t suggested_size);
   static void OnRead(uv_stream_t* handle, ssize_t nread, uv_buf_t buf);
   static void AfterShutdown(uv_shutdown_t* req, int status);
+  static void AfterSplice(uv_splice_t* req, int status);
 
   size_t slab_offset_;
   uv_stream_t* stream_;
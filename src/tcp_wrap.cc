@@ -74,7 +74,12 @@ class TCPWrap : public StreamWrap {
     NODE_SET_PROTOTYPE_METHOD(t, "readStart", StreamWrap::ReadStart);
     NODE_SET_PROTOTYPE_METHOD(t, "readStop", StreamWrap::ReadStop);
     NODE_SET_PROTOTYPE_METHOD(t, "write", StreamWrap::Write);
+    NODE_SET_PROTOTYPE_METHOD(t, "writev", StreamWrap::Writev);
+    NODE_SET_PROTOTYPE_METHOD(t, "tryWrite", StreamWrap::TryWrite);
+    NODE_SET_PROTOTYPE_METHOD(t, "cork", StreamWrap::Cork);
+    NODE_SET_PROTOTYPE_METHOD(t, "uncork", StreamWrap::Uncork);
     NODE_SET_PROTOTYPE_METHOD(t, "shutdown", StreamWrap::Shutdown);
+    NODE_SET_PROTOTYPE_METHOD(t, "splice", StreamWrap::Splice);
 
     NODE_SET_PROTOTYPE_METHOD(t, "bind", Bind);
     NODE_SET_PROTOTYPE_METHOD(t, "listen", Listen);
@@ -83,6 +88,7 @@ class TCPWrap : public StreamWrap {
     NODE_SET_PROTOTYPE_METHOD(t, "connect6", Connect6);
     NODE_SET_PROTOTYPE_METHOD(t, "getsockname", GetSockName);
     NODE_SET_PROTOTYPE_METHOD(t, "getpeername", GetPeerName);
+    NODE_SET_PROTOTYPE_METHOD(t, "setNoDelay", SetNoDelay);
 
     tcpConstructor = Persistent<Function>::New(t->GetFunction());
 
@@ -109,7 +115,7 @@ class TCPWrap : public StreamWrap {
 
   TCPWrap(Handle<Object> object) : StreamWrap(object,
                                               (uv_stream_t*) &handle_) {
-    int r = uv_tcp_init(uv_default_loop(), &handle_);
+    int r = uv_tcp_init(Loop(), &handle_);
     assert(r == 0); // How do we proxy this error up to javascript?
                     // Suggestion: uv_tcp_init() returns void.
     UpdateWriteQueueSize();
@@ -135,7 +141,7 @@ class TCPWrap : public StreamWrap {
 
     Local<Object> sockname = Object::New();
     if (r != 0) {
-      SetErrno(uv_last_error(uv_default_loop()).code);
+      SetErrno(uv_last_error(Loop()).code);
     } else {
       family = address.ss_family;
       if (family == AF_INET) {
@@ -173,7 +179,7 @@ class TCPWrap : public StreamWrap {
 
     Local<Object> sockname = Object::New();
     if (r != 0) {
-      SetErrno(uv_last_error(uv_default_loop()).code);
+      SetErrno(uv_last_error(Loop()).code);
     } else {
       family = address.ss_family;
       if (family == AF_INET) {
@@ -195,6 +201,19 @@ class TCPWrap : public StreamWrap {
   }
 
 
+  static Handle<Value> SetNoDelay(const Arguments& args) {
+    HandleScope scope;
+
+    UNWRAP
+
+    int r = uv_tcp_nodelay(&wrap->handle_, args[0]->IsTrue() ? 1 : 0);
+
+    if (r) SetErrno(uv_last_error(Loop()).code);
+
+    return scope.Close(Integer::New(r));
+  }
+
+
   static Handle<Value> Bind(const Arguments& args) {
     HandleScope scope;
 
@@ -207,7 +226,7 @@ class TCPWrap : public StreamWrap {
     int r = uv_tcp_bind(&wrap->handle_, address);
 
     // Error starting the tcp.
-    if (r) SetErrno(uv_last_error(uv_default_loop()).code);
+    if (r) SetErrno(uv_last_error(Loop()).code);
 
     return scope.Close(Integer::New(r));
   }
@@ -224,7 +243,7 @@ class TCPWrap : public StreamWrap {
     int r = uv_tcp_bind6(&wrap->handle_, address);
 
     // Error starting the tcp.
-    if (r) SetErrno(uv_last_error(uv_default_loop()).code);
+    if (r) SetErrno(uv_last_error(Loop()).code);
 
     return scope.Close(Integer::New(r));
   }
@@ -239,7 +258,7 @@ class TCPWrap : public StreamWrap {
     int r = uv_listen((uv_stream_t*)&wrap->handle_, backlog, OnConnection);
 
     // Error starting the tcp.
-    if (r) SetErrno(uv_last_error(uv_default_loop()).code);
+    if (r) SetErrno(uv_last_error(Loop()).code);
 
     return scope.Close(Integer::New(r));
   }
@@ -273,7 +292,7 @@ class TCPWrap : public StreamWrap {
       // Successful accept. Call the onconnection callback in JavaScript land.
       argv[0] = client_obj;
     } else {
-      SetErrno(uv_last_error(uv_default_loop()).code);
+      SetErrno(uv_last_error(Loop()).code);
       argv[0] = v8::Null();
     }
 
@@ -291,7 +310,7 @@ class TCPWrap : public StreamWrap {
     assert(wrap->object_.IsEmpty() == false);
 
     if (status) {
-      SetErrno(uv_last_error(uv_default_loop()).code);
+      SetErrno(uv_last_error(Loop()).code);
     }
 
     Local<Value> argv[3] = {
@@ -326,7 +345,7 @@ class TCPWrap : public StreamWrap {
     req_wrap->Dispatched();
 
     if (r) {
-      SetErrno(uv_last_error(uv_default_loop()).code);
+      SetErrno(uv_last_error(Loop()).code);
       delete req_wrap;
       return scope.Close(v8::Null());
     } else {
@@ -352,7 +371,7 @@ class TCPWrap : public StreamWrap {
     req_wrap->Dispatched();
 
     if (r) {
-      SetErrno(uv_last_error(uv_default_loop()).code);
+      SetErrno(uv_last_error(Loop()).code);
       delete req_wrap;
       return scope.Close(v8::Null());
     } else {
@@ -80,7 +80,7 @@ private:
 
 UDPWrap::UDPWrap(Handle<Object> object): HandleWrap(object,
                                                     (uv_handle_t*)&handle_) {
-  int r = uv_udp_init(uv_default_loop(), &handle_);
+  int r = uv_udp_init(Loop(), &handle_);
   assert(r == 0); // can't fail anyway
   handle_.data = reinterpret_cast<void*>(this);
 }
@@ -153,7 +153,7 @@ Handle<Value> UDPWrap::DoBind(const Arguments& args, int family) {
   }
 
   if (r)
-    SetErrno(uv_last_error(uv_default_loop()).code);
+    SetErrno(uv_last_error(Loop()).code);
 
   return scope.Close(Integer::New(r));
 }
@@ -210,7 +210,7 @@ Handle<Value> UDPWrap::DoSend(const Arguments& args, int family) {
   req_wrap->Dispatched();
 
   if (r) {
-    SetErrno(uv_last_error(uv_default_loop()).code);
+    SetErrno(uv_last_error(Loop()).code);
     delete req_wrap;
     return Null();
   }
@@ -237,8 +237,8 @@ Handle<Value> UDPWrap::RecvStart(const Arguments& args) {
 
   // UV_EALREADY means that the socket is already bound but that's okay
   int r = uv_udp_recv_start(&wrap->handle_, OnAlloc, OnRecv);
-  if (r && uv_last_error(uv_default_loop()).code != UV_EALREADY) {
-    SetErrno(uv_last_error(uv_default_loop()).code);
+  if (r && uv_last_error(Loop()).code != UV_EALREADY) {
+    SetErrno(uv_last_error(Loop()).code);
     return False();
   }
 
@@ -274,7 +274,7 @@ Handle<Value> UDPWrap::GetSockName(const Arguments& args) {
     return scope.Close(sockname);
   }
   else {
-    SetErrno(uv_last_error(uv_default_loop()).code);
+    SetErrno(uv_last_error(Loop()).code);
     return Null();
   }
 }
@@ -293,7 +293,7 @@ void UDPWrap::OnSend(uv_udp_send_t* req, int status) {
   assert(wrap->object_.IsEmpty() == false);
 
   if (status) {
-    SetErrno(uv_last_error(uv_default_loop()).code);
+    SetErrno(uv_last_error(Loop()).code);
   }
 
   Local<Value> argv[4] = {
@@ -341,12 +341,13 @@ void UDPWrap::OnRecv(uv_udp_t* handle,
   };
 
   if (nread == -1) {
-    SetErrno(uv_last_error(uv_default_loop()).code);
+    ReleaseMemory(buf.base, NULL);
+    SetErrno(uv_last_error(Loop()).code);
   }
   else {
     Local<Object> rinfo = Object::New();
     AddressToJS(rinfo, addr, sizeof *addr);
-    argv[2] = Buffer::New(buf.base, nread, ReleaseMemory, NULL)->handle_;
+    argv[2] = Buffer::NewExternal(buf.base, nread, buf.len)->handle_;
     argv[3] = rinfo;
   }
 
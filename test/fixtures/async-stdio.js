@@ -0,0 +1,50 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+
+var overflow = process.argv[2];
+var lines = parseInt(process.argv[3], 10);
+
+if (process.argv[4] === 'stall') {
+  // The parent doesn't read: this fills the pipe and leaves the rest in the
+  // ring, so the writer is stuck in writev() when the process exits.
+  process.asyncStdio({ bufferSize: 1024 * 1024, overflow: overflow });
+  var kb = new Array(1025).join('x');
+  for (var i = 0; i < lines; i++) {
+    process.stdout.write(kb);
+  }
+  process.exit(0);
+}
+
+process.asyncStdio({ bufferSize: 4096, overflow: overflow });
+
+if (overflow !== 'block') {
+  // Larger than the whole ring, so it can never fit.
+  process.stdout.write(new Array(8193).join('x'));
+}
+
+for (var i = 0; i < lines; i++) {
+  console.log('line ' + i);
+}
+console.error('stderr ' + process.stdout.writerStats().written);
+
+process.exit(0);
@@ -0,0 +1,76 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+
+try {
+  var binding = process.binding('async_queue');
+} catch (e) {
+  console.log('Not compiled with --with-test-bindings.');
+  process.exit();
+}
+
+// Several threads push onto one queue; every item arrives exactly once and
+// each thread's items arrive in the order they were pushed.
+var WORKERS = 4;
+var COUNT = 10000;
+
+var seen = [];
+var last = [];
+var batches = 0;
+var received = 0;
+var closed = false;
+
+for (var i = 0; i < WORKERS; i++) last[i] = -1;
+
+var queue = {
+  onbatch: function(items) {
+    assert.ok(Array.isArray(items));
+    assert.ok(items.length > 0);
+    assert.ok(!closed);
+    batches++;
+
+    items.forEach(function(n) {
+      assert.ok(!seen[n], 'delivered twice: ' + n);
+      seen[n] = true;
+
+      var worker = Math.floor(n / COUNT);
+      assert.ok(n > last[worker], 'out of order: ' + n);
+      last[worker] = n;
+    });
+
+    received += items.length;
+    if (received == WORKERS * COUNT) {
+      queue.close();
+      closed = true;
+    }
+  }
+};
+
+binding.fill(queue, WORKERS, COUNT);
+
+process.on('exit', function() {
+  assert.equal(WORKERS * COUNT, received);
+  assert.ok(closed);
+  // Items are handed over a batch at a time, not one callback each.
+  assert.ok(batches < received);
+});
@@ -0,0 +1,103 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+
+function toArray(a, start, end) {
+  return Array.prototype.slice.call(a, start, end);
+}
+
+// Floats and doubles go through SlowBuffer, so check them on a slice that
+// does not start at the beginning of its parent.
+var pool = new Buffer(32);
+var buf = pool.slice(5, 21);
+
+buf.writeFloatLE(-2, 0);
+assert.deepEqual([0, 0, 0, 0xc0], [buf[0], buf[1], buf[2], buf[3]]);
+assert.equal(-2, pool.readFloatLE(5));
+buf.writeFloatBE(0.3333333432674408, 4);
+assert.equal(0.3333333432674408, buf.readFloatBE(4));
+assert.equal(-1.2126478207002966e-12, buf.readFloatLE(4));
+
+buf.writeDoubleBE(0xdeadbeefcafebabe, 8);
+assert.deepEqual([0x43, 0xeb, 0xd5, 0xb7, 0xdd, 0xf9, 0x5f, 0xd7],
+                 toArray(buf, 8, 16));
+assert.equal(0xdeadbeefcafebabe, buf.readDoubleBE(8));
+buf.writeDoubleLE(1/3, 8);
+assert.equal(1/3, buf.readDoubleLE(8));
+
+assert.throws(function() {
+  buf.readDoubleLE(9);
+});
+
+// readArray
+var bytes = new Buffer([1, 2, 3, 4, 5, 6, 7, 8]);
+
+var u16 = bytes.readArray(0, new Uint16Array(4));
+assert.deepEqual([0x0102, 0x0304, 0x0506, 0x0708], toArray(u16));
+bytes.readArray(0, u16, true);
+assert.deepEqual([0x0201, 0x0403, 0x0605, 0x0807], toArray(u16));
+
+var i16 = bytes.slice(2).readArray(0, new Int16Array(3), true);
+assert.deepEqual([0x0403, 0x0605, 0x0807], toArray(i16));
+
+var u32 = bytes.readArray(4, new Uint32Array(1));
+assert.equal(0x05060708, u32[0]);
+
+var u8 = bytes.readArray(6, new Uint8Array(2), true);
+assert.deepEqual([7, 8], toArray(u8));
+
+assert.throws(function() {
+  bytes.readArray(1, new Uint32Array(2));
+});
+assert.throws(function() {
+  bytes.readArray(0, [1, 2]);
+});
+assert.throws(function() {
+  bytes.slice(4).readArray(-4, new Uint8Array(4));
+});
+
+// writeArray
+var doubles = new Float64Array([1.5, -1/3, 1e300]);
+var out = new Buffer(24);
+
+assert.equal(24, out.writeArray(0, doubles));
+assert.equal(1.5, out.readDoubleBE(0));
+assert.equal(-1/3, out.readDoubleBE(8));
+assert.equal(1e300, out.readDoubleBE(16));
+
+out.writeArray(0, doubles, true);
+assert.equal(-1/3, out.readDoubleLE(8));
+assert.deepEqual(toArray(doubles),
+                 toArray(out.readArray(0, new Float64Array(3), true)));
+
+var floats = new Float32Array([1, -2]);
+assert.equal(8, out.writeArray(0, floats));
+assert.deepEqual([0x3f, 0x80, 0, 0, 0xc0, 0, 0, 0],
+                 toArray(out, 0, 8));
+
+assert.throws(function() {
+  out.writeArray(20, floats);
+});
+assert.throws(function() {
+  out.slice(8).writeArray(-8, floats);
+});
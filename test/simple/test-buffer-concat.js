@@ -0,0 +1,73 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+var path = require('path');
+var BufferList = require('buffer').BufferList;
+
+var zero = [];
+var one = [new Buffer('asdf')];
+var long = [];
+for (var i = 0; i < 10; i++) long.push(new Buffer('asdf'));
+
+assert.equal(Buffer.concat(zero).length, 0);
+assert.equal(Buffer.concat(one), one[0]);
+assert.equal(Buffer.concat(long).toString(), new Array(11).join('asdf'));
+assert.equal(Buffer.concat(long, 40).length, 40);
+assert.equal(Buffer.concat(long, 6).toString(), 'asdfas');
+
+assert.throws(function() {
+  Buffer.concat('asdf');
+});
+
+// BufferList keeps chunks apart until asked
+var list = new BufferList();
+list.push(new Buffer('hello '));
+list.push('world', 'utf8');
+assert.equal(list.length, 11);
+assert.equal(list.buffers.length, 2);
+assert.equal(list.toString(), 'hello world');
+assert.equal(list.toBuffer().length, 11);
+
+// fs.writeFileSync writes the chunks back to back
+var file = path.join(common.tmpDir, 'buffer-list.txt');
+fs.writeFileSync(file, list);
+assert.equal(fs.readFileSync(file, 'utf8'), 'hello world');
+
+// hash.update() consumes the list without joining it
+var crypto = null;
+try {
+  process.binding('crypto');
+  crypto = require('crypto');
+} catch (e) {
+  console.log('Not compiled with OpenSSL support, skipping hash check.');
+}
+
+if (crypto) {
+  assert.equal(crypto.createHash('sha1').update(list).digest('hex'),
+               crypto.createHash('sha1').update('hello world').digest('hex'));
+}
+
+list.clear();
+assert.equal(list.length, 0);
@@ -689,3 +689,69 @@ buf.write('123456', 'base64');
 assert.equal(Buffer._charsWritten, 6);
 buf.write('00010203040506070809', 'hex');
 assert.equal(Buffer._charsWritten, 18);
+
+// hex and base64 round trips across the vectorized block boundaries
+function assertSameBytes(a, b) {
+  assert.equal(a.length, b.length);
+  for (var i = 0; i < a.length; i++) assert.equal(a[i], b[i]);
+}
+
+for (var n = 0; n < 70; n++) {
+  var src = new Buffer(n);
+  for (var i = 0; i < n; i++) src[i] = (i * 37 + n) & 0xff;
+
+  var hex = src.toString('hex');
+  assert.equal(hex.length, n * 2);
+  assertSameBytes(new Buffer(hex, 'hex'), src);
+  assertSameBytes(new Buffer(hex.toUpperCase(), 'hex'), src);
+
+  var b64 = src.toString('base64');
+  assertSameBytes(new Buffer(b64, 'base64'), src);
+}
+
+assert.throws(function() {
+  new Buffer('0g', 'hex');
+});
+
+// Bad hex throws a plain Error, as the JavaScript decoder did.
+['0g', 'abc'].forEach(function(hex) {
+  assert.throws(function() {
+    new Buffer(hex, 'hex');
+  }, function(e) {
+    return e.constructor === Error && /Invalid hex string/.test(e.message);
+  });
+});
+
+// base64 with whitespace and padding past the first vectorized blocks
+var long = new Buffer(300);
+for (var i = 0; i < long.length; i++) long[i] = (i * 7) & 0xff;
+var b64 = long.toString('base64');
+var wrapped = b64.replace(/.{76}/g, '$&\r\n');
+assertSameBytes(new Buffer(wrapped, 'base64'), long);
+assertSameBytes(new Buffer(b64.slice(0, 40) + ' ' + b64.slice(40), 'base64'),
+                long);
+
+// utf8 writes: ASCII strings take the fast path, anything wider falls back
+// to the full encoder without disturbing bytes past what it wrote.
+var ascii = new Array(3001).join('x');
+buf = new Buffer(4000);
+buf.fill(0xff);
+assert.equal(buf.write(ascii, 0, 'utf8'), 3000);
+assert.equal(Buffer._charsWritten, 3000);
+assert.equal(buf[2999], 0x78);
+assert.equal(buf[3000], 0xff);
+
+buf.fill(0xff);
+assert.equal(buf.write(ascii + 'é', 0, 'utf8'), 3002);
+assert.equal(Buffer._charsWritten, 3001);
+assert.equal(buf.toString('utf8', 0, 3002), ascii + 'é');
+
+buf.fill(0xff);
+assert.equal(buf.write('ab€cd', 0, 3, 'utf8'), 2);
+assert.equal(Buffer._charsWritten, 2);
+assert.equal(buf[2], 0xff);
+
+buf = new Buffer(10);
+assert.equal(buf.write('abcdefghijklmnop', 0, 'utf8'), 10);
+assert.equal(Buffer._charsWritten, 10);
+assert.equal(buf.toString(), 'abcdefghij');
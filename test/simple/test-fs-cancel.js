@@ -0,0 +1,87 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+
+// A cancelled request calls back with ECANCELED; one that a thread already
+// took up completes as usual. Which of the two happens to a given request is
+// up to the pool, so check that the outcome matches what cancel() returned.
+// With one thread and the newest requests cancelled first, plenty of them are
+// still queued.
+process.setThreadPoolSize('io', 1);
+
+var N = 200;
+var cancelled = 0;
+var completed = 0;
+var reqs = [];
+
+function check(i, err, files) {
+  if (reqs[i].wasCancelled) {
+    assert.ok(err);
+    assert.equal(err.code, 'ECANCELED');
+    assert.equal(files, undefined);
+    cancelled++;
+  } else {
+    assert.ifError(err);
+    assert.ok(Array.isArray(files));
+    completed++;
+  }
+
+  // Too late now.
+  assert.equal(reqs[i].cancel(), false);
+}
+
+for (var i = 0; i < N; i++) {
+  reqs.push(fs.readdir(common.fixturesDir, check.bind(null, i)));
+}
+
+for (var i = N - 1; i >= 0; i--) {
+  assert.equal(typeof reqs[i].cancel, 'function');
+  reqs[i].wasCancelled = reqs[i].cancel();
+  // A second cancel never succeeds.
+  assert.equal(reqs[i].cancel(), false);
+}
+
+var batchCancelled;
+var batchDone = false;
+var fd = fs.openSync(__filename, 'r');
+var buf = new Buffer(16);
+var batch = fs.readv(fd, [buf], 0, function(err, bytesRead) {
+  if (batchCancelled) {
+    assert.equal(err.code, 'ECANCELED');
+  } else {
+    assert.ifError(err);
+    assert.equal(bytesRead, 16);
+  }
+  fs.closeSync(fd);
+  batchDone = true;
+});
+batchCancelled = batch.cancel();
+
+process.on('exit', function() {
+  assert.equal(cancelled + completed, N);
+  assert.ok(cancelled > 0);
+  assert.ok(batchDone);
+  console.log('cancelled %d of %d', cancelled, N);
+});
@@ -0,0 +1,118 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+var common = require('../common');
+var assert = require('assert');
+var path = require('path');
+var fs = require('fs');
+var constants = process.binding('constants');
+
+if (!fs.mmap) {
+  console.error('Skipping: fs.mmap not available on this platform.');
+  process.exit(0);
+}
+
+var file = path.join(common.tmpDir, 'mmap.txt');
+var data = new Buffer(10000);
+for (var i = 0; i < data.length; i++) data[i] = i % 251;
+fs.writeFileSync(file, data);
+
+var fd = fs.openSync(file, 'r+');
+
+// Whole file, read only and shared by default.
+var whole = fs.mmap(fd, 0, data.length);
+assert.ok(Buffer.isBuffer(whole));
+assert.equal(whole.length, data.length);
+for (var i = 0; i < data.length; i++) assert.equal(whole[i], data[i]);
+
+// Offsets need not be page aligned.
+var part = fs.mmap(fd, 4099, 100, constants.PROT_READ,
+                   constants.MAP_SHARED | (constants.MAP_POPULATE || 0));
+assert.equal(part.length, 100);
+assert.equal(part.toString('hex'), data.slice(4099, 4199).toString('hex'));
+
+fs.madvise(whole, constants.MADV_RANDOM);
+fs.madvise(whole.slice(5000, 6000), constants.MADV_WILLNEED);
+
+// Writes to a private mapping don't reach the file.
+var priv = fs.mmap(fd, 0, 16, constants.PROT_READ | constants.PROT_WRITE,
+                   constants.MAP_PRIVATE);
+priv[0] = 255;
+assert.equal(priv[0], 255);
+assert.equal(whole[0], data[0]);
+
+// Writes to a shared one do, and show up in the other mappings.
+var shared = fs.mmap(fd, 0, 16, constants.PROT_READ | constants.PROT_WRITE,
+                     constants.MAP_SHARED);
+shared[1] = 254;
+assert.equal(whole[1], 254);
+var check = new Buffer(1);
+fs.readSync(fd, check, 0, 1, 1);
+assert.equal(check[0], 254);
+
+fs.closeSync(fd);
+
+// The mapping outlives the descriptor.
+assert.equal(whole[9999], data[9999]);
+
+var partSlice = part.slice(0, 10);
+var wholeSlice = whole.slice(4096, 8192);
+
+assert.equal(fs.munmap(part), true);
+assert.equal(fs.munmap(part), false);
+assert.equal(part.parent.length, 0);
+
+// Slices taken before munmap() read zeros from then on.
+assert.equal(partSlice.length, 10);
+for (var i = 0; i < partSlice.length; i++) assert.equal(partSlice[i], 0);
+
+assert.equal(fs.munmap(whole), true);
+assert.equal(wholeSlice[0], 0);
+assert.equal(wholeSlice[4095], 0);
+
+// Reading an unmapped buffer finds nothing rather than faulting.
+assert.equal(part.length, 0);
+assert.equal(part[0], undefined);
+assert.equal(part[99], undefined);
+assert.equal(part.toString(), '');
+assert.throws(function() {
+  part.readUInt8(0);
+});
+assert.equal(fs.munmap(new Buffer(10)), false);
+
+assert.throws(function() {
+  fs.madvise(new Buffer(10), constants.MADV_RANDOM);
+}, /not memory mapped/);
+
+assert.throws(function() {
+  fs.mmap(fd, 0, 10);
+}, /EBADF/);
+
+assert.throws(function() {
+  fs.mmap(fd, 0, 0);
+}, RangeError);
+assert.throws(function() {
+  fs.mmap(fd, 0, 1e20);
+}, /Length is too large/);
+assert.throws(function() {
+  fs.mmap(fd, 0, '10');
+}, TypeError);
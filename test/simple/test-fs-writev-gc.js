@@ -0,0 +1,70 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Flags: --expose-gc
+
+// The buffers of an async writev belong to the request: emptying the array
+// that was passed in and collecting garbage doesn't free them under the
+// thread that writes them out.
+var common = require('../common');
+var assert = require('assert');
+var path = require('path');
+var fs = require('fs');
+
+var filename = path.join(common.tmpDir, 'writev-gc.txt');
+var N = 256;
+var SIZE = 64 * 1024;
+var done = false;
+
+var fd = fs.openSync(filename, 'w+');
+var list = [];
+for (var i = 0; i < N; i++) {
+  var b = new Buffer(SIZE);
+  b.fill(97 + i % 26);
+  list.push(b);
+}
+b = null;
+
+fs.writev(fd, list, 0, function(err, written) {
+  if (err) throw err;
+  assert.equal(N * SIZE, written);
+
+  var data = fs.readFileSync(filename);
+  assert.equal(N * SIZE, data.length);
+  for (var i = 0; i < data.length; i++) {
+    var expected = 97 + Math.floor(i / SIZE) % 26;
+    if (data[i] !== expected) assert.fail(data[i], expected, 'corrupt at ' + i);
+  }
+
+  fs.closeSync(fd);
+  fs.unlinkSync(filename);
+  done = true;
+});
+
+list.length = 0;
+gc();
+
+// Reuse whatever was freed.
+for (var i = 0; i < N; i++) new Buffer(SIZE).fill(122);
+
+process.on('exit', function() {
+  assert.ok(done);
+});
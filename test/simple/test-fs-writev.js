@@ -0,0 +1,106 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var path = require('path');
+var fs = require('fs');
+var BufferList = require('buffer').BufferList;
+
+var filename = path.join(common.tmpDir, 'writev.txt');
+var writevCalled = 0;
+var readvCalled = 0;
+var preadManyCalled = 0;
+
+// sync
+var fd = fs.openSync(filename, 'w+');
+var chunks = [new Buffer('hello'), new Buffer(0), new Buffer(' world')];
+assert.equal(11, fs.writevSync(fd, chunks, 0));
+assert.equal('hello world', fs.readFileSync(filename, 'utf8'));
+
+var a = new Buffer(6), b = new Buffer(10);
+assert.equal(11, fs.readvSync(fd, [a, b], 0));
+assert.equal('hello ', a.toString());
+assert.equal('world', b.toString('utf8', 0, 5));
+
+var x = new Buffer(5), y = new Buffer(8);
+var results = fs.preadManySync(fd, [[x, 0, 5, 6], [y, 2, 5, 0], [y, 0, 2, 9]]);
+assert.deepEqual([5, 5, 2], results);
+assert.equal('world', x.toString());
+assert.equal('ldhello', y.toString('utf8', 0, 7));
+fs.closeSync(fd);
+
+// a BufferList goes out in one call too
+var list = new BufferList();
+list.push('one ');
+list.push(new Buffer('two '));
+list.push('three');
+fs.writeFileSync(filename, list);
+assert.equal('one two three', fs.readFileSync(filename, 'utf8'));
+
+// more buffers than fit in the stack iovec array
+var many = [];
+for (var i = 0; i < 100; i++) many.push(new Buffer(String(i % 10)));
+fd = fs.openSync(filename, 'w+');
+assert.equal(100, fs.writevSync(fd, many, null));
+fs.closeSync(fd);
+assert.equal(many.join(''), fs.readFileSync(filename, 'utf8'));
+
+assert.throws(function() {
+  fs.preadManySync(0, [[new Buffer(2), 0, 4, 0]]);
+});
+
+// async
+fs.open(filename, 'w+', 0644, function(err, fd) {
+  if (err) throw err;
+
+  fs.writev(fd, [new Buffer('abc'), new Buffer('def')], 0,
+            function(err, written) {
+    writevCalled++;
+    if (err) throw err;
+    assert.equal(6, written);
+
+    var p = new Buffer(2), q = new Buffer(10);
+    fs.readv(fd, [p, q], 0, function(err, bytesRead) {
+      readvCalled++;
+      if (err) throw err;
+      assert.equal(6, bytesRead);
+      assert.equal('ab', p.toString());
+      assert.equal('cdef', q.toString('utf8', 0, 4));
+
+      var r = new Buffer(3);
+      fs.preadMany(fd, [[r, 0, 1, 5], [r, 1, 2, 0]], function(err, results) {
+        preadManyCalled++;
+        if (err) throw err;
+        assert.deepEqual([1, 2], results);
+        assert.equal('fab', r.toString());
+        fs.closeSync(fd);
+        fs.unlinkSync(filename);
+      });
+    });
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(1, writevCalled);
+  assert.equal(1, readvCalled);
+  assert.equal(1, preadManyCalled);
+});
@@ -0,0 +1,77 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+// A response written while a slab of pipelined requests is being parsed
+// still sees the socket's backpressure: res.write() of a large body returns
+// false and 'drain' follows. Nothing batched behind it gets lost.
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+var http = require('http');
+
+var SIZE = 16 * 1024 * 1024;
+var requests = 0;
+var writeRet;
+var drained = false;
+var received = 0;
+var tail = '';
+
+var server = http.createServer(function(req, res) {
+  var n = requests++;
+
+  if (n == 0) {
+    res.writeHead(200, { 'Content-Length': SIZE });
+    writeRet = res.write(new Buffer(SIZE));
+    res.on('drain', function() {
+      drained = true;
+      res.end();
+    });
+  } else {
+    res.writeHead(200, { 'Content-Length': 2 });
+    res.end('ok');
+  }
+});
+
+server.listen(common.PORT, function() {
+  var c = net.createConnection(common.PORT);
+
+  c.on('connect', function() {
+    c.write('GET /0 HTTP/1.1\r\n\r\n' +
+            'GET /1 HTTP/1.1\r\nConnection: close\r\n\r\n');
+  });
+
+  c.on('data', function(chunk) {
+    received += chunk.length;
+    tail = (tail + chunk.toString('binary')).slice(-64);
+  });
+
+  c.on('end', function() {
+    c.end();
+    server.close();
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(2, requests);
+  assert.strictEqual(false, writeRet);
+  assert.ok(drained);
+  assert.ok(received > SIZE);
+  assert.ok(/\r\n\r\nok$/.test(tail));
+});
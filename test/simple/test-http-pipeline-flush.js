@@ -0,0 +1,83 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+// Several pipelined requests arrive in one packet. The responses, some of
+// them completed synchronously and one of them late, must come back intact
+// and in request order, and the connection must close after the last one.
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+var http = require('http');
+
+var total = 5;
+var requests = 0;
+var received = '';
+
+var server = http.createServer(function(req, res) {
+  var n = requests++;
+  assert.equal('/' + n, req.url);
+
+  function respond() {
+    var body = 'response ' + n + '\n';
+    res.writeHead(200, { 'Content-Length': body.length });
+    res.end(body);
+  }
+
+  // Finish the second request out of order.
+  if (n == 1) {
+    setTimeout(respond, 10);
+  } else {
+    respond();
+  }
+});
+
+server.listen(common.PORT, function() {
+  var c = net.createConnection(common.PORT);
+  c.setEncoding('utf8');
+
+  c.on('connect', function() {
+    var data = '';
+    for (var i = 0; i < total; i++) {
+      data += 'GET /' + i + ' HTTP/1.1\r\n';
+      if (i == total - 1) data += 'Connection: close\r\n';
+      data += '\r\n';
+    }
+    c.write(data);
+  });
+
+  c.on('data', function(chunk) {
+    received += chunk;
+  });
+
+  c.on('end', function() {
+    c.end();
+    server.close();
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(total, requests);
+
+  var bodies = received.match(/response \d+/g);
+  assert.deepEqual(['response 0', 'response 1', 'response 2',
+                    'response 3', 'response 4'], bodies);
+});
@@ -0,0 +1,62 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// A write issued before the socket connects returns false. When the
+// connect queue is replayed without needing a write request, 'drain'
+// must still be emitted, as it must after any other write that
+// returned false.
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+
+var drains = 0;
+var received = '';
+
+var server = net.createServer(function(s) {
+  s.setEncoding('utf8');
+  s.on('data', function(d) {
+    received += d;
+  });
+  s.on('end', function() {
+    s.end();
+    server.close();
+  });
+});
+
+server.listen(common.PORT, function() {
+  var client = net.createConnection(common.PORT);
+
+  assert.equal(false, client.write('hello '));
+  assert.equal(false, client.write('world'));
+
+  client.on('drain', function() {
+    drains++;
+    assert.ok(client.writable);
+    assert.ok(client.write('!'));
+    client.end();
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(1, drains);
+  assert.equal('hello world!', received);
+});
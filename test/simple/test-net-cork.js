@@ -0,0 +1,75 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Only the libuv backed net module can cork.
+if (!process.features.uv) return;
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+
+var received = '';
+var writesCompleted = 0;
+
+var server = net.createServer(function(socket) {
+  socket.setEncoding('utf8');
+  socket.on('data', function(d) {
+    received += d;
+  });
+  socket.on('end', function() {
+    socket.end();
+    server.close();
+  });
+});
+
+server.listen(common.PORT, function() {
+  var client = net.createConnection(common.PORT);
+
+  client.on('connect', function() {
+    client.setNoDelay();
+    client.cork();
+
+    for (var i = 0; i < 100; i++) {
+      client.write(String(i % 10), function() {
+        writesCompleted++;
+      });
+    }
+
+    client.uncork();
+
+    if (process.platform != 'win32') {
+      // Everything went out in the uncork() call.
+      assert.equal(0, client._handle.writeQueueSize);
+    }
+
+    // Corked again; end() has to flush this.
+    client.cork();
+    client.write('end');
+    client.end();
+  });
+});
+
+process.on('exit', function() {
+  var expected = '';
+  for (var i = 0; i < 100; i++) expected += String(i % 10);
+  assert.equal(expected + 'end', received);
+  assert.equal(100, writesCompleted);
+});
@@ -0,0 +1,76 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Only the libuv backed net module splices.
+if (!process.features.uv) return;
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+
+// When the socket being spliced into is destroyed, the source is read from
+// JavaScript again instead of being left stopped.
+var spliced = false;
+var received = '';
+var ended = false;
+
+var sink = net.createServer(function(socket) {
+  socket.on('data', function() {});
+  socket.on('end', function() {
+    sink.close();
+  });
+});
+
+var proxy = net.createServer(function(socket) {
+  var upstream = net.createConnection(common.PORT + 1, function() {
+    socket.pipe(upstream);
+    spliced = !!socket._splicing;
+    upstream.destroy();
+
+    socket.setEncoding('utf8');
+    socket.on('data', function(d) {
+      received += d;
+    });
+    socket.on('end', function() {
+      ended = true;
+      proxy.close();
+    });
+
+    // Only send once the splice has been torn down.
+    socket.write('go');
+  });
+});
+
+sink.listen(common.PORT + 1, function() {
+  proxy.listen(common.PORT, function() {
+    var client = net.createConnection(common.PORT);
+    client.on('data', function(d) {
+      assert.equal('go', d.toString());
+      client.end('hello');
+    });
+  });
+});
+
+process.on('exit', function() {
+  assert.equal('hello', received);
+  assert.ok(ended);
+  if (process.platform != 'win32') assert.ok(spliced);
+});
@@ -0,0 +1,85 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+// A socket with an idle timeout must not be spliced: the data would never
+// pass through JS and the timer would fire while the transfer is going on.
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+
+var CHUNKS = 10;
+var chunk = new Buffer(16 * 1024);
+chunk.fill(120);
+
+var received = 0;
+var spliced = null;
+var timedOut = false;
+var bytesRead = 0;
+
+var sink = net.createServer(function(socket) {
+  socket.on('data', function(d) {
+    received += d.length;
+  });
+  socket.on('end', function() {
+    socket.end();
+    sink.close();
+    proxy.close();
+  });
+});
+
+var proxy = net.createServer(function(socket) {
+  // Shorter than the whole transfer, longer than the gaps in it.
+  socket.setTimeout(200, function() {
+    timedOut = true;
+    socket.destroy();
+  });
+
+  var upstream = net.createConnection(common.PORT + 1, function() {
+    socket.pipe(upstream);
+    spliced = !!socket._splicing;
+  });
+
+  socket.on('end', function() {
+    bytesRead = socket.bytesRead;
+  });
+});
+
+sink.listen(common.PORT + 1, function() {
+  proxy.listen(common.PORT, function() {
+    var client = net.createConnection(common.PORT, function() {
+      var sent = 0;
+      var timer = setInterval(function() {
+        client.write(chunk);
+        if (++sent == CHUNKS) {
+          clearInterval(timer);
+          client.end();
+        }
+      }, 50);
+    });
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(false, spliced);
+  assert.ok(!timedOut);
+  assert.equal(CHUNKS * chunk.length, received);
+  assert.equal(CHUNKS * chunk.length, bytesRead);
+});
@@ -0,0 +1,91 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Only the libuv backed net module splices.
+if (!process.features.uv) return;
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+
+// write() and end() on a socket that is being spliced into are held back
+// until the splice is done, then go out after the spliced data.
+var N = 256 * 1024;
+var received = [];
+var queuedWrite = false;
+var spliced = false;
+var drained = false;
+var writeCb = false;
+
+var sink = net.createServer(function(socket) {
+  socket.on('data', function(d) {
+    received.push(d);
+  });
+  socket.on('end', function() {
+    socket.end();
+    sink.close();
+    proxy.close();
+  });
+});
+
+var proxy = net.createServer(function(socket) {
+  var upstream = net.createConnection(common.PORT + 1, function() {
+    socket.pipe(upstream, { end: false });
+    spliced = !!socket._splicing;
+
+    queuedWrite = upstream.write('head', function() {
+      writeCb = true;
+    }) === false;
+    upstream.on('drain', function() {
+      drained = true;
+    });
+
+    socket.on('end', function() {
+      upstream.write('tail');
+      upstream.end();
+    });
+  });
+});
+
+sink.listen(common.PORT + 1, function() {
+  proxy.listen(common.PORT, function() {
+    var client = net.createConnection(common.PORT, function() {
+      var b = new Buffer(N);
+      b.fill(120);
+      client.end(b);
+    });
+  });
+});
+
+process.on('exit', function() {
+  var data = Buffer.concat(received);
+  assert.equal(N + 8, data.length);
+  assert.equal('headtail', data.slice(N).toString());
+  for (var i = 0; i < N; i++) {
+    if (data[i] !== 120) assert.fail(data[i], 120, 'spliced data corrupted');
+  }
+  assert.ok(writeCb);
+  if (process.platform != 'win32') {
+    assert.ok(spliced);
+    assert.ok(queuedWrite);
+    assert.ok(drained);
+  }
+});
@@ -0,0 +1,91 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Only the libuv backed net module splices.
+if (!process.features.uv) return;
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+
+// client -> proxy -> sink, where the proxy pipes one socket into the other.
+var N = 4 * 1024 * 1024;
+var chunk = new Buffer(64 * 1024);
+for (var i = 0; i < chunk.length; i++) chunk[i] = i % 251;
+
+var received = 0;
+var corrupt = false;
+var spliced = false;
+var piped = false;
+var proxyEnded = false;
+
+var sink = net.createServer(function(socket) {
+  socket.on('data', function(d) {
+    for (var i = 0; i < d.length; i++) {
+      if (d[i] != (received + i) % chunk.length % 251) corrupt = true;
+    }
+    received += d.length;
+  });
+  socket.on('end', function() {
+    socket.end();
+    sink.close();
+    proxy.close();
+  });
+});
+
+var proxy = net.createServer(function(socket) {
+  socket.pause();
+
+  var upstream = net.createConnection(common.PORT + 1, function() {
+    upstream.on('pipe', function(src) {
+      assert.equal(socket, src);
+      piped = true;
+    });
+
+    socket.pipe(upstream);
+    spliced = !!socket._splicing;
+    socket.resume();
+  });
+
+  socket.on('end', function() {
+    proxyEnded = true;
+    assert.equal(N, socket.bytesRead);
+  });
+});
+
+sink.listen(common.PORT + 1, function() {
+  proxy.listen(common.PORT, function() {
+    var client = net.createConnection(common.PORT, function() {
+      for (var sent = 0; sent < N; sent += chunk.length) {
+        client.write(chunk);
+      }
+      client.end();
+    });
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(N, received);
+  assert.ok(!corrupt);
+  assert.ok(piped);
+  assert.ok(proxyEnded);
+  if (process.platform != 'win32') assert.ok(spliced);
+});
@@ -0,0 +1,68 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Only the libuv backed net module takes a BufferList.
+if (!process.features.uv) return;
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+var BufferList = require('buffer').BufferList;
+
+// socket.write(list) sends the list's chunks in order, as one write.
+var received = '';
+var callbacks = 0;
+
+var server = net.createServer(function(socket) {
+  socket.setEncoding('utf8');
+  socket.on('data', function(d) {
+    received += d;
+  });
+  socket.on('end', function() {
+    socket.end();
+    server.close();
+  });
+});
+
+server.listen(common.PORT, function() {
+  var client = net.createConnection(common.PORT, function() {
+    var list = new BufferList();
+    list.push(new Buffer('hello'));
+    list.push(new Buffer(' '));
+    list.push(new Buffer('world'));
+
+    client.write(list, function() {
+      callbacks++;
+    });
+    assert.equal(11, client.bytesWritten);
+
+    // An empty list is fine too.
+    client.write(new BufferList(), function() {
+      callbacks++;
+    });
+    client.end();
+  });
+});
+
+process.on('exit', function() {
+  assert.equal('hello world', received);
+  assert.equal(2, callbacks);
+});
@@ -0,0 +1,78 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Writes to an idle socket go out without a write request, but their
+// callbacks must still be called, asynchronously and in order.
+if (!process.features.uv) return;
+
+var common = require('../common');
+var assert = require('assert');
+var net = require('net');
+
+var received = '';
+var callbacks = [];
+
+var server = net.createServer(function(socket) {
+  socket.setEncoding('utf8');
+  socket.on('data', function(d) {
+    received += d;
+  });
+  socket.on('end', function() {
+    socket.end();
+    server.close();
+  });
+});
+
+server.listen(common.PORT, function() {
+  var client = net.createConnection(common.PORT);
+
+  client.on('connect', function() {
+    // Ranges outside the buffer are rejected before anything is sent.
+    assert.throws(function() {
+      client._handle.tryWrite(new Buffer(4), 5, 0);
+    }, /Offset is out of bounds/);
+    assert.throws(function() {
+      client._handle.tryWrite(new Buffer(4), 2, 3);
+    }, /Length extends beyond buffer/);
+    assert.throws(function() {
+      client._handle.tryWrite(new Buffer(4), -1, 1);
+    }, /Offset is out of bounds/);
+
+    var sync = true;
+
+    for (var i = 0; i < 3; i++) {
+      (function(i) {
+        client.write('chunk' + i, function() {
+          assert.ok(!sync);
+          callbacks.push(i);
+          if (callbacks.length == 3) client.end();
+        });
+      })(i);
+    }
+
+    sync = false;
+  });
+});
+
+process.on('exit', function() {
+  assert.equal('chunk0chunk1chunk2', received);
+  assert.deepEqual([0, 1, 2], callbacks);
+});
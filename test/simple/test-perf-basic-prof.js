@@ -0,0 +1,62 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// --perf-basic-prof makes V8 append a "start size name" line to
+// /tmp/perf-<pid>.map for every piece of code it generates.
+
+var common = require('../common');
+var assert = require('assert');
+var spawn = require('child_process').spawn;
+var fs = require('fs');
+
+if (process.platform === 'win32') {
+  console.error('Skipping: perf maps are not written on windows');
+  process.exit(0);
+}
+
+var script = 'function perfBasicProfMarker() { return 42; }' +
+             'for (var i = 0; i < 1e5; i++) perfBasicProfMarker();';
+
+var child = spawn(process.execPath, ['--perf-basic-prof', '-e', script]);
+var file = '/tmp/perf-' + child.pid + '.map';
+var exitCode = -1;
+
+child.on('exit', function(code) {
+  exitCode = code;
+  var lines = fs.readFileSync(file, 'utf8').split('\n');
+  fs.unlinkSync(file);
+
+  assert.equal(lines.pop(), '');
+  assert.ok(lines.length > 0);
+
+  var marker = false;
+  lines.forEach(function(line) {
+    var m = /^([0-9a-f]+) ([0-9a-f]+) (.+)$/.exec(line);
+    assert.ok(m, 'malformed perf map line: ' + line);
+    assert.ok(parseInt(m[2], 16) > 0);
+    if (m[3] === 'Function:perfBasicProfMarker') marker = true;
+  });
+  assert.ok(marker);
+});
+
+process.on('exit', function() {
+  assert.equal(0, exitCode);
+});
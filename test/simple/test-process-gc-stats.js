@@ -0,0 +1,43 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+
+var stats = process.gcStats(true);
+assert.equal('number', typeof stats.count);
+
+stats = process.gcStats();
+assert.equal(0, stats.count);
+assert.equal(0, stats.pauseMax);
+
+// Allocate enough garbage for the young generation to be collected a few
+// times.
+var junk;
+for (var i = 0; i < 1e5; i++) {
+  junk = { i: i, s: 'x' + i, a: [i, i, i] };
+}
+
+stats = process.gcStats();
+assert.ok(stats.count > 0);
+assert.equal(stats.count, stats.scavenges + stats.markSweeps);
+assert.ok(stats.pauseTime >= stats.pauseMax);
+assert.ok(stats.pauseMax > 0);
@@ -0,0 +1,66 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+
+var stats = process.loopStats(true);
+assert.equal(0, stats.iterations);
+assert.equal(0, stats.lag.max);
+assert.equal(12, stats.lag.histogram.length);
+
+var monitorEvents = 0;
+
+process.on('loopStats', function(s) {
+  monitorEvents++;
+  assert.equal('number', typeof s.iterations);
+  assert.ok(Array.isArray(s.lag.histogram));
+});
+
+setTimeout(function() {
+  // Keep the loop busy for a while so it shows up as lag.
+  var start = Date.now();
+  while (Date.now() - start < 40);
+
+  setTimeout(function() {
+    stats = process.loopStats();
+
+    process.monitorLoop(10);
+    setTimeout(function() {
+      process.monitorLoop(0);
+    }, 100);
+  }, 10);
+}, 10);
+
+process.on('exit', function() {
+  assert.ok(monitorEvents > 0);
+  assert.ok(stats.iterations > 0);
+  // Spun for 40 ms; leave room for clock granularity.
+  assert.ok(stats.lag.max >= 30);
+
+  var total = stats.lag.histogram.reduce(function(a, b) { return a + b; });
+  assert.equal(stats.iterations, total);
+
+  if (process.features.uv) {
+    assert.ok(stats.callbacks.ontimeout.count > 0);
+    assert.ok(stats.callbackTime >= 30);
+  }
+});
@@ -0,0 +1,108 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+var path = require('path');
+
+var file = path.join(common.tmpDir, 'test-process-profiler.profile');
+var written = false;
+var cycles = 0;
+
+// Where the native sampler exists; see src/node_profiler.cc.
+var nativeSampler = process.platform == 'linux' &&
+                    (process.arch == 'x64' || process.arch == 'ia32');
+
+try { fs.unlinkSync(file); } catch (e) {}
+
+assert.throws(function() {
+  process.stopProfiling();
+});
+
+assert.equal(true, process.startProfiling());
+assert.equal(false, process.startProfiling());
+
+function busy() {
+  var start = Date.now();
+  var n = 0;
+  while (Date.now() - start < 200) n++;
+  return n;
+}
+
+// Spends its time in node::Encode and V8's string allocation, in C++.
+var big = new Buffer(1024 * 1024);
+big.fill(42);
+
+function encode() {
+  var start = Date.now();
+  while (Date.now() - start < 200) big.toString('binary');
+}
+
+busy();
+encode();
+
+var ret = process.stopProfiling(file, function(err, p) {
+  if (err) throw err;
+  assert.equal(file, p);
+
+  var lines = fs.readFileSync(file, 'utf8').split('\n');
+  assert.ok(/^# node cpu profile, pid \d+/.test(lines[0]));
+
+  var found = lines.some(function(line) {
+    return / busy /.test(line);
+  });
+  assert.ok(found);
+
+  if (nativeSampler) {
+    var native = lines.indexOf('# samples symbol');
+    assert.ok(native > 0);
+    found = lines.slice(native + 1).some(function(line) {
+      return /^\d+ node::/.test(line);
+    });
+    assert.ok(found);
+  }
+
+  written = true;
+  cycle();
+});
+
+assert.equal(file, ret);
+
+// Starting and stopping again must keep working.
+function cycle() {
+  if (++cycles > 5) return;
+
+  assert.equal(true, process.startProfiling());
+  encode();
+  process.stopProfiling(file, function(err) {
+    if (err) throw err;
+    if (nativeSampler) {
+      assert.ok(/\n\d+ (node|v8)::/.test(fs.readFileSync(file, 'utf8')));
+    }
+    cycle();
+  });
+}
+
+process.on('exit', function() {
+  assert.ok(written);
+  assert.equal(6, cycles);
+});
@@ -0,0 +1,80 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var path = require('path');
+var spawn = require('child_process').spawn;
+var sub = path.join(common.fixturesDir, 'async-stdio.js');
+
+var results = {};
+
+function run(overflow, lines) {
+  var child = spawn(process.execPath, [sub, overflow, lines]);
+  var out = '';
+  var err = '';
+
+  child.stdout.setEncoding('utf8');
+  child.stdout.on('data', function(d) { out += d; });
+  child.stderr.setEncoding('utf8');
+  child.stderr.on('data', function(d) { err += d; });
+
+  child.on('exit', function(code) {
+    assert.equal(0, code);
+    results[overflow] = { stdout: out, stderr: err };
+  });
+}
+
+// Far more than the 4k ring holds; everything has to arrive in order.
+run('block', 20000);
+run('drop', 10);
+run('count', 10);
+
+// A reader that stops reading must not keep the writer from exiting.
+var stalled = spawn(process.execPath, [sub, 'block', 256, 'stall']);
+stalled.stdout.pause();
+// 'exit' waits for stdout to close, which a paused stream never sees;
+// stderr closing means the child is gone.
+stalled.stderr.on('close', function() {
+  stalled.stdout.destroy();
+});
+stalled.on('exit', function(code) {
+  assert.equal(0, code);
+  results.stall = true;
+});
+
+process.on('exit', function() {
+  assert.ok(results.stall);
+
+  var expected = '';
+  for (var i = 0; i < 20000; i++) {
+    expected += 'line ' + i + '\n';
+  }
+  assert.equal(expected, results.block.stdout);
+  assert.ok(/^stderr \d+\n$/.test(results.block.stderr));
+
+  expected = '';
+  for (var i = 0; i < 10; i++) {
+    expected += 'line ' + i + '\n';
+  }
+  assert.equal(expected, results.drop.stdout);
+  assert.equal('(1 writes dropped)\n' + expected, results.count.stdout);
+});
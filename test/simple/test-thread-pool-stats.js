@@ -0,0 +1,48 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+
+if (process.platform === 'win32') {
+  console.error('Skipping: thread pools are not configurable on windows');
+  process.exit(0);
+}
+
+var stats = process.threadPoolStats();
+
+['threads', 'queued', 'active', 'completed', 'steals'].forEach(function(k) {
+  assert.equal('number', typeof stats.work[k], k);
+});
+['threads', 'queued', 'active'].forEach(function(k) {
+  assert.equal('number', typeof stats.io[k], k);
+});
+
+assert.throws(function() {
+  process.setThreadPoolSize('cpu', 2);
+}, TypeError);
+
+assert.equal(false, process.setThreadPoolSize('work', 0));
+assert.equal(true, process.setThreadPoolSize('io', 2));
+
+// Nothing has been queued on the work pool yet, so any size goes.
+assert.equal(true, process.setThreadPoolSize('work', 3));
+assert.equal(3, process.threadPoolStats().work.threads);
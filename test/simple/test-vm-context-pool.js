@@ -0,0 +1,110 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var vm = require('vm');
+
+common.globalCheck = false;
+
+vm.setContextPoolSize(2);
+
+common.debug('pass values in and out');
+var sandbox = { foo: 0, baz: 3 };
+vm.runInNewContext('foo = 1; bar = 2; if (baz !== 3) throw new Error();',
+                   sandbox);
+assert.equal(1, sandbox.foo);
+assert.equal(2, sandbox.bar);
+
+common.debug('declarations end up on the sandbox');
+sandbox = {};
+vm.runInNewContext('var a = 1; function b() { return a; }', sandbox);
+assert.equal(1, sandbox.a);
+assert.equal(1, sandbox.b());
+
+common.debug('functions keep seeing their own sandbox');
+var first = { secret: 'A' };
+vm.runInNewContext('function get() { return secret; }', first);
+vm.runInNewContext('var x = 1;', { secret: 'B' });
+assert.equal('A', first.get());
+first = { secret: 'A' };
+vm.runInNewContext('get = function() { return secret; }', first);
+vm.runInNewContext('var x = 1;', { secret: 'B' });
+assert.equal('A', first.get());
+first = { secret: 'A' };
+vm.runInNewContext('o = { get s() { return secret; } }', first);
+vm.runInNewContext('var x = 1;', { secret: 'B' });
+assert.equal('A', first.o.s);
+var script = vm.createScript('f = Function("return secret")');
+first = { secret: 'A' };
+script.runInNewContext(first);
+vm.createScript('var x = 1;').runInNewContext({ secret: 'B' });
+assert.equal('A', first.f());
+
+common.debug('nothing is left behind for the next sandbox');
+sandbox = {};
+assert.equal('undefined undefined undefined',
+             vm.runInNewContext('[typeof a, typeof b, typeof bar].join(" ")',
+                                sandbox));
+assert.deepEqual([], Object.keys(sandbox));
+
+common.debug('this is the sandbox');
+sandbox = { x: 42 };
+assert.equal(42, vm.runInNewContext('this.x', sandbox));
+vm.runInNewContext('this.y = this', sandbox);
+assert.equal(sandbox, sandbox.y);
+
+common.debug('in, delete and enumeration see the sandbox');
+sandbox = { p: 1, q: 2 };
+assert.equal(true, vm.runInNewContext('"p" in this', sandbox));
+vm.runInNewContext('delete p', sandbox);
+assert.equal(undefined, sandbox.p);
+assert.equal('q', vm.runInNewContext('Object.keys(this).join()', sandbox));
+
+common.debug('a redeclared function replaces the one on the sandbox');
+sandbox = {};
+vm.runInNewContext('function d() { return 1; }', sandbox);
+assert.equal(2, vm.runInNewContext('function d() { return 2; }; d()',
+                                   sandbox));
+assert.equal(2, sandbox.d());
+
+common.debug('thrown errors');
+sandbox = {};
+assert.throws(function() {
+  vm.runInNewContext('function c() {}; throw new Error("test");', sandbox);
+});
+assert.equal('undefined', vm.runInNewContext('typeof c', {}));
+
+common.debug('cached code runs against each sandbox');
+var code = 'n * 2';
+for (var i = 0; i < 10; i++) {
+  assert.equal(i * 2, vm.runInNewContext(code, { n: i }));
+}
+
+common.debug('nested');
+assert.equal(3, vm.runInNewContext('run("m + 1", { m: 2 })', {
+  run: vm.runInNewContext
+}));
+
+vm.setContextPoolSize(0);
+
+common.debug('unpooled contexts see the same cached code');
+assert.equal(8, vm.runInNewContext(code, { n: 4 }));
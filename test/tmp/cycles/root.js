@@ -0,0 +1 @@
+console.error('roooot!');
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/test/fixtures/cycles/root.js
\ No newline at end of file
@@ -0,0 +1,19 @@
+# node cpu profile, pid 1316, 179 samples
+# depth self total function script:line
+0 0 179 (root) :0
+1 0 165 (anonymous function) /root/repo/test/simple/test-process-profiler.js:96
+2 2 165 cycle /root/repo/test/simple/test-process-profiler.js:91
+3 0 163 encode /root/repo/test/simple/test-process-profiler.js:55
+4 122 163 Buffer.toString buffer.js:397
+5 41 41 binarySlice :0
+1 14 14 (garbage collector) :0
+# native, 0 samples dropped
+# samples symbol
+31 v8::internal::Heap::AllocateStringFromTwoByte(v8::internal::Vector<unsigned short const>, v8::internal::PretenureFlag)
+9 node::Encode(void const*, unsigned long, node::encoding)
+3 (unresolved)
+1 v8::internal::MarkCompactCollector::EmptyMarkingStack()
+1 v8::internal::LargeObjectChunk::New(int, v8::internal::Executability)
+1 v8::internal::CPU::FlushICache(void*, unsigned long)
+1 v8::internal::RelocIterator::next()
+1 __munmap
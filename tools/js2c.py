@@ -236,6 +236,15 @@ static const struct _native natives[] = {
 """
 
 
+# Library modules are stored already wrapped in the function NativeModule
+# compiles them as, so that the embedded source can be handed to V8 as it is.
+# Has to match NativeModule.wrapper in src/node.js.
+NATIVE_WRAPPER = [
+  '(function (exports, require, module, __filename, __dirname) { ',
+  '\n});'
+]
+
+
 NATIVE_DECLARATION = """\
   { "%(id)s", %(id)s_native, sizeof(%(id)s_native)-1 },
 """
@@ -287,9 +296,11 @@ def JS2C(source, target):
     lines = ExpandConstants(lines, consts)
     lines = ExpandMacros(lines, macros)
     lines = CompressScript(lines, do_jsmin)
-    data = ToCArray(s, lines)
     id = (os.path.split(str(s))[1])[:-3]
     if delay: id = id[:-6]
+    if id != 'node':
+      lines = NATIVE_WRAPPER[0] + lines + NATIVE_WRAPPER[1]
+    data = ToCArray(s, lines)
     if delay:
       delay_ids.append((id, len(lines)))
     else: